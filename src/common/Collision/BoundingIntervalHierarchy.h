@@ -255,6 +255,268 @@ class TC_COMMON_API BIH
             }
         }
 
+        static constexpr uint32 PacketSize = 8;
+
+        /// Sign bits of the ray direction, rays with equal values can share a packet
+        static uint32 getDirectionSigns(G3D::Ray const& r)
+        {
+            G3D::Vector3 const& dir = r.direction();
+            return (floatToRawIntBits(dir.x) >> 31) | (floatToRawIntBits(dir.y) >> 31) << 1 | (floatToRawIntBits(dir.z) >> 31) << 2;
+        }
+
+        /// Traverses the tree once for up to PacketSize rays whose direction components have the same signs on every axis.
+        /// Each ray keeps its own interval, so every ray visits the nodes and calls the callback in the same order as
+        /// intersectRay would. The callback is called as callback(lane, ray, entry, maxDist[lane], stopAtFirst), a ray that
+        /// reports a hit with stopAtFirst set leaves the packet. Per-lane work runs over fixed size arrays so it vectorizes.
+        template<typename RayCallback>
+        void intersectRayPacket(G3D::Ray const* rays, uint32 count, RayCallback& intersectCallback, float* maxDist, bool stopAtFirst = false) const
+        {
+            // a lone ray gains nothing from the packet lanes
+            if (count == 1)
+            {
+                auto callback = [&](G3D::Ray const& ray, uint32 entry, float& distance, bool stop)
+                {
+                    return intersectCallback(0, ray, entry, distance, stop);
+                };
+                intersectRay(rays[0], callback, maxDist[0], stopAtFirst);
+                return;
+            }
+
+            float org[3][PacketSize];
+            float invDir[3][PacketSize];
+            float intervalMin[PacketSize];
+            float intervalMax[PacketSize];
+            uint32 live[PacketSize];
+            uint32 liveCount = 0;
+
+            for (uint32 lane = 0; lane < PacketSize; ++lane)
+            {
+                // unused lanes get an empty interval and never become active
+                intervalMin[lane] = std::numeric_limits<float>::infinity();
+                intervalMax[lane] = -std::numeric_limits<float>::infinity();
+                live[lane] = 0;
+                for (int i = 0; i < 3; ++i)
+                {
+                    org[i][lane] = 0.f;
+                    invDir[i][lane] = 0.f;
+                }
+
+                if (lane >= count)
+                    continue;
+
+                G3D::Vector3 const& rayOrg = rays[lane].origin();
+                G3D::Vector3 const& dir = rays[lane].direction();
+                float rayMin = -1.f;
+                float rayMax = -1.f;
+                for (int i = 0; i < 3; ++i)
+                {
+                    org[i][lane] = rayOrg[i];
+                    invDir[i][lane] = 1.f / dir[i];
+                }
+
+                bool missed = false;
+                for (int i = 0; i < 3 && !missed; ++i)
+                {
+                    if (G3D::fuzzyNe(dir[i], 0.0f))
+                    {
+                        float t1 = (bounds.low()[i] - rayOrg[i]) * invDir[i][lane];
+                        float t2 = (bounds.high()[i] - rayOrg[i]) * invDir[i][lane];
+                        if (t1 > t2)
+                            std::swap(t1, t2);
+                        if (t1 > rayMin)
+                            rayMin = t1;
+                        if (t2 < rayMax || rayMax < 0.f)
+                            rayMax = t2;
+                        if (rayMax <= 0 || rayMin >= maxDist[lane])
+                            missed = true;
+                    }
+                }
+
+                if (missed || rayMin > rayMax)
+                    continue;
+
+                intervalMin[lane] = std::max(rayMin, 0.f);
+                intervalMax[lane] = std::min(rayMax, maxDist[lane]);
+                live[lane] = 1;
+                ++liveCount;
+            }
+
+            if (!liveCount)
+                return;
+
+            // all rays share the direction signs, so near and far children are the same for the whole packet
+            uint32 offsetFront[3];
+            uint32 offsetBack[3];
+            uint32 offsetFront3[3];
+            uint32 offsetBack3[3];
+            for (int i = 0; i < 3; ++i)
+            {
+                offsetFront[i] = floatToRawIntBits(rays[0].direction()[i]) >> 31;
+                offsetBack[i] = offsetFront[i] ^ 1;
+                offsetFront3[i] = offsetFront[i] * 3;
+                offsetBack3[i] = offsetBack[i] * 3;
+
+                ++offsetFront[i];
+                ++offsetBack[i];
+            }
+
+            // rays that are not in the current node, or already left the packet, have an empty interval
+            auto isActive = [&](uint32 lane)
+            {
+                return intervalMin[lane] <= intervalMax[lane];
+            };
+
+            PacketStackNode stack[MAX_STACK_SIZE];
+            int stackPos = 0;
+            int node = 0;
+
+            while (true) {
+                while (true)
+                {
+                    uint32 tn = tree[node];
+                    uint32 axis = (tn & (3 << 30)) >> 30;
+                    bool BVH2 = (tn & (1 << 29)) != 0;
+                    int offset = tn & ~(7 << 29);
+                    if (!BVH2)
+                    {
+                        if (axis < 3)
+                        {
+                            // "normal" interior node
+                            float splitFront = intBitsToFloat(tree[node + offsetFront[axis]]);
+                            float splitBack = intBitsToFloat(tree[node + offsetBack[axis]]);
+                            float const* laneOrg = org[axis];
+                            float const* laneInvDir = invDir[axis];
+                            float frontMax[PacketSize];
+                            float backMin[PacketSize];
+                            uint32 needsFront[PacketSize];
+                            uint32 needsBack[PacketSize];
+                            for (uint32 lane = 0; lane < PacketSize; ++lane)
+                            {
+                                float tf = (splitFront - laneOrg[lane]) * laneInvDir[lane];
+                                float tb = (splitBack - laneOrg[lane]) * laneInvDir[lane];
+                                uint32 active = intervalMin[lane] <= intervalMax[lane];
+                                needsFront[lane] = active & !(tf < intervalMin[lane]);
+                                needsBack[lane] = active & !(tb > intervalMax[lane]);
+                                frontMax[lane] = std::min(intervalMax[lane], tf);
+                                backMin[lane] = std::max(intervalMin[lane], tb);
+                            }
+
+                            uint32 anyFront = 0;
+                            uint32 anyBack = 0;
+                            for (uint32 lane = 0; lane < PacketSize; ++lane)
+                            {
+                                anyFront |= needsFront[lane];
+                                anyBack |= needsBack[lane];
+                            }
+
+                            // all rays pass between clip zones
+                            if (!anyFront && !anyBack)
+                                break;
+
+                            int back = offset + offsetBack3[axis];
+                            if (anyFront && anyBack)
+                            {
+                                // push back node with the intervals of the rays that pass through it
+                                PacketStackNode& entry = stack[stackPos++];
+                                entry.node = back;
+                                for (uint32 lane = 0; lane < PacketSize; ++lane)
+                                {
+                                    entry.tnear[lane] = needsBack[lane] ? backMin[lane] : std::numeric_limits<float>::infinity();
+                                    entry.tfar[lane] = needsBack[lane] ? intervalMax[lane] : -std::numeric_limits<float>::infinity();
+                                }
+                            }
+
+                            if (anyFront)
+                            {
+                                node = offset + offsetFront3[axis];
+                                for (uint32 lane = 0; lane < PacketSize; ++lane)
+                                {
+                                    intervalMin[lane] = needsFront[lane] ? intervalMin[lane] : std::numeric_limits<float>::infinity();
+                                    intervalMax[lane] = needsFront[lane] ? frontMax[lane] : intervalMax[lane];
+                                }
+                            }
+                            else
+                            {
+                                node = back;
+                                for (uint32 lane = 0; lane < PacketSize; ++lane)
+                                    intervalMin[lane] = needsBack[lane] ? backMin[lane] : std::numeric_limits<float>::infinity();
+                            }
+                            continue;
+                        }
+                        else
+                        {
+                            // leaf - test some objects against every ray still in it
+                            int n = tree[node + 1];
+                            for (uint32 lane = 0; lane < PacketSize; ++lane)
+                            {
+                                if (!isActive(lane))
+                                    continue;
+
+                                for (int i = 0; i < n; ++i)
+                                {
+                                    bool hit = intersectCallback(lane, rays[lane], objects[offset + i], maxDist[lane], stopAtFirst);
+                                    if (stopAtFirst && hit)
+                                    {
+                                        live[lane] = 0;
+                                        --liveCount;
+                                        intervalMin[lane] = std::numeric_limits<float>::infinity();
+                                        break;
+                                    }
+                                }
+                            }
+
+                            if (!liveCount)
+                                return;
+                            break;
+                        }
+                    }
+                    else
+                    {
+                        if (axis > 2)
+                            return; // should not happen
+                        float splitFront = intBitsToFloat(tree[node + offsetFront[axis]]);
+                        float splitBack = intBitsToFloat(tree[node + offsetBack[axis]]);
+                        node = offset;
+                        float const* laneOrg = org[axis];
+                        float const* laneInvDir = invDir[axis];
+                        uint32 anyActive = 0;
+                        for (uint32 lane = 0; lane < PacketSize; ++lane)
+                        {
+                            float tf = (splitFront - laneOrg[lane]) * laneInvDir[lane];
+                            float tb = (splitBack - laneOrg[lane]) * laneInvDir[lane];
+                            intervalMin[lane] = std::max(intervalMin[lane], tf);
+                            intervalMax[lane] = std::min(intervalMax[lane], tb);
+                            anyActive |= isActive(lane);
+                        }
+                        if (!anyActive)
+                            break;
+                        continue;
+                    }
+                } // traversal loop
+                do
+                {
+                    // stack is empty?
+                    if (stackPos == 0)
+                        return;
+                    // move back up the stack
+                    stackPos--;
+                    PacketStackNode const& entry = stack[stackPos];
+                    uint32 anyActive = 0;
+                    for (uint32 lane = 0; lane < PacketSize; ++lane)
+                    {
+                        bool skip = !live[lane] || maxDist[lane] < entry.tnear[lane];
+                        intervalMin[lane] = skip ? std::numeric_limits<float>::infinity() : entry.tnear[lane];
+                        intervalMax[lane] = entry.tfar[lane];
+                        anyActive |= isActive(lane);
+                    }
+                    if (!anyActive)
+                        continue;
+                    node = entry.node;
+                    break;
+                } while (true);
+            }
+        }
+
         template<typename IsectCallback>
         void intersectPoint(const G3D::Vector3 &p, IsectCallback& intersectCallback) const
         {
@@ -354,6 +616,12 @@ class TC_COMMON_API BIH
             float tnear;
             float tfar;
         };
+        struct PacketStackNode
+        {
+            uint32 node;
+            float tnear[PacketSize];
+            float tfar[PacketSize];
+        };
 
         class BuildStats
         {
@@ -0,0 +1,140 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BoundingVolumeHierarchy4.h"
+#include <numeric>
+
+namespace
+{
+    // child boxes are grown a little so that rounding in the slab test never culls a triangle lying in a box face
+    float const BoxPadding = 1e-3f;
+}
+
+void BVH4::buildFromBounds(std::vector<G3D::AABox> const& primBounds, uint32 leafSize)
+{
+    nodes.clear();
+    order.resize(primBounds.size());
+    std::iota(order.begin(), order.end(), 0);
+    if (primBounds.empty())
+    {
+        bounds = G3D::AABox(G3D::Vector3::zero(), G3D::Vector3::zero());
+        return;
+    }
+
+    std::vector<G3D::Vector3> centers(primBounds.size());
+    bounds = primBounds[0];
+    for (std::size_t i = 0; i < primBounds.size(); ++i)
+    {
+        centers[i] = primBounds[i].center();
+        bounds.merge(primBounds[i]);
+    }
+
+    uint32 count = uint32(primBounds.size());
+    nodes.emplace_back();
+    if (count <= leafSize)
+    {
+        for (uint32 slot = 0; slot < Width; ++slot)
+            setChild(0, slot, 0, 0, primBounds);
+        setChild(0, 0, 0, count, primBounds);
+        return;
+    }
+
+    buildNode(0, 0, count, primBounds, centers, std::max(leafSize, 1u));
+}
+
+void BVH4::buildNode(uint32 nodeIndex, uint32 begin, uint32 end, std::vector<G3D::AABox> const& primBounds, std::vector<G3D::Vector3> const& centers, uint32 leafSize)
+{
+    // two levels of median splits give up to four children
+    uint32 ranges[Width + 1];
+    uint32 rangeCount = 0;
+    uint32 mid = split(begin, end, centers);
+    for (auto [first, last] : { std::make_pair(begin, mid), std::make_pair(mid, end) })
+    {
+        ranges[rangeCount++] = first;
+        if (last - first > leafSize)
+            ranges[rangeCount++] = split(first, last, centers);
+    }
+    ranges[rangeCount] = end;
+
+    for (uint32 slot = 0; slot < Width; ++slot)
+    {
+        if (slot >= rangeCount)
+        {
+            setChild(nodeIndex, slot, 0, 0, primBounds);
+            continue;
+        }
+
+        setChild(nodeIndex, slot, ranges[slot], ranges[slot + 1], primBounds);
+        if (ranges[slot + 1] - ranges[slot] <= leafSize)
+            continue;
+
+        // nodes can be reallocated by the recursion, so the child is linked before descending
+        uint32 child = uint32(nodes.size());
+        nodes.emplace_back();
+        nodes[nodeIndex].child[slot] = child;
+        nodes[nodeIndex].count[slot] = 0;
+        buildNode(child, ranges[slot], ranges[slot + 1], primBounds, centers, leafSize);
+    }
+}
+
+uint32 BVH4::split(uint32 begin, uint32 end, std::vector<G3D::Vector3> const& centers)
+{
+    G3D::Vector3 lo = centers[order[begin]];
+    G3D::Vector3 hi = lo;
+    for (uint32 i = begin + 1; i < end; ++i)
+    {
+        lo = lo.min(centers[order[i]]);
+        hi = hi.max(centers[order[i]]);
+    }
+
+    G3D::Vector3 extent = hi - lo;
+    int axis = extent.x >= extent.y ? (extent.x >= extent.z ? 0 : 2) : (extent.y >= extent.z ? 1 : 2);
+    uint32 mid = begin + (end - begin) / 2;
+    std::nth_element(order.begin() + begin, order.begin() + mid, order.begin() + end, [&](uint32 left, uint32 right)
+    {
+        return centers[left][axis] < centers[right][axis];
+    });
+    return mid;
+}
+
+void BVH4::setChild(uint32 nodeIndex, uint32 slot, uint32 begin, uint32 end, std::vector<G3D::AABox> const& primBounds)
+{
+    Node& node = nodes[nodeIndex];
+    if (begin == end)
+    {
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            node.lo[axis][slot] = 0.f;
+            node.hi[axis][slot] = 0.f;
+        }
+        node.child[slot] = EmptySlot;
+        node.count[slot] = 0;
+        return;
+    }
+
+    G3D::AABox box = primBounds[order[begin]];
+    for (uint32 i = begin + 1; i < end; ++i)
+        box.merge(primBounds[order[i]]);
+
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        node.lo[axis][slot] = box.low()[axis] - BoxPadding;
+        node.hi[axis][slot] = box.high()[axis] + BoxPadding;
+    }
+    node.child[slot] = begin;
+    node.count[slot] = end - begin;
+}
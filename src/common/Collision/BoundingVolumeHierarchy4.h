@@ -0,0 +1,170 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _BVH4_H
+#define _BVH4_H
+
+#include "G3D/Vector3.h"
+#include "G3D/Ray.h"
+#include "G3D/AABox.h"
+
+#include "Define.h"
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+/// Four-wide bounding volume hierarchy. Every node stores the boxes of its four children as separate
+/// coordinate arrays, so a node fills two cache lines and a ray is tested against all children at once.
+/// Primitives are addressed in leaf order, owners store them in primitiveOrder() to read them sequentially.
+class TC_COMMON_API BVH4
+{
+    public:
+        static constexpr uint32 Width = 4;
+
+        BVH4() : bounds(G3D::Vector3::zero(), G3D::Vector3::zero()) { }
+
+        template< class BoundsFunc, class PrimArray >
+        void build(const PrimArray &primitives, BoundsFunc &getBounds, uint32 leafSize = 2)
+        {
+            std::vector<G3D::AABox> primBounds(primitives.size());
+            for (std::size_t i = 0; i < primitives.size(); ++i)
+                getBounds(primitives[i], primBounds[i]);
+
+            buildFromBounds(primBounds, leafSize);
+        }
+
+        uint32 primCount() const { return uint32(order.size()); }
+        /// Index of the primitive passed to build for every leaf order position
+        std::vector<uint32> const& primitiveOrder() const { return order; }
+        G3D::AABox const& getBounds() const { return bounds; }
+
+        /// Same callback contract as BIH::intersectRay, entries are leaf order positions
+        template<typename RayCallback>
+        void intersectRay(const G3D::Ray &r, RayCallback& intersectCallback, float &maxDist, bool stopAtFirst = false) const
+        {
+            if (nodes.empty())
+                return;
+
+            float org[3];
+            float invDir[3];
+            for (int i = 0; i < 3; ++i)
+            {
+                org[i] = r.origin()[i];
+                // finite stand-in for 1/0 keeps the slab test free of NaNs for rays parallel to an axis
+                float dir = r.direction()[i];
+                invDir[i] = std::fabs(dir) > 1e-30f ? 1.f / dir : (std::signbit(dir) ? -1e30f : 1e30f);
+            }
+
+            StackNode stack[MaxStackSize];
+            int stackPos = 0;
+            stack[stackPos++] = { 0, 0.f };
+
+            while (stackPos > 0)
+            {
+                StackNode current = stack[--stackPos];
+                if (current.tnear > maxDist)
+                    continue;
+
+                Node const& node = nodes[current.node];
+                float tnear[Width];
+                float tfar[Width];
+                for (uint32 lane = 0; lane < Width; ++lane)
+                {
+                    tnear[lane] = 0.f;
+                    tfar[lane] = maxDist;
+                }
+
+                for (int axis = 0; axis < 3; ++axis)
+                {
+                    // the sign of the direction decides which plane is entered first, for every child
+                    float const* nearPlane = invDir[axis] >= 0.f ? node.lo[axis] : node.hi[axis];
+                    float const* farPlane = invDir[axis] >= 0.f ? node.hi[axis] : node.lo[axis];
+                    for (uint32 lane = 0; lane < Width; ++lane)
+                    {
+                        tnear[lane] = std::max(tnear[lane], (nearPlane[lane] - org[axis]) * invDir[axis]);
+                        tfar[lane] = std::min(tfar[lane], (farPlane[lane] - org[axis]) * invDir[axis]);
+                    }
+                }
+
+                // visit the children front to back, leaves right away and inner nodes through the stack
+                uint32 hitLanes[Width];
+                uint32 hitCount = 0;
+                for (uint32 lane = 0; lane < Width; ++lane)
+                {
+                    if (node.child[lane] == EmptySlot || tnear[lane] > tfar[lane])
+                        continue;
+
+                    uint32 pos = hitCount++;
+                    for (; pos > 0 && tnear[hitLanes[pos - 1]] > tnear[lane]; --pos)
+                        hitLanes[pos] = hitLanes[pos - 1];
+                    hitLanes[pos] = lane;
+                }
+
+                for (uint32 i = 0; i < hitCount; ++i)
+                {
+                    uint32 lane = hitLanes[i];
+                    if (!node.count[lane])
+                        continue;
+
+                    for (uint32 entry = node.child[lane]; entry < node.child[lane] + node.count[lane]; ++entry)
+                    {
+                        bool hit = intersectCallback(r, entry, maxDist, stopAtFirst);
+                        if (stopAtFirst && hit)
+                            return;
+                    }
+                }
+
+                for (uint32 i = hitCount; i > 0; --i)
+                {
+                    uint32 lane = hitLanes[i - 1];
+                    if (!node.count[lane])
+                        stack[stackPos++] = { node.child[lane], tnear[lane] };
+                }
+            }
+        }
+
+    private:
+        static constexpr uint32 EmptySlot = 0xFFFFFFFF;
+        // median splits halve the primitive count per level, so even 2^32 primitives stay below 17 levels of 3 pushes
+        static constexpr int MaxStackSize = 64;
+
+        struct alignas(64) Node
+        {
+            float lo[3][Width];
+            float hi[3][Width];
+            uint32 child[Width];    // node index, or first leaf order position of a leaf
+            uint32 count[Width];    // primitives of a leaf, 0 for inner nodes
+        };
+
+        struct StackNode
+        {
+            uint32 node;
+            float tnear;
+        };
+
+        void buildFromBounds(std::vector<G3D::AABox> const& primBounds, uint32 leafSize);
+        void buildNode(uint32 nodeIndex, uint32 begin, uint32 end, std::vector<G3D::AABox> const& primBounds, std::vector<G3D::Vector3> const& centers, uint32 leafSize);
+        uint32 split(uint32 begin, uint32 end, std::vector<G3D::Vector3> const& centers);
+        void setChild(uint32 nodeIndex, uint32 slot, uint32 begin, uint32 end, std::vector<G3D::AABox> const& primBounds);
+
+        std::vector<Node> nodes;
+        std::vector<uint32> order;
+        G3D::AABox bounds;
+};
+
+#endif // _BVH4_H
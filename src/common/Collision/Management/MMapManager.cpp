@@ -20,12 +20,15 @@
 #include "Log.h"
 #include "MMapFactory.h"
 #include "MMapDefines.h"
+#include <atomic>
 
 namespace MMAP
 {
     static char const* const MAP_FILE_NAME_FORMAT = "%smmaps/%03i.mmap";
     static char const* const TILE_FILE_NAME_FORMAT = "%smmaps/%03i%02i%02i.mmtile";
 
+    static std::atomic<uint64> NextMMapDataId{ 0 };
+
     // ######################## MMapManager ########################
     MMapManager::~MMapManager()
     {
@@ -106,7 +109,7 @@ namespace MMAP
         TC_LOG_DEBUG("maps", "MMAP:loadMapData: Loaded %03i.mmap", mapId);
 
         // store inside our map list
-        MMapData* mmap_data = new MMapData(mesh);
+        MMapData* mmap_data = new MMapData(mesh, ++NextMMapDataId);
 
         itr->second = mmap_data;
         return true;
@@ -196,6 +199,7 @@ namespace MMAP
         dtTileRef tileRef = 0;
 
         // memory allocated for data is now managed by detour, and will be deallocated when the tile is removed
+        std::unique_lock<std::shared_mutex> lock(mmap->navMeshLock);
         if (dtStatusSucceed(mmap->navMesh->addTile(data, fileHeader.size, DT_TILE_FREE_DATA, 0, &tileRef)))
         {
             mmap->loadedTileRefs.insert(std::pair<uint32, dtTileRef>(packedGridPos, tileRef));
@@ -217,23 +221,10 @@ namespace MMAP
             return false;
 
         MMapData* mmap = loadedMMaps[meshMapId];
-        auto [queryItr, inserted] = mmap->navMeshQueries.try_emplace({ instanceMapId, instanceId }, nullptr);
-        if (!inserted)
-            return true;
-
-        // allocate mesh query
-        dtNavMeshQuery* query = dtAllocNavMeshQuery();
-        ASSERT(query);
-        if (dtStatusFailed(query->init(mmap->navMesh, 1024)))
-        {
-            dtFreeNavMeshQuery(query);
-            mmap->navMeshQueries.erase(queryItr);
-            TC_LOG_ERROR("maps", "MMAP:GetNavMeshQuery: Failed to initialize dtNavMeshQuery for mapId %03u instanceId %u", instanceMapId, instanceId);
-            return false;
-        }
+        std::unique_lock<std::shared_mutex> lock(mmap->navMeshLock);
+        if (mmap->loadedInstances.emplace(instanceMapId, instanceId).second)
+            TC_LOG_DEBUG("maps", "MMAP:loadMapInstance: Loaded mapId %03u instanceId %u", instanceMapId, instanceId);
 
-        TC_LOG_DEBUG("maps", "MMAP:GetNavMeshQuery: created dtNavMeshQuery for mapId %03u instanceId %u", instanceMapId, instanceId);
-        queryItr->second = query;
         return true;
     }
 
@@ -261,6 +252,7 @@ namespace MMAP
         }
 
         // unload, and mark as non loaded
+        std::unique_lock<std::shared_mutex> lock(mmap->navMeshLock);
         if (dtStatusFailed(mmap->navMesh->removeTile(tileRefItr->second, nullptr, nullptr)))
         {
             // this is technically a memory leak
@@ -324,15 +316,13 @@ namespace MMAP
         }
 
         MMapData* mmap = itr->second;
-        auto queryItr = mmap->navMeshQueries.find({ instanceMapId, instanceId });
-        if (queryItr == mmap->navMeshQueries.end())
+        std::unique_lock<std::shared_mutex> lock(mmap->navMeshLock);
+        if (!mmap->loadedInstances.erase({ instanceMapId, instanceId }))
         {
-            TC_LOG_DEBUG("maps", "MMAP:unloadMapInstance: Asked to unload not loaded dtNavMeshQuery mapId %03u instanceId %u", instanceMapId, instanceId);
+            TC_LOG_DEBUG("maps", "MMAP:unloadMapInstance: Asked to unload not loaded instance mapId %03u instanceId %u", instanceMapId, instanceId);
             return false;
         }
 
-        dtFreeNavMeshQuery(queryItr->second);
-        mmap->navMeshQueries.erase(queryItr);
         TC_LOG_DEBUG("maps", "MMAP:unloadMapInstance: Unloaded mapId %03u instanceId %u", instanceMapId, instanceId);
 
         return true;
@@ -347,16 +337,52 @@ namespace MMAP
         return itr->second->navMesh;
     }
 
+    std::shared_lock<std::shared_mutex> MMapManager::LockNavMesh(uint32 mapId)
+    {
+        MMapDataSet::const_iterator itr = GetMMapData(mapId);
+        if (itr == loadedMMaps.end())
+            return {};
+
+        return std::shared_lock<std::shared_mutex>(itr->second->navMeshLock);
+    }
+
     dtNavMeshQuery const* MMapManager::GetNavMeshQuery(uint32 meshMapId, uint32 instanceMapId, uint32 instanceId)
     {
         auto itr = GetMMapData(meshMapId);
         if (itr == loadedMMaps.end())
             return nullptr;
 
-        auto queryItr = itr->second->navMeshQueries.find({ instanceMapId, instanceId });
-        if (queryItr == itr->second->navMeshQueries.end())
+        MMapData* mmap = itr->second;
+        if (mmap->loadedInstances.find({ instanceMapId, instanceId }) == mmap->loadedInstances.end())
             return nullptr;
 
-        return queryItr->second;
+        // queries this thread already got, looked up without taking queryLock
+        thread_local std::unordered_map<uint32, std::pair<uint64, dtNavMeshQuery*>> threadQueries;
+        auto& [meshId, threadQuery] = threadQueries[meshMapId];
+        if (meshId == mmap->id)
+            return threadQuery;
+
+        std::lock_guard<std::mutex> lock(mmap->queryLock);
+        auto [queryItr, inserted] = mmap->navMeshQueries.try_emplace(std::this_thread::get_id(), nullptr);
+        if (inserted)
+        {
+            // allocate mesh query for this thread
+            dtNavMeshQuery* query = dtAllocNavMeshQuery();
+            ASSERT(query);
+            if (dtStatusFailed(query->init(mmap->navMesh, 1024)))
+            {
+                dtFreeNavMeshQuery(query);
+                mmap->navMeshQueries.erase(queryItr);
+                TC_LOG_ERROR("maps", "MMAP:GetNavMeshQuery: Failed to initialize dtNavMeshQuery for mmap %03u", meshMapId);
+                return nullptr;
+            }
+
+            TC_LOG_DEBUG("maps", "MMAP:GetNavMeshQuery: created dtNavMeshQuery for mmap %03u, %u threads use this navmesh", meshMapId, uint32(mmap->navMeshQueries.size()));
+            queryItr->second = query;
+        }
+
+        meshId = mmap->id;
+        threadQuery = queryItr->second;
+        return threadQuery;
     }
 }
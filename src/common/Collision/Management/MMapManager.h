@@ -22,20 +22,25 @@
 #include "DetourNavMesh.h"
 #include "DetourNavMeshQuery.h"
 #include "Hash.h"
+#include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 //  move map related classes
 namespace MMAP
 {
     typedef std::unordered_map<uint32, dtTileRef> MMapTileSet;
-    typedef std::unordered_map<std::pair<uint32, uint32>, dtNavMeshQuery*> NavMeshQuerySet;
+    typedef std::unordered_map<std::thread::id, dtNavMeshQuery*> NavMeshQuerySet;
+    typedef std::unordered_set<std::pair<uint32, uint32>> NavMeshInstanceSet;
 
     // dummy struct to hold map's mmap data
     struct TC_COMMON_API MMapData
     {
-        MMapData(dtNavMesh* mesh) : navMesh(mesh) { }
+        MMapData(dtNavMesh* mesh, uint64 meshId) : id(meshId), navMesh(mesh) { }
         ~MMapData()
         {
             for (NavMeshQuerySet::iterator i = navMeshQueries.begin(); i != navMeshQueries.end(); ++i)
@@ -45,9 +50,16 @@ namespace MMAP
                 dtFreeNavMesh(navMesh);
         }
 
-        // we have to use single dtNavMeshQuery for every instance, since those are not thread safe
-        NavMeshQuerySet navMeshQueries;     // instanceId to query
+        // dtNavMeshQuery is not thread safe, every thread using this navmesh gets its own query
+        // the queries are shared by all instances and only freed together with the navmesh
+        std::mutex queryLock;
+        NavMeshQuerySet navMeshQueries;     // thread id to query
 
+        // held shared by path queries, adding or removing tiles and instances takes it exclusively
+        std::shared_mutex navMeshLock;
+        NavMeshInstanceSet loadedInstances; // [instanceMapId, instanceId] using this navmesh
+
+        uint64 const id;                    // unique for every load, tells apart a navmesh loaded again after being unloaded
         dtNavMesh* navMesh;
 
         MMapTileSet loadedTileRefs;        // maps [map grid coords] to [dtTile]
@@ -71,7 +83,9 @@ namespace MMAP
             bool unloadMap(uint32 mapId);
             bool unloadMapInstance(uint32 meshMapId, uint32 instanceMapId, uint32 instanceId);
 
-            // the returned [dtNavMeshQuery const*] is NOT threadsafe
+            // tiles are neither loaded nor unloaded while the returned lock is held, it has to be kept while the navmesh or its queries are used
+            std::shared_lock<std::shared_mutex> LockNavMesh(uint32 mapId);
+            // the returned [dtNavMeshQuery const*] belongs to the calling thread and must not be passed to other threads
             dtNavMeshQuery const* GetNavMeshQuery(uint32 meshMapId, uint32 instanceMapId, uint32 instanceId);
             dtNavMesh const* GetNavMesh(uint32 mapId);
 
@@ -50,6 +50,7 @@ namespace VMAP
         GetLiquidFlagsPtr = &GetLiquidFlagsDummy;
         IsVMAPDisabledForPtr = &IsVMAPDisabledForDummy;
         thread_safe_environment = true;
+        iEnableCompactModelLayout = false;
     }
 
     VMapManager2::~VMapManager2()
@@ -315,30 +316,57 @@ namespace VMAP
 
     WorldModel* VMapManager2::acquireModelInstance(const std::string& basepath, const std::string& filename, uint32 flags/* Only used when creating the model */)
     {
-        //! Critical section, thread safe access to iLoadedModelFiles
-        std::lock_guard<std::mutex> lock(LoadedModelFilesLock);
-
-        auto model = iLoadedModelFiles.find(filename);
-        if (model == iLoadedModelFiles.end())
         {
-            ManagedModel* worldmodel = new ManagedModel();
-            if (!worldmodel->getModel()->readFile(basepath + filename + ".vmo"))
+            //! Critical section, thread safe access to iLoadedModelFiles
+            std::lock_guard<std::mutex> lock(LoadedModelFilesLock);
+
+            auto model = iLoadedModelFiles.find(filename);
+            if (model != iLoadedModelFiles.end())
             {
-                VMAP_ERROR_LOG("misc", "VMapManager2: could not load '%s%s.vmo'", basepath.c_str(), filename.c_str());
-                delete worldmodel;
-                return nullptr;
+                model->second->incRefCount();
+                return model->second->getModel();
             }
-            VMAP_DEBUG_LOG("maps", "VMapManager2: loading file '%s%s'", basepath.c_str(), filename.c_str());
-
-            worldmodel->getModel()->SetName(filename);
-            worldmodel->getModel()->Flags = flags;
+        }
 
-            model = iLoadedModelFiles.insert(std::pair<std::string, ManagedModel*>(filename, worldmodel)).first;
+        // reading the file and building the compact meshes happens outside the lock, other maps keep acquiring their models meanwhile
+        ManagedModel* worldmodel = new ManagedModel();
+        if (!worldmodel->getModel()->readFile(basepath + filename + ".vmo"))
+        {
+            VMAP_ERROR_LOG("misc", "VMapManager2: could not load '%s%s.vmo'", basepath.c_str(), filename.c_str());
+            delete worldmodel;
+            return nullptr;
         }
+        VMAP_DEBUG_LOG("maps", "VMapManager2: loading file '%s%s'", basepath.c_str(), filename.c_str());
+
+        worldmodel->getModel()->SetName(filename);
+        worldmodel->getModel()->Flags = flags;
+        if (iEnableCompactModelLayout)
+            worldmodel->getModel()->buildCompactMeshes();
+
+        //! Critical section, thread safe access to iLoadedModelFiles
+        std::lock_guard<std::mutex> lock(LoadedModelFilesLock);
+
+        // another thread may have loaded the same model in the meantime
+        auto [model, inserted] = iLoadedModelFiles.try_emplace(filename, worldmodel);
+        if (!inserted)
+            delete worldmodel;
+
         model->second->incRefCount();
         return model->second->getModel();
     }
 
+    std::vector<std::string> VMapManager2::acquireMapTileModels(char const* basePath, unsigned int mapId, int x, int y)
+    {
+        if (!isMapLoadingEnabled())
+            return {};
+
+        std::string path = basePath;
+        if (!path.empty() && path.back() != '/' && path.back() != '\\')
+            path.push_back('/');
+
+        return StaticMapTree::AcquireMapTileModels(path, mapId, x, y, this);
+    }
+
     void VMapManager2::releaseModelInstance(const std::string &filename)
     {
         //! Critical section, thread safe access to iLoadedModelFiles
@@ -70,6 +70,7 @@ namespace VMAP
             InstanceTreeMap iInstanceMapTrees;
             std::unordered_map<uint32, uint32> iParentMapData;
             bool thread_safe_environment;
+            bool iEnableCompactModelLayout;
             // Mutex for iLoadedModelFiles
             std::mutex LoadedModelFilesLock;
 
@@ -107,8 +108,14 @@ namespace VMAP
             bool GetLiquidLevel(uint32 mapId, float x, float y, float z, uint8 reqLiquidType, float& level, float& floor, uint32& type, uint32& mogpFlags) const override;
             void getAreaAndLiquidData(uint32 mapId, float x, float y, float z, uint8 reqLiquidType, AreaAndLiquidData& data) const override;
 
+            //! Models loaded from now on also get the 4-wide tree layout, costs memory but speeds up ray casts
+            void setEnableCompactModelLayout(bool enable) { iEnableCompactModelLayout = enable; }
+            bool isCompactModelLayoutEnabled() const { return iEnableCompactModelLayout; }
+
             WorldModel* acquireModelInstance(const std::string& basepath, const std::string& filename, uint32 flags = 0);
             void releaseModelInstance(const std::string& filename);
+            //! Loads the models of a tile ahead of loadMap, safe to call from any thread
+            std::vector<std::string> acquireMapTileModels(char const* basePath, unsigned int mapId, int x, int y);
 
             // what's the use of this? o.O
             virtual std::string getDirFileName(unsigned int mapId, int /*x*/, int /*y*/) const override
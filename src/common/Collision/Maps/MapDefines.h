@@ -35,6 +35,15 @@ TC_COMMON_API extern u_map_magic const MapLiquidMagic;
 // ******************************************
 // Map file format defines
 // ******************************************
+
+// the extractor starts every section at a multiple of this so the server can use the data in place from a memory mapping
+constexpr uint32 MapSectionAlignment = 16;
+
+constexpr uint32 AlignMapSection(uint32 offset)
+{
+    return (offset + MapSectionAlignment - 1) & ~(MapSectionAlignment - 1);
+}
+
 struct map_fileheader
 {
     u_map_magic mapMagic;
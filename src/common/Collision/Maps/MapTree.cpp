@@ -259,6 +259,34 @@ namespace VMAP
         return result;
     }
 
+    //=========================================================
+    std::vector<std::string> StaticMapTree::AcquireMapTileModels(std::string const& basePath, uint32 mapID, uint32 tileX, uint32 tileY, VMapManager2* vm)
+    {
+        std::vector<std::string> models;
+        TileFileOpenResult fileResult = OpenMapTileFile(basePath, mapID, tileX, tileY, vm);
+        if (!fileResult.File)
+            return models;
+
+        char chunk[8];
+        uint32 numSpawns = 0;
+        if (readChunk(fileResult.File, chunk, VMAP_MAGIC, 8) && fread(&numSpawns, sizeof(uint32), 1, fileResult.File) == 1)
+        {
+            models.reserve(numSpawns);
+            for (uint32 i = 0; i < numSpawns; ++i)
+            {
+                ModelSpawn spawn;
+                if (!ModelSpawn::readFromFile(fileResult.File, spawn))
+                    break;
+
+                if (vm->acquireModelInstance(basePath, spawn.name, spawn.flags))
+                    models.push_back(std::move(spawn.name));
+            }
+        }
+
+        fclose(fileResult.File);
+        return models;
+    }
+
     //=========================================================
     LoadResult StaticMapTree::CanLoadMap(const std::string &vmapPath, uint32 mapID, uint32 tileX, uint32 tileY, VMapManager2* vm)
     {
@@ -20,7 +20,9 @@
 
 #include "Define.h"
 #include "BoundingIntervalHierarchy.h"
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 
 namespace VMAP
@@ -82,6 +84,8 @@ namespace VMAP
             static uint32 packTileID(uint32 tileX, uint32 tileY) { return tileX<<16 | tileY; }
             static void unpackTileID(uint32 ID, uint32 &tileX, uint32 &tileY) { tileX = ID >> 16; tileY = ID & 0xFF; }
             static LoadResult CanLoadMap(const std::string &basePath, uint32 mapID, uint32 tileX, uint32 tileY, VMapManager2* vm);
+            //! Acquires every model referenced by the tile without touching any tree, returns the names to release later
+            static std::vector<std::string> AcquireMapTileModels(std::string const& basePath, uint32 mapID, uint32 tileX, uint32 tileY, VMapManager2* vm);
 
             StaticMapTree(uint32 mapID, const std::string &basePath);
             ~StaticMapTree();
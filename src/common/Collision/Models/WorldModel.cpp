@@ -31,14 +31,14 @@ template<> struct BoundsTrait<VMAP::GroupModel>
 
 namespace VMAP
 {
-    bool IntersectTriangle(const MeshTriangle &tri, std::vector<Vector3>::const_iterator points, const G3D::Ray &ray, float &distance)
+    bool IntersectTriangle(const Vector3 &p0, const Vector3 &p1, const Vector3 &p2, const G3D::Ray &ray, float &distance)
     {
         static const float EPS = 1e-5f;
 
         // See RTR2 ch. 13.7 for the algorithm.
 
-        const Vector3 e1 = points[tri.idx1] - points[tri.idx0];
-        const Vector3 e2 = points[tri.idx2] - points[tri.idx0];
+        const Vector3 e1 = p1 - p0;
+        const Vector3 e2 = p2 - p0;
         const Vector3 p(ray.direction().cross(e2));
         const float a = e1.dot(p);
 
@@ -48,7 +48,7 @@ namespace VMAP
         }
 
         const float f = 1.0f / a;
-        const Vector3 s(ray.origin() - points[tri.idx0]);
+        const Vector3 s(ray.origin() - p0);
         const float u = f * s.dot(p);
 
         if ((u < 0.0f) || (u > 1.0f)) {
@@ -81,6 +81,11 @@ namespace VMAP
         return false;
     }
 
+    bool IntersectTriangle(const MeshTriangle &tri, std::vector<Vector3>::const_iterator points, const G3D::Ray &ray, float &distance)
+    {
+        return IntersectTriangle(points[tri.idx0], points[tri.idx1], points[tri.idx2], ray, distance);
+    }
+
     class TriBoundFunc
     {
         public:
@@ -289,7 +294,8 @@ namespace VMAP
 
     GroupModel::GroupModel(const GroupModel &other):
         iBound(other.iBound), iMogpFlags(other.iMogpFlags), iGroupWMOID(other.iGroupWMOID),
-        vertices(other.vertices), triangles(other.triangles), meshTree(other.meshTree), iLiquid(nullptr)
+        vertices(other.vertices), triangles(other.triangles), meshTree(other.meshTree), compactTree(other.compactTree),
+        compactTriangles(other.compactTriangles), iLiquid(nullptr)
     {
         if (other.iLiquid)
             iLiquid = new WmoLiquid(*other.iLiquid);
@@ -301,6 +307,28 @@ namespace VMAP
         triangles.swap(tri);
         TriBoundFunc bFunc(vertices);
         meshTree.build(triangles, bFunc);
+        compactTree = BVH4();
+        compactTriangles.clear();
+    }
+
+    void GroupModel::buildCompactMesh()
+    {
+        if (triangles.empty())
+            return;
+
+        TriBoundFunc bFunc(vertices);
+        compactTree.build(triangles, bFunc);
+
+        // gather the vertices so a leaf reads its triangles from consecutive memory
+        compactTriangles.clear();
+        compactTriangles.reserve(triangles.size() * 3);
+        for (uint32 index : compactTree.primitiveOrder())
+        {
+            MeshTriangle const& tri = triangles[index];
+            compactTriangles.push_back(vertices[tri.idx0]);
+            compactTriangles.push_back(vertices[tri.idx1]);
+            compactTriangles.push_back(vertices[tri.idx2]);
+        }
     }
 
     bool GroupModel::writeToFile(FILE* wf)
@@ -357,6 +385,8 @@ namespace VMAP
         uint32 count = 0;
         triangles.clear();
         vertices.clear();
+        compactTree = BVH4();
+        compactTriangles.clear();
         delete iLiquid;
         iLiquid = nullptr;
 
@@ -406,11 +436,31 @@ namespace VMAP
         bool hit;
     };
 
+    struct GModelCompactRayCallback
+    {
+        GModelCompactRayCallback(const std::vector<Vector3> &tris): triangles(tris.data()), hit(false) { }
+        bool operator()(const G3D::Ray& ray, uint32 entry, float& distance, bool /*pStopAtFirstHit*/)
+        {
+            Vector3 const* tri = triangles + entry * 3;
+            hit = IntersectTriangle(tri[0], tri[1], tri[2], ray, distance) || hit;
+            return hit;
+        }
+        Vector3 const* triangles;
+        bool hit;
+    };
+
     bool GroupModel::IntersectRay(const G3D::Ray &ray, float &distance, bool stopAtFirstHit) const
     {
         if (triangles.empty())
             return false;
 
+        if (!compactTriangles.empty())
+        {
+            GModelCompactRayCallback callback(compactTriangles);
+            compactTree.intersectRay(ray, callback, distance, stopAtFirstHit);
+            return callback.hit;
+        }
+
         GModelRayCallback callback(triangles, vertices);
         meshTree.intersectRay(ray, callback, distance, stopAtFirstHit);
         return callback.hit;
@@ -633,6 +683,12 @@ namespace VMAP
         return result;
     }
 
+    void WorldModel::buildCompactMeshes()
+    {
+        for (GroupModel& groupModel : groupModels)
+            groupModel.buildCompactMesh();
+    }
+
     void WorldModel::getGroupModels(std::vector<GroupModel>& outGroupModels)
     {
         outGroupModels = groupModels;
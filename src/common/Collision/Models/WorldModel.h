@@ -23,6 +23,7 @@
 #include <G3D/AABox.h>
 #include <G3D/Ray.h>
 #include "BoundingIntervalHierarchy.h"
+#include "BoundingVolumeHierarchy4.h"
 
 #include "Define.h"
 
@@ -93,6 +94,8 @@ namespace VMAP
             uint32 GetMogpFlags() const { return iMogpFlags; }
             uint32 GetWmoID() const { return iGroupWMOID; }
             void getMeshData(std::vector<G3D::Vector3>& outVertices, std::vector<MeshTriangle>& outTriangles, WmoLiquid*& liquid);
+            //! builds a 4-wide tree over a copy of the triangles in leaf order, ray casts use it from then on
+            void buildCompactMesh();
         protected:
             G3D::AABox iBound;
             uint32 iMogpFlags;// 0x8 outdor; 0x2000 indoor
@@ -100,6 +103,8 @@ namespace VMAP
             std::vector<G3D::Vector3> vertices;
             std::vector<MeshTriangle> triangles;
             BIH meshTree;
+            BVH4 compactTree;
+            std::vector<G3D::Vector3> compactTriangles; //!< three vertices per triangle in leaf order of compactTree
             WmoLiquid* iLiquid;
     };
 
@@ -118,6 +123,7 @@ namespace VMAP
             bool writeFile(const std::string &filename);
             bool readFile(const std::string &filename);
             void getGroupModels(std::vector<GroupModel>& outGroupModels);
+            void buildCompactMeshes();
             std::string const& GetName() const { return name; }
             void SetName(std::string newName) { name = std::move(newName); }
             uint32 Flags;
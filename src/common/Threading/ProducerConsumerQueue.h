@@ -18,6 +18,7 @@
 #ifndef TRINITY_PRODUCER_CONSUMER_QUEUE_H
 #define TRINITY_PRODUCER_CONSUMER_QUEUE_H
 
+#include <chrono>
 #include <condition_variable>
 #include <mutex>
 #include <queue>
@@ -98,6 +99,24 @@ public:
         _queue.pop();
     }
 
+    bool WaitUntilAndPop(T& value, std::chrono::steady_clock::time_point until)
+    {
+        std::unique_lock<std::mutex> lock(_queueLock);
+
+        while (_queue.empty() && !_shutdown)
+            if (_condition.wait_until(lock, until) == std::cv_status::timeout)
+                break;
+
+        if (_queue.empty() || _shutdown)
+            return false;
+
+        value = _queue.front();
+
+        _queue.pop();
+
+        return true;
+    }
+
     void Cancel()
     {
         std::unique_lock<std::mutex> lock(_queueLock);
@@ -43,14 +43,20 @@ public:
         if (_callbacks.empty())
             return;
 
-        std::vector<T> updateCallbacks{ std::move(_callbacks) };
+        // both buffers keep their capacity between ticks, callbacks added while invoking land in the (now empty) _callbacks
+        _processing.swap(_callbacks);
 
-        updateCallbacks.erase(std::remove_if(updateCallbacks.begin(), updateCallbacks.end(), [](T& callback)
+        _processing.erase(std::remove_if(_processing.begin(), _processing.end(), [](T& callback)
         {
             return callback.InvokeIfReady();
-        }), updateCallbacks.end());
+        }), _processing.end());
 
-        _callbacks.insert(_callbacks.end(), std::make_move_iterator(updateCallbacks.begin()), std::make_move_iterator(updateCallbacks.end()));
+        if (_callbacks.empty())
+            _callbacks.swap(_processing);
+        else
+            _callbacks.insert(_callbacks.end(), std::make_move_iterator(_processing.begin()), std::make_move_iterator(_processing.end()));
+
+        _processing.clear();
     }
 
     bool Empty() const
@@ -68,6 +74,7 @@ private:
     AsyncCallbackProcessor& operator=(AsyncCallbackProcessor const&) = delete;
 
     std::vector<T> _callbacks;
+    std::vector<T> _processing;
 };
 
 #endif // AsyncCallbackProcessor_h__
@@ -29,6 +29,13 @@
 #include <cstdarg>
 #include <ctime>
 
+#if TRINITY_PLATFORM == TRINITY_PLATFORM_WINDOWS
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
 void Trinity::VerifyOsVersion()
 {
 #if TRINITY_PLATFORM == TRINITY_PLATFORM_WINDOWS
@@ -491,6 +498,39 @@ std::wstring GetMainPartOfName(std::wstring const& wname, uint32 declension)
     return wname;
 }
 
+Trinity::ProcessMemoryUsage Trinity::GetProcessMemoryUsage()
+{
+    ProcessMemoryUsage usage;
+#if TRINITY_PLATFORM == TRINITY_PLATFORM_WINDOWS
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        usage.Current = counters.WorkingSetSize;
+        usage.Peak = counters.PeakWorkingSetSize;
+    }
+#else
+    rusage resourceUsage;
+    if (!getrusage(RUSAGE_SELF, &resourceUsage))
+    {
+#if TRINITY_PLATFORM == TRINITY_PLATFORM_APPLE
+        usage.Peak = uint64(resourceUsage.ru_maxrss);
+#else
+        usage.Peak = uint64(resourceUsage.ru_maxrss) * 1024;
+#endif
+    }
+
+    if (FILE* statm = fopen("/proc/self/statm", "r"))
+    {
+        unsigned long long size = 0, resident = 0;
+        if (fscanf(statm, "%llu %llu", &size, &resident) == 2)
+            usage.Current = uint64(resident) * uint64(sysconf(_SC_PAGESIZE));
+
+        fclose(statm);
+    }
+#endif
+    return usage;
+}
+
 bool utf8ToConsole(const std::string& utf8str, std::string& conStr)
 {
 #if TRINITY_PLATFORM == TRINITY_PLATFORM_WINDOWS
@@ -28,6 +28,15 @@
 namespace Trinity
 {
     TC_COMMON_API void VerifyOsVersion();
+
+    /// Resident memory of this process in bytes, 0 where not available on the platform
+    struct ProcessMemoryUsage
+    {
+        uint64 Current = 0;
+        uint64 Peak = 0;
+    };
+
+    TC_COMMON_API ProcessMemoryUsage GetProcessMemoryUsage();
 }
 
 namespace Trinity
@@ -57,3 +57,8 @@ bool BasicStatementTask::Execute()
 
     return m_conn->Execute(m_sql);
 }
+
+bool BasicStatementTask::ExecuteInGroupCommit()
+{
+    return m_conn->Execute(m_sql);
+}
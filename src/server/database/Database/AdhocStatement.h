@@ -30,6 +30,8 @@ class TC_DATABASE_API BasicStatementTask : public SQLOperation
         ~BasicStatementTask();
 
         bool Execute() override;
+        bool CanGroupCommit() const override { return !m_has_result; }
+        bool ExecuteInGroupCommit() override;
         QueryResultFuture GetFuture() const { return m_result->get_future(); }
 
     private:
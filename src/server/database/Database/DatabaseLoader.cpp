@@ -53,6 +53,11 @@ DatabaseLoader& DatabaseLoader::AddDatabase(DatabaseWorkerPool<T>& pool, std::st
         uint8 const synchThreads = uint8(sConfigMgr->GetIntDefault(name + "Database.SynchThreads", 1));
 
         pool.SetConnectionInfo(dbString, asyncThreads, synchThreads);
+        pool.SetStreamQueries(sConfigMgr->GetBoolDefault(name + "Database.StreamQueries", true));
+        pool.SetGroupCommit(uint32(sConfigMgr->GetIntDefault(name + "Database.GroupCommitSize", 0)),
+            uint32(sConfigMgr->GetIntDefault(name + "Database.GroupCommitDelay", 0)));
+        pool.SetPriorityLanes(sConfigMgr->GetBoolDefault(name + "Database.PriorityLanes", false));
+        pool.SetKeyRouting(sConfigMgr->GetBoolDefault(name + "Database.KeyRouting", false));
         if (uint32 error = pool.Open())
         {
             // Database does not exist
@@ -111,6 +116,16 @@ DatabaseLoader& DatabaseLoader::AddDatabase(DatabaseWorkerPool<T>& pool, std::st
             TC_LOG_ERROR(_logger, "Could not prepare statements of the %s database, see log for details.", name.c_str());
             return false;
         }
+
+        std::string const snapshotFile = sConfigMgr->GetStringDefault(name + "Database.SnapshotFile", "");
+        if (!snapshotFile.empty())
+        {
+            std::string const stateHash = DBUpdater<T>::GetStateHash(pool);
+            if (!stateHash.empty())
+                pool.OpenSnapshot(snapshotFile, stateHash);
+            else
+                TC_LOG_ERROR(_logger, "%s database: the updates table could not be read, %sDatabase.SnapshotFile is ignored.", name.c_str(), name.c_str());
+        }
         return true;
     });
 
@@ -0,0 +1,227 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "DatabaseWorkQueue.h"
+#include "Metric.h"
+#include "SQLOperation.h"
+#include <algorithm>
+
+namespace
+{
+    char const* const LaneNames[MAX_DATABASE_LANES] = { "interactive", "bulk", "keyed" };
+}
+
+DatabaseWorkQueue::DatabaseWorkQueue() : _priorityLanes(false), _shutdown(false), _workers(0)
+{
+}
+
+DatabaseWorkQueue::~DatabaseWorkQueue()
+{
+    Cancel();
+}
+
+void DatabaseWorkQueue::Configure(bool priorityLanes, uint8 keyedWorkers)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    _priorityLanes = priorityLanes;
+    _keyed.resize(keyedWorkers);
+}
+
+uint32 DatabaseWorkQueue::RegisterWorker()
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    return _workers++;
+}
+
+void DatabaseWorkQueue::Push(SQLOperation* operation, DatabaseWorkLane lane, uint64 orderingKey /*= 0*/)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+
+    std::deque<QueuedOperation>* queue;
+    if (orderingKey && !_keyed.empty())
+    {
+        lane = DATABASE_LANE_KEYED;
+        queue = &_keyed[orderingKey % _keyed.size()];
+    }
+    else
+    {
+        if (!_priorityLanes)
+            lane = DATABASE_LANE_BULK;
+        queue = &_lanes[lane];
+    }
+
+    queue->push_back({ operation, std::chrono::steady_clock::now() });
+
+    LaneStatistics& statistics = _statistics[lane];
+    statistics.LargestDepth = std::max(statistics.LargestDepth, uint32(queue->size()));
+
+    // only the owning worker may take a keyed operation, waking one arbitrary worker is not enough
+    if (lane == DATABASE_LANE_KEYED)
+        _condition.notify_all();
+    else
+        _condition.notify_one();
+}
+
+bool DatabaseWorkQueue::Pop(uint32 worker, SQLOperation*& operation)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    return PopLocked(worker, operation);
+}
+
+bool DatabaseWorkQueue::WaitAndPop(uint32 worker, SQLOperation*& operation)
+{
+    std::unique_lock<std::mutex> lock(_lock);
+
+    while (!PopLocked(worker, operation))
+    {
+        if (_shutdown)
+            return false;
+
+        _condition.wait(lock);
+    }
+
+    return true;
+}
+
+bool DatabaseWorkQueue::WaitUntilAndPop(uint32 worker, SQLOperation*& operation, std::chrono::steady_clock::time_point until)
+{
+    std::unique_lock<std::mutex> lock(_lock);
+
+    while (!PopLocked(worker, operation))
+    {
+        if (_shutdown || _condition.wait_until(lock, until) == std::cv_status::timeout)
+            return PopLocked(worker, operation);
+    }
+
+    return true;
+}
+
+size_t DatabaseWorkQueue::Size() const
+{
+    std::lock_guard<std::mutex> lock(_lock);
+
+    size_t size = 0;
+    for (std::deque<QueuedOperation> const& queue : _lanes)
+        size += queue.size();
+    for (std::deque<QueuedOperation> const& queue : _keyed)
+        size += queue.size();
+
+    return size;
+}
+
+void DatabaseWorkQueue::Cancel()
+{
+    std::lock_guard<std::mutex> lock(_lock);
+
+    for (std::deque<QueuedOperation>& queue : _lanes)
+    {
+        for (QueuedOperation const& queued : queue)
+            delete queued.Operation;
+        queue.clear();
+    }
+
+    for (std::deque<QueuedOperation>& queue : _keyed)
+    {
+        for (QueuedOperation const& queued : queue)
+            delete queued.Operation;
+        queue.clear();
+    }
+
+    _shutdown = true;
+
+    _condition.notify_all();
+}
+
+void DatabaseWorkQueue::LogStatistics(std::string const& database)
+{
+    LaneStatistics statistics[MAX_DATABASE_LANES];
+    uint32 depth[MAX_DATABASE_LANES] = { };
+    bool used[MAX_DATABASE_LANES];
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        std::copy(std::begin(_statistics), std::end(_statistics), std::begin(statistics));
+        std::fill(std::begin(_statistics), std::end(_statistics), LaneStatistics());
+
+        depth[DATABASE_LANE_INTERACTIVE] = uint32(_lanes[DATABASE_LANE_INTERACTIVE].size());
+        depth[DATABASE_LANE_BULK] = uint32(_lanes[DATABASE_LANE_BULK].size());
+        for (std::deque<QueuedOperation> const& queue : _keyed)
+            depth[DATABASE_LANE_KEYED] += uint32(queue.size());
+
+        used[DATABASE_LANE_INTERACTIVE] = _priorityLanes;
+        used[DATABASE_LANE_BULK] = true;
+        used[DATABASE_LANE_KEYED] = !_keyed.empty();
+    }
+
+    for (uint8 lane = 0; lane < MAX_DATABASE_LANES; ++lane)
+    {
+        if (!used[lane])
+            continue;
+
+        LaneStatistics const& laneStatistics = statistics[lane];
+        uint64 averageWait = laneStatistics.Operations ? laneStatistics.TotalWait / laneStatistics.Operations : 0;
+        TC_METRIC_VALUE("db_lane_depth", depth[lane], TC_METRIC_TAG("database", database), TC_METRIC_TAG("lane", LaneNames[lane]));
+        TC_METRIC_VALUE("db_lane_largest_depth", laneStatistics.LargestDepth, TC_METRIC_TAG("database", database), TC_METRIC_TAG("lane", LaneNames[lane]));
+        TC_METRIC_VALUE("db_lane_operations", laneStatistics.Operations, TC_METRIC_TAG("database", database), TC_METRIC_TAG("lane", LaneNames[lane]));
+        TC_METRIC_VALUE("db_lane_average_wait", averageWait, TC_METRIC_TAG("database", database), TC_METRIC_TAG("lane", LaneNames[lane]));
+        TC_METRIC_VALUE("db_lane_longest_wait", laneStatistics.LongestWait, TC_METRIC_TAG("database", database), TC_METRIC_TAG("lane", LaneNames[lane]));
+    }
+}
+
+bool DatabaseWorkQueue::PopLocked(uint32 worker, SQLOperation*& operation)
+{
+    if (_shutdown)
+        return false;
+
+    if (!_lanes[DATABASE_LANE_INTERACTIVE].empty())
+    {
+        PopFront(_lanes[DATABASE_LANE_INTERACTIVE], DATABASE_LANE_INTERACTIVE, operation);
+        return true;
+    }
+
+    if (!_keyed.empty())
+    {
+        std::deque<QueuedOperation>& keyed = _keyed[worker % _keyed.size()];
+        if (!keyed.empty())
+        {
+            PopFront(keyed, DATABASE_LANE_KEYED, operation);
+            return true;
+        }
+    }
+
+    if (!_lanes[DATABASE_LANE_BULK].empty())
+    {
+        PopFront(_lanes[DATABASE_LANE_BULK], DATABASE_LANE_BULK, operation);
+        return true;
+    }
+
+    return false;
+}
+
+void DatabaseWorkQueue::PopFront(std::deque<QueuedOperation>& queue, DatabaseWorkLane lane, SQLOperation*& operation)
+{
+    QueuedOperation const& queued = queue.front();
+    operation = queued.Operation;
+
+    uint64 wait = uint64(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - queued.Queued).count());
+    LaneStatistics& statistics = _statistics[lane];
+    ++statistics.Operations;
+    statistics.TotalWait += wait;
+    statistics.LongestWait = std::max(statistics.LongestWait, wait);
+
+    queue.pop_front();
+}
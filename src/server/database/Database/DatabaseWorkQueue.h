@@ -0,0 +1,103 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _DATABASEWORKQUEUE_H
+#define _DATABASEWORKQUEUE_H
+
+#include "Define.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class SQLOperation;
+
+enum DatabaseWorkLane : uint8
+{
+    DATABASE_LANE_INTERACTIVE,  // async queries and transactions the caller waits on
+    DATABASE_LANE_BULK,         // one-way statements and transactions
+    DATABASE_LANE_KEYED,        // operations routed to the worker owning their ordering key
+
+    MAX_DATABASE_LANES
+};
+
+//! Queue shared by the async workers of one DatabaseWorkerPool.
+//! Without priority lanes and key routing it is a single FIFO, like a ProducerConsumerQueue.
+//! With priority lanes enabled workers take interactive operations before bulk ones.
+//! With key routing enabled operations with the same non-zero ordering key always go to
+//! the same worker and keep their order, operations without a key can run on any worker.
+class TC_DATABASE_API DatabaseWorkQueue
+{
+public:
+    DatabaseWorkQueue();
+    ~DatabaseWorkQueue();
+
+    //! Must be called before operations are queued
+    void Configure(bool priorityLanes, uint8 keyedWorkers);
+
+    //! Called once by each async worker, returns the index it pops with
+    uint32 RegisterWorker();
+
+    void Push(SQLOperation* operation, DatabaseWorkLane lane, uint64 orderingKey = 0);
+
+    bool Pop(uint32 worker, SQLOperation*& operation);
+    bool WaitAndPop(uint32 worker, SQLOperation*& operation);
+    bool WaitUntilAndPop(uint32 worker, SQLOperation*& operation, std::chrono::steady_clock::time_point until);
+
+    size_t Size() const;
+
+    //! Deletes all queued operations and wakes up waiting workers
+    void Cancel();
+
+    //! Sends queue depth and wait time of the lanes in use to the metric server and resets the counters
+    void LogStatistics(std::string const& database);
+
+private:
+    struct QueuedOperation
+    {
+        SQLOperation* Operation;
+        std::chrono::steady_clock::time_point Queued;
+    };
+
+    struct LaneStatistics
+    {
+        uint32 Operations = 0;
+        uint32 LargestDepth = 0;
+        uint64 TotalWait = 0;       // microseconds
+        uint64 LongestWait = 0;     // microseconds
+    };
+
+    bool PopLocked(uint32 worker, SQLOperation*& operation);
+    void PopFront(std::deque<QueuedOperation>& queue, DatabaseWorkLane lane, SQLOperation*& operation);
+
+    mutable std::mutex _lock;
+    std::condition_variable _condition;
+    std::deque<QueuedOperation> _lanes[DATABASE_LANE_KEYED];
+    std::vector<std::deque<QueuedOperation>> _keyed;
+    LaneStatistics _statistics[MAX_DATABASE_LANES];
+    bool _priorityLanes;
+    bool _shutdown;
+    uint32 _workers;
+
+    DatabaseWorkQueue(DatabaseWorkQueue const& right) = delete;
+    DatabaseWorkQueue& operator=(DatabaseWorkQueue const& right) = delete;
+};
+
+#endif
@@ -16,13 +16,28 @@
  */
 
 #include "DatabaseWorker.h"
+#include "DatabaseWorkQueue.h"
+#include "Log.h"
+#include "MySQLConnection.h"
 #include "SQLOperation.h"
-#include "ProducerConsumerQueue.h"
+#include <vector>
 
-DatabaseWorker::DatabaseWorker(ProducerConsumerQueue<SQLOperation*>* newQueue, MySQLConnection* connection)
+namespace
+{
+    void UpdateLargest(std::atomic<uint32>& largest, uint32 value)
+    {
+        uint32 current = largest.load(std::memory_order_relaxed);
+        while (current < value && !largest.compare_exchange_weak(current, value, std::memory_order_relaxed))
+            ;
+    }
+}
+
+DatabaseWorker::DatabaseWorker(DatabaseWorkQueue* newQueue, MySQLConnection* connection)
 {
     _connection = connection;
     _queue = newQueue;
+    _queueIndex = _queue ? _queue->RegisterWorker() : 0;
+    _groupCommit = nullptr;
     _cancelationToken = false;
     _workerThread = std::thread(&DatabaseWorker::WorkerThread, this);
 }
@@ -45,14 +60,84 @@ void DatabaseWorker::WorkerThread()
     {
         SQLOperation* operation = nullptr;
 
-        _queue->WaitAndPop(operation);
+        _queue->WaitAndPop(_queueIndex, operation);
 
         if (_cancelationToken || !operation)
             return;
 
+        while (operation)
+        {
+            operation->SetConnection(_connection);
+            if (_groupCommit && _groupCommit->MaxOperations > 1 && operation->CanGroupCommit())
+                operation = ExecuteGroupCommit(operation);
+            else
+            {
+                operation->call();
+                delete operation;
+                operation = nullptr;
+            }
+        }
+    }
+}
+
+SQLOperation* DatabaseWorker::ExecuteGroupCommit(SQLOperation* first)
+{
+    UpdateLargest(_groupCommit->LargestQueue, uint32(_queue->Size()));
+
+    std::vector<SQLOperation*> batch;
+    batch.push_back(first);
+
+    SQLOperation* next = nullptr;
+    std::chrono::steady_clock::time_point const until = std::chrono::steady_clock::now() + std::chrono::milliseconds(_groupCommit->MaxDelay);
+    while (batch.size() < _groupCommit->MaxOperations)
+    {
+        SQLOperation* operation = nullptr;
+        if (!_queue->Pop(_queueIndex, operation) && (!_groupCommit->MaxDelay || !_queue->WaitUntilAndPop(_queueIndex, operation, until)))
+            break;
+
+        // queue order is kept, anything else ends the batch and runs after it
+        if (!operation->CanGroupCommit())
+        {
+            next = operation;
+            break;
+        }
+
         operation->SetConnection(_connection);
-        operation->call();
+        batch.push_back(operation);
+    }
 
-        delete operation;
+    if (batch.size() == 1)
+        first->call();
+    else
+    {
+        bool committed = true;
+        _connection->BeginTransaction();
+        for (SQLOperation* operation : batch)
+        {
+            if (!operation->ExecuteInGroupCommit())
+            {
+                committed = false;
+                break;
+            }
+        }
+
+        if (!committed || !_connection->CommitTransaction())
+        {
+            // replaying them keeps the error handling (deadlock retries, skipped statements) of each operation
+            TC_LOG_DEBUG("sql.sql", "Group commit of %u operations rolled back, executing them one by one.", uint32(batch.size()));
+            _connection->RollbackTransaction();
+            ++_groupCommit->FailedBatches;
+            for (SQLOperation* operation : batch)
+                operation->call();
+        }
     }
+
+    ++_groupCommit->Batches;
+    _groupCommit->Operations += uint32(batch.size());
+    UpdateLargest(_groupCommit->LargestBatch, uint32(batch.size()));
+
+    for (SQLOperation* operation : batch)
+        delete operation;
+
+    return next;
 }
@@ -22,23 +22,45 @@
 #include <atomic>
 #include <thread>
 
-template <typename T>
-class ProducerConsumerQueue;
-
+class DatabaseWorkQueue;
 class MySQLConnection;
 class SQLOperation;
 
+//! Settings and counters shared by the async workers of one DatabaseWorkerPool
+struct DatabaseGroupCommit
+{
+    DatabaseGroupCommit(uint32 maxOperations, uint32 maxDelay) : MaxOperations(maxOperations), MaxDelay(maxDelay),
+        Batches(0), Operations(0), LargestBatch(0), LargestQueue(0), FailedBatches(0) { }
+
+    uint32 const MaxOperations;             // one-way operations committed together at most, group commit is disabled below 2
+    uint32 const MaxDelay;                  // milliseconds the first operation of a batch waits for more to be queued
+
+    std::atomic<uint32> Batches;
+    std::atomic<uint32> Operations;
+    std::atomic<uint32> LargestBatch;
+    std::atomic<uint32> LargestQueue;       // operations left in the queue when a batch was started
+    std::atomic<uint32> FailedBatches;      // rolled back and executed one by one
+};
+
 class TC_DATABASE_API DatabaseWorker
 {
     public:
-        DatabaseWorker(ProducerConsumerQueue<SQLOperation*>* newQueue, MySQLConnection* connection);
+        DatabaseWorker(DatabaseWorkQueue* newQueue, MySQLConnection* connection);
         ~DatabaseWorker();
 
+        //! Must be set before operations are queued
+        void SetGroupCommit(DatabaseGroupCommit* groupCommit) { _groupCommit = groupCommit; }
+
     private:
-        ProducerConsumerQueue<SQLOperation*>* _queue;
+        DatabaseWorkQueue* _queue;
+        uint32 _queueIndex;                 // selects the keyed operations this worker executes
         MySQLConnection* _connection;
+        DatabaseGroupCommit* _groupCommit;
 
         void WorkerThread();
+        //! Executes first and the one-way operations queued after it in a single transaction,
+        //! returns the operation that ended the batch without being executed, if any
+        SQLOperation* ExecuteGroupCommit(SQLOperation* first);
         std::thread _workerThread;
 
         std::atomic<bool> _cancelationToken;
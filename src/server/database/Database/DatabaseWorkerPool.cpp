@@ -18,18 +18,21 @@
 #include "DatabaseWorkerPool.h"
 #include "AdhocStatement.h"
 #include "Common.h"
+#include "DatabaseWorker.h"
+#include "DatabaseWorkQueue.h"
 #include "Errors.h"
 #include "Implementation/LoginDatabase.h"
 #include "Implementation/WorldDatabase.h"
 #include "Implementation/CharacterDatabase.h"
 #include "Implementation/HotfixDatabase.h"
 #include "Log.h"
+#include "Metric.h"
 #include "MySQLPreparedStatement.h"
 #include "PreparedStatement.h"
-#include "ProducerConsumerQueue.h"
 #include "QueryCallback.h"
 #include "QueryHolder.h"
 #include "QueryResult.h"
+#include "QueryResultSnapshot.h"
 #include "SQLOperation.h"
 #include "Transaction.h"
 #include "MySQLWorkaround.h"
@@ -57,8 +60,8 @@ class PingOperation : public SQLOperation
 
 template <class T>
 DatabaseWorkerPool<T>::DatabaseWorkerPool()
-    : _queue(new ProducerConsumerQueue<SQLOperation*>()),
-      _async_threads(0), _synch_threads(0)
+    : _queue(new DatabaseWorkQueue()),
+      _async_threads(0), _synch_threads(0), _streamQueries(false), _priorityLanes(false), _keyRouting(false)
 {
     WPFatal(mysql_thread_safe(), "Used MySQL library isn't thread-safe.");
 
@@ -87,6 +90,50 @@ void DatabaseWorkerPool<T>::SetConnectionInfo(std::string const& infoString,
     _synch_threads = synchThreads;
 }
 
+template <class T>
+void DatabaseWorkerPool<T>::SetGroupCommit(uint32 maxOperations, uint32 maxDelay)
+{
+    if (maxOperations > 1)
+        _groupCommit = Trinity::make_unique<DatabaseGroupCommit>(maxOperations, maxDelay);
+    else
+        _groupCommit.reset();
+}
+
+template <class T>
+void DatabaseWorkerPool<T>::LogGroupCommitStatistics()
+{
+    if (!_groupCommit)
+        return;
+
+    std::string const database = GetDatabaseName();
+    TC_METRIC_VALUE("db_group_commit_batches", _groupCommit->Batches.exchange(0), TC_METRIC_TAG("database", database));
+    TC_METRIC_VALUE("db_group_commit_operations", _groupCommit->Operations.exchange(0), TC_METRIC_TAG("database", database));
+    TC_METRIC_VALUE("db_group_commit_largest_batch", _groupCommit->LargestBatch.exchange(0), TC_METRIC_TAG("database", database));
+    TC_METRIC_VALUE("db_group_commit_largest_queue", _groupCommit->LargestQueue.exchange(0), TC_METRIC_TAG("database", database));
+    TC_METRIC_VALUE("db_group_commit_failed_batches", _groupCommit->FailedBatches.exchange(0), TC_METRIC_TAG("database", database));
+}
+
+template <class T>
+void DatabaseWorkerPool<T>::LogQueueStatistics()
+{
+    _queue->LogStatistics(GetDatabaseName());
+}
+
+template <class T>
+void DatabaseWorkerPool<T>::OpenSnapshot(std::string const& path, std::string const& stateHash)
+{
+    std::unique_ptr<QueryResultSnapshot> snapshot = std::make_unique<QueryResultSnapshot>(path, stateHash);
+    snapshot->Load();
+    _snapshot = std::move(snapshot);
+}
+
+template <class T>
+void DatabaseWorkerPool<T>::CloseSnapshot()
+{
+    if (_snapshot)
+        _snapshot->Close();
+}
+
 template <class T>
 uint32 DatabaseWorkerPool<T>::Open()
 {
@@ -96,6 +143,8 @@ uint32 DatabaseWorkerPool<T>::Open()
         "Asynchronous connections: %u, synchronous connections: %u.",
         GetDatabaseName(), _async_threads, _synch_threads);
 
+    _queue->Configure(_priorityLanes, _keyRouting ? _async_threads : 0);
+
     uint32 error = OpenConnections(IDX_ASYNC, _async_threads);
 
     if (error)
@@ -181,11 +230,20 @@ bool DatabaseWorkerPool<T>::PrepareStatements()
 template <class T>
 QueryResult DatabaseWorkerPool<T>::Query(char const* sql, T* connection /*= nullptr*/)
 {
-    if (!connection)
-        connection = GetFreeConnection();
+    bool const useSnapshot = !connection && _snapshot && _snapshot->IsOpen();
+    ResultSet* result = useSnapshot ? _snapshot->Find(sql) : nullptr;
+    if (!result)
+    {
+        if (!connection)
+            connection = GetFreeConnection();
+
+        result = connection->Query(sql);
+        connection->Unlock();
+
+        if (result && useSnapshot)
+            result = _snapshot->Record(sql, result);
+    }
 
-    ResultSet* result = connection->Query(sql);
-    connection->Unlock();
     if (!result || !result->GetRowCount() || !result->NextRow())
     {
         delete result;
@@ -195,6 +253,40 @@ QueryResult DatabaseWorkerPool<T>::Query(char const* sql, T* connection /*= null
     return QueryResult(result);
 }
 
+template <class T>
+QueryResult DatabaseWorkerPool<T>::StreamQuery(char const* sql)
+{
+    if (!_streamQueries)
+        return Query(sql);
+
+    bool const useSnapshot = _snapshot && _snapshot->IsOpen();
+    ResultSet* result = useSnapshot ? _snapshot->Find(sql) : nullptr;
+    if (!result)
+    {
+        T* connection = GetFreeConnection();
+
+        // connection is unlocked by the result once it is done
+        result = connection->StreamQuery(sql);
+        if (!result)
+        {
+            connection->Unlock();
+            return QueryResult(nullptr);
+        }
+
+        // the rows are streamed straight into the snapshot, only its copy of the table is kept in memory
+        if (useSnapshot)
+            result = _snapshot->Record(sql, result);
+    }
+
+    if (!result->NextRow())
+    {
+        delete result;
+        return QueryResult(nullptr);
+    }
+
+    return QueryResult(result);
+}
+
 template <class T>
 PreparedQueryResult DatabaseWorkerPool<T>::Query(PreparedStatement<T>* stmt)
 {
@@ -220,27 +312,27 @@ QueryCallback DatabaseWorkerPool<T>::AsyncQuery(char const* sql)
     BasicStatementTask* task = new BasicStatementTask(sql, true);
     // Store future result before enqueueing - task might get already processed and deleted before returning from this method
     QueryResultFuture result = task->GetFuture();
-    Enqueue(task);
+    Enqueue(task, DATABASE_LANE_INTERACTIVE);
     return QueryCallback(std::move(result));
 }
 
 template <class T>
-QueryCallback DatabaseWorkerPool<T>::AsyncQuery(PreparedStatement<T>* stmt)
+QueryCallback DatabaseWorkerPool<T>::AsyncQuery(PreparedStatement<T>* stmt, uint64 orderingKey /*= 0*/)
 {
     PreparedStatementTask* task = new PreparedStatementTask(stmt, true);
     // Store future result before enqueueing - task might get already processed and deleted before returning from this method
     PreparedQueryResultFuture result = task->GetFuture();
-    Enqueue(task);
+    Enqueue(task, DATABASE_LANE_INTERACTIVE, orderingKey);
     return QueryCallback(std::move(result));
 }
 
 template <class T>
-SQLQueryHolderCallback DatabaseWorkerPool<T>::DelayQueryHolder(std::shared_ptr<SQLQueryHolder<T>> holder)
+SQLQueryHolderCallback DatabaseWorkerPool<T>::DelayQueryHolder(std::shared_ptr<SQLQueryHolder<T>> holder, uint64 orderingKey /*= 0*/)
 {
     SQLQueryHolderTask* task = new SQLQueryHolderTask(holder);
     // Store future result before enqueueing - task might get already processed and deleted before returning from this method
     QueryResultHolderFuture result = task->GetFuture();
-    Enqueue(task);
+    Enqueue(task, DATABASE_LANE_INTERACTIVE, orderingKey);
     return { std::move(holder), std::move(result) };
 }
 
@@ -251,8 +343,11 @@ SQLTransaction<T> DatabaseWorkerPool<T>::BeginTransaction()
 }
 
 template <class T>
-void DatabaseWorkerPool<T>::CommitTransaction(SQLTransaction<T> transaction)
+void DatabaseWorkerPool<T>::CommitTransaction(SQLTransaction<T> transaction, uint64 orderingKey /*= 0*/)
 {
+    if (_snapshot)
+        _snapshot->Invalidate();
+
 #ifdef TRINITY_DEBUG
     //! Only analyze transaction weaknesses in Debug mode.
     //! Ideally we catch the faults in Debug mode and then correct them,
@@ -270,12 +365,15 @@ void DatabaseWorkerPool<T>::CommitTransaction(SQLTransaction<T> transaction)
     }
 #endif // TRINITY_DEBUG
 
-    Enqueue(new TransactionTask(transaction));
+    Enqueue(new TransactionTask(transaction), DATABASE_LANE_BULK, orderingKey);
 }
 
 template <class T>
-TransactionCallback DatabaseWorkerPool<T>::AsyncCommitTransaction(SQLTransaction<T> transaction)
+TransactionCallback DatabaseWorkerPool<T>::AsyncCommitTransaction(SQLTransaction<T> transaction, uint64 orderingKey /*= 0*/)
 {
+    if (_snapshot)
+        _snapshot->Invalidate();
+
 #ifdef TRINITY_DEBUG
     //! Only analyze transaction weaknesses in Debug mode.
     //! Ideally we catch the faults in Debug mode and then correct them,
@@ -295,13 +393,16 @@ TransactionCallback DatabaseWorkerPool<T>::AsyncCommitTransaction(SQLTransaction
 
     TransactionWithResultTask* task = new TransactionWithResultTask(transaction);
     TransactionFuture result = task->GetFuture();
-    Enqueue(task);
+    Enqueue(task, DATABASE_LANE_INTERACTIVE, orderingKey);
     return TransactionCallback(std::move(result));
 }
 
 template <class T>
 void DatabaseWorkerPool<T>::DirectCommitTransaction(SQLTransaction<T>& transaction)
 {
+    if (_snapshot)
+        _snapshot->Invalidate();
+
     T* connection = GetFreeConnection();
     int errorCode = connection->ExecuteTransaction(transaction);
     if (!errorCode)
@@ -365,7 +466,7 @@ void DatabaseWorkerPool<T>::KeepAlive()
     //! as the sole purpose is to prevent connections from idling.
     auto const count = _connections[IDX_ASYNC].size();
     for (uint8 i = 0; i < count; ++i)
-        Enqueue(new PingOperation);
+        Enqueue(new PingOperation, DATABASE_LANE_BULK);
 }
 
 template <class T>
@@ -407,6 +508,9 @@ uint32 DatabaseWorkerPool<T>::OpenConnections(InternalIndex type, uint8 numConne
         }
         else
         {
+            if (type == IDX_ASYNC && _groupCommit)
+                connection->m_worker->SetGroupCommit(_groupCommit.get());
+
             _connections[type].push_back(std::move(connection));
         }
     }
@@ -425,9 +529,9 @@ unsigned long DatabaseWorkerPool<T>::EscapeString(char* to, char const* from, un
 }
 
 template <class T>
-void DatabaseWorkerPool<T>::Enqueue(SQLOperation* op)
+void DatabaseWorkerPool<T>::Enqueue(SQLOperation* op, DatabaseWorkLane lane, uint64 orderingKey /*= 0*/)
 {
-    _queue->Push(op);
+    _queue->Push(op, lane, orderingKey);
 }
 
 template <class T>
@@ -463,23 +567,32 @@ char const* DatabaseWorkerPool<T>::GetDatabaseName() const
 template <class T>
 void DatabaseWorkerPool<T>::Execute(char const* sql)
 {
+    if (_snapshot)
+        _snapshot->Invalidate();
+
     if (Trinity::IsFormatEmptyOrNull(sql))
         return;
 
     BasicStatementTask* task = new BasicStatementTask(sql);
-    Enqueue(task);
+    Enqueue(task, DATABASE_LANE_BULK);
 }
 
 template <class T>
-void DatabaseWorkerPool<T>::Execute(PreparedStatement<T>* stmt)
+void DatabaseWorkerPool<T>::Execute(PreparedStatement<T>* stmt, uint64 orderingKey /*= 0*/)
 {
+    if (_snapshot)
+        _snapshot->Invalidate();
+
     PreparedStatementTask* task = new PreparedStatementTask(stmt);
-    Enqueue(task);
+    Enqueue(task, DATABASE_LANE_BULK, orderingKey);
 }
 
 template <class T>
 void DatabaseWorkerPool<T>::DirectExecute(char const* sql)
 {
+    if (_snapshot)
+        _snapshot->Invalidate();
+
     if (Trinity::IsFormatEmptyOrNull(sql))
         return;
 
@@ -488,9 +601,29 @@ void DatabaseWorkerPool<T>::DirectExecute(char const* sql)
     connection->Unlock();
 }
 
+template <class T>
+bool DatabaseWorkerPool<T>::DirectExecuteMultiStatement(std::string const& sql)
+{
+    if (_snapshot)
+        _snapshot->Invalidate();
+
+    if (sql.empty())
+        return true;
+
+    // scripts may SET session variables, like with the mysql CLI every script gets a fresh session
+    T connection(*_connectionInfo);
+    if (connection.Open())
+        return false;
+
+    return connection.ExecuteMultiStatement(sql.c_str(), sql.length());
+}
+
 template <class T>
 void DatabaseWorkerPool<T>::DirectExecute(PreparedStatement<T>* stmt)
 {
+    if (_snapshot)
+        _snapshot->Invalidate();
+
     T* connection = GetFreeConnection();
     connection->Execute(stmt);
     connection->Unlock();
@@ -22,15 +22,18 @@
 #include "DatabaseEnvFwd.h"
 #include "StringFormat.h"
 #include <array>
+#include <memory>
 #include <string>
 #include <vector>
 
-template <typename T>
-class ProducerConsumerQueue;
-
+class DatabaseWorkQueue;
+class QueryResultSnapshot;
 class SQLOperation;
+struct DatabaseGroupCommit;
 struct MySQLConnectionInfo;
 
+enum DatabaseWorkLane : uint8;
+
 template <class T>
 class DatabaseWorkerPool
 {
@@ -49,6 +52,34 @@ class DatabaseWorkerPool
         ~DatabaseWorkerPool();
 
         void SetConnectionInfo(std::string const& infoString, uint8 const asyncThreads, uint8 const synchThreads);
+        void SetStreamQueries(bool enabled) { _streamQueries = enabled; }
+        bool IsStreamQueriesEnabled() const { return _streamQueries; }
+        uint8 GetSynchThreadCount() const { return _synch_threads; }
+
+        //! Lets async workers commit up to maxOperations queued one-way statements and transactions in a single transaction,
+        //! waiting at most maxDelay milliseconds for more to be queued. Must be called before Open.
+        void SetGroupCommit(uint32 maxOperations, uint32 maxDelay);
+
+        //! Sends group commit batch counters to the metric server and resets them
+        void LogGroupCommitStatistics();
+
+        //! Lets async workers execute queries and transactions somebody waits on before queued one-way statements
+        //! and transactions. Must be called before Open.
+        void SetPriorityLanes(bool enabled) { _priorityLanes = enabled; }
+
+        //! Sends async operations with the same non-zero ordering key to the same worker, keeping their order
+        //! with more than one worker thread and with priority lanes. Must be called before Open.
+        void SetKeyRouting(bool enabled) { _keyRouting = enabled; }
+
+        //! Sends queue depth and wait time of each lane to the metric server and resets them
+        void LogQueueStatistics();
+
+        //! Answers text queries from the snapshot file at path while it matches stateHash, queries missing from it are recorded.
+        //! Writing to the database after CloseSnapshot removes the file.
+        void OpenSnapshot(std::string const& path, std::string const& stateHash);
+
+        //! Writes recorded queries to the snapshot file, results returned from it must no longer be used
+        void CloseSnapshot();
 
         uint32 Open();
 
@@ -83,7 +114,8 @@ class DatabaseWorkerPool
 
         //! Enqueues a one-way SQL operation in prepared statement format that will be executed asynchronously.
         //! Statement must be prepared with CONNECTION_ASYNC flag.
-        void Execute(PreparedStatement<T>* stmt);
+        //! Operations with the same non-zero orderingKey are executed in order when key routing is enabled.
+        void Execute(PreparedStatement<T>* stmt, uint64 orderingKey = 0);
 
         /**
             Direct synchronous one-way statement methods.
@@ -93,6 +125,12 @@ class DatabaseWorkerPool
         //! This method should only be used for queries that are only executed once, e.g during startup.
         void DirectExecute(char const* sql);
 
+        //! Directly executes one or more ';' separated statements in a single round trip, that will block the calling thread until finished.
+        //! Client commands of the mysql CLI like DELIMITER are not supported. Returns false if a statement failed, the following ones are not executed.
+        //! This method should only be used for scripts that are only executed once, e.g database updates during startup.
+        //! The script runs on a connection of its own, session variables it changes do not leak into the pooled connections.
+        bool DirectExecuteMultiStatement(std::string const& sql);
+
         //! Directly executes a one-way SQL operation in string format -with variable args-, that will block the calling thread until finished.
         //! This method should only be used for queries that are only executed once, e.g during startup.
         template<typename Format, typename... Args>
@@ -116,6 +154,15 @@ class DatabaseWorkerPool
         //! Returns reference counted auto pointer, no need for manual memory management in upper level code.
         QueryResult Query(char const* sql, T* connection = nullptr);
 
+        //! Directly executes an SQL query in string format, rows are fetched from the server while iterating the result
+        //! instead of being buffered in memory first. Meant for loaders going through large tables once.
+        //! GetRowCount() only returns the number of rows fetched so far.
+        //! A synch connection stays reserved until the result is destroyed, the caller must not run synchronous queries
+        //! on this pool while holding it unless more than one synch thread is configured, and the result must be released
+        //! on the calling thread.
+        //! Falls back to Query when streaming is disabled in config.
+        QueryResult StreamQuery(char const* sql);
+
         //! Directly executes an SQL query in string format -with variable args- that will block the calling thread until finished.
         //! Returns reference counted auto pointer, no need for manual memory management in upper level code.
         template<typename Format, typename... Args>
@@ -154,13 +201,15 @@ class DatabaseWorkerPool
         //! Enqueues a query in prepared format that will set the value of the PreparedQueryResultFuture return object as soon as the query is executed.
         //! The return value is then processed in ProcessQueryCallback methods.
         //! Statement must be prepared with CONNECTION_ASYNC flag.
-        QueryCallback AsyncQuery(PreparedStatement<T>* stmt);
+        //! Operations with the same non-zero orderingKey are executed in order when key routing is enabled.
+        QueryCallback AsyncQuery(PreparedStatement<T>* stmt, uint64 orderingKey = 0);
 
         //! Enqueues a vector of SQL operations (can be both adhoc and prepared) that will set the value of the QueryResultHolderFuture
         //! return object as soon as the query is executed.
         //! The return value is then processed in ProcessQueryCallback methods.
         //! Any prepared statements added to this holder need to be prepared with the CONNECTION_ASYNC flag.
-        SQLQueryHolderCallback DelayQueryHolder(std::shared_ptr<SQLQueryHolder<T>> holder);
+        //! Operations with the same non-zero orderingKey are executed in order when key routing is enabled.
+        SQLQueryHolderCallback DelayQueryHolder(std::shared_ptr<SQLQueryHolder<T>> holder, uint64 orderingKey = 0);
 
         /**
             Transaction context methods.
@@ -171,11 +220,13 @@ class DatabaseWorkerPool
 
         //! Enqueues a collection of one-way SQL operations (can be both adhoc and prepared). The order in which these operations
         //! were appended to the transaction will be respected during execution.
-        void CommitTransaction(SQLTransaction<T> transaction);
+        //! Operations with the same non-zero orderingKey are executed in order when key routing is enabled.
+        void CommitTransaction(SQLTransaction<T> transaction, uint64 orderingKey = 0);
 
         //! Enqueues a collection of one-way SQL operations (can be both adhoc and prepared). The order in which these operations
         //! were appended to the transaction will be respected during execution.
-        TransactionCallback AsyncCommitTransaction(SQLTransaction<T> transaction);
+        //! Operations with the same non-zero orderingKey are executed in order when key routing is enabled.
+        TransactionCallback AsyncCommitTransaction(SQLTransaction<T> transaction, uint64 orderingKey = 0);
 
         //! Directly executes a collection of one-way SQL operations (can be both adhoc and prepared). The order in which these operations
         //! were appended to the transaction will be respected during execution.
@@ -213,7 +264,7 @@ class DatabaseWorkerPool
 
         unsigned long EscapeString(char* to, char const* from, unsigned long length);
 
-        void Enqueue(SQLOperation* op);
+        void Enqueue(SQLOperation* op, DatabaseWorkLane lane, uint64 orderingKey = 0);
 
         //! Gets a free connection in the synchronous connection pool.
         //! Caller MUST call t->Unlock() after touching the MySQL context to prevent deadlocks.
@@ -222,11 +273,17 @@ class DatabaseWorkerPool
         char const* GetDatabaseName() const;
 
         //! Queue shared by async worker threads.
-        std::unique_ptr<ProducerConsumerQueue<SQLOperation*>> _queue;
+        std::unique_ptr<DatabaseWorkQueue> _queue;
+        //! Shared with async workers, destroyed after them
+        std::unique_ptr<DatabaseGroupCommit> _groupCommit;
         std::array<std::vector<std::unique_ptr<T>>, IDX_SIZE> _connections;
         std::unique_ptr<MySQLConnectionInfo> _connectionInfo;
         std::vector<uint8> _preparedStatementSize;
         uint8 _async_threads, _synch_threads;
+        bool _streamQueries;
+        bool _priorityLanes;
+        bool _keyRouting;
+        std::unique_ptr<QueryResultSnapshot> _snapshot;
 };
 
 #endif
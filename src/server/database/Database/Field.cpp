@@ -19,6 +19,8 @@
 #include "Errors.h"
 #include "Log.h"
 #include "MySQLHacks.h"
+#include <charconv>
+#include <cstdlib>
 #include <cstring>
 
 Field::Field()
@@ -26,6 +28,8 @@ Field::Field()
     data.value = nullptr;
     data.length = 0;
     data.raw = false;
+    data.parsed = ParsedValue::None;
+    data.integer = 0;
     meta = nullptr;
 }
 
@@ -46,6 +50,8 @@ uint8 Field::GetUInt8() const
 
     if (data.raw)
         return *reinterpret_cast<uint8 const*>(data.value);
+    if (data.parsed == ParsedValue::Integer)
+        return static_cast<uint8>(data.integer);
     return static_cast<uint8>(strtoul(data.value, nullptr, 10));
 }
 
@@ -64,6 +70,8 @@ int8 Field::GetInt8() const
 
     if (data.raw)
         return *reinterpret_cast<int8 const*>(data.value);
+    if (data.parsed == ParsedValue::Integer)
+        return static_cast<int8>(data.integer);
     return static_cast<int8>(strtol(data.value, nullptr, 10));
 }
 
@@ -82,6 +90,8 @@ uint16 Field::GetUInt16() const
 
     if (data.raw)
         return *reinterpret_cast<uint16 const*>(data.value);
+    if (data.parsed == ParsedValue::Integer)
+        return static_cast<uint16>(data.integer);
     return static_cast<uint16>(strtoul(data.value, nullptr, 10));
 }
 
@@ -100,6 +110,8 @@ int16 Field::GetInt16() const
 
     if (data.raw)
         return *reinterpret_cast<int16 const*>(data.value);
+    if (data.parsed == ParsedValue::Integer)
+        return static_cast<int16>(data.integer);
     return static_cast<int16>(strtol(data.value, nullptr, 10));
 }
 
@@ -118,6 +130,8 @@ uint32 Field::GetUInt32() const
 
     if (data.raw)
         return *reinterpret_cast<uint32 const*>(data.value);
+    if (data.parsed == ParsedValue::Integer)
+        return static_cast<uint32>(data.integer);
     return static_cast<uint32>(strtoul(data.value, nullptr, 10));
 }
 
@@ -136,6 +150,8 @@ int32 Field::GetInt32() const
 
     if (data.raw)
         return *reinterpret_cast<int32 const*>(data.value);
+    if (data.parsed == ParsedValue::Integer)
+        return static_cast<int32>(data.integer);
     return static_cast<int32>(strtol(data.value, nullptr, 10));
 }
 
@@ -154,6 +170,8 @@ uint64 Field::GetUInt64() const
 
     if (data.raw)
         return *reinterpret_cast<uint64 const*>(data.value);
+    if (data.parsed == ParsedValue::Integer)
+        return static_cast<uint64>(data.integer);
     return static_cast<uint64>(strtoull(data.value, nullptr, 10));
 }
 
@@ -172,6 +190,8 @@ int64 Field::GetInt64() const
 
     if (data.raw)
         return *reinterpret_cast<int64 const*>(data.value);
+    if (data.parsed == ParsedValue::Integer)
+        return static_cast<int64>(data.integer);
     return static_cast<int64>(strtoll(data.value, nullptr, 10));
 }
 
@@ -190,6 +210,8 @@ float Field::GetFloat() const
 
     if (data.raw)
         return *reinterpret_cast<float const*>(data.value);
+    if (data.parsed == ParsedValue::Real)
+        return static_cast<float>(data.real);
     return static_cast<float>(atof(data.value));
 }
 
@@ -208,6 +230,8 @@ double Field::GetDouble() const
 
     if (data.raw && !IsType(DatabaseFieldTypes::Decimal))
         return *reinterpret_cast<double const*>(data.value);
+    if (data.parsed == ParsedValue::Real)
+        return data.real;
     return static_cast<double>(atof(data.value));
 }
 
@@ -267,6 +291,7 @@ void Field::SetByteValue(char const* newValue, uint32 length)
     data.value = newValue;
     data.length = length;
     data.raw = true;
+    data.parsed = ParsedValue::None;
 }
 
 void Field::SetStructuredValue(char const* newValue, uint32 length)
@@ -275,6 +300,61 @@ void Field::SetStructuredValue(char const* newValue, uint32 length)
     data.value = newValue;
     data.length = length;
     data.raw = false;
+    data.parsed = ParsedValue::None;
+
+    if (!newValue)
+        return;
+
+    // Numeric columns are converted once here so that getters only load the value, anything the
+    // conversion does not fully consume (overflow, trailing characters) is left to the getters
+    char const* end = newValue + length;
+    switch (meta->Type)
+    {
+        case DatabaseFieldTypes::UInt8:
+        case DatabaseFieldTypes::UInt16:
+        case DatabaseFieldTypes::UInt32:
+        case DatabaseFieldTypes::UInt64:
+        {
+            uint64 value = 0;
+            std::from_chars_result result = std::from_chars(newValue, end, value);
+            if (result.ec == std::errc() && result.ptr == end)
+            {
+                data.integer = value;
+                data.parsed = ParsedValue::Integer;
+            }
+            break;
+        }
+        case DatabaseFieldTypes::Int8:
+        case DatabaseFieldTypes::Int16:
+        case DatabaseFieldTypes::Int32:
+        case DatabaseFieldTypes::Int64:
+        {
+            int64 value = 0;
+            std::from_chars_result result = std::from_chars(newValue, end, value);
+            if (result.ec == std::errc() && result.ptr == end)
+            {
+                data.integer = uint64(value);
+                data.parsed = ParsedValue::Integer;
+            }
+            break;
+        }
+        case DatabaseFieldTypes::Float:
+        case DatabaseFieldTypes::Double:
+        case DatabaseFieldTypes::Decimal:
+        {
+            // strtod instead of std::from_chars, floating point from_chars is missing in older standard libraries
+            char* parsedEnd = nullptr;
+            double value = strtod(newValue, &parsedEnd);
+            if (parsedEnd == end)
+            {
+                data.real = value;
+                data.parsed = ParsedValue::Real;
+            }
+            break;
+        }
+        default:
+            break;
+    }
 }
 
 bool Field::IsType(DatabaseFieldTypes type) const
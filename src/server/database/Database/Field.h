@@ -86,6 +86,7 @@ class TC_DATABASE_API Field
 {
     friend class ResultSet;
     friend class PreparedResultSet;
+    friend class QueryResultSnapshot;
 
     public:
         Field();
@@ -124,11 +125,24 @@ class TC_DATABASE_API Field
         }
 
     protected:
+        enum class ParsedValue : uint8
+        {
+            None,                       // raw value or text that has to be converted by the getter
+            Integer,
+            Real
+        };
+
         struct
         {
             char const* value;          // Actual data in memory
             uint32 length;              // Length
             bool raw;                   // Raw bytes? (Prepared statement or ad hoc)
+            ParsedValue parsed;         // Numeric text converted once when the row was fetched
+            union
+            {
+                uint64 integer;         // signed values are stored in two's complement
+                double real;
+            };
          } data;
 
         void SetByteValue(char const* newValue, uint32 length);
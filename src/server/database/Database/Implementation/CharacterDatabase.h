@@ -578,7 +578,7 @@ public:
 
     //- Constructors for sync and async connections
     CharacterDatabaseConnection(MySQLConnectionInfo& connInfo);
-    CharacterDatabaseConnection(ProducerConsumerQueue<SQLOperation*>* q, MySQLConnectionInfo& connInfo);
+    CharacterDatabaseConnection(DatabaseWorkQueue* q, MySQLConnectionInfo& connInfo);
     ~CharacterDatabaseConnection();
 
     //- Loads database type specific prepared statements
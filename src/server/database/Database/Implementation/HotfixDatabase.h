@@ -49,7 +49,7 @@ public:
 
     //- Constructors for sync and async connections
     HotfixDatabaseConnection(MySQLConnectionInfo& connInfo);
-    HotfixDatabaseConnection(ProducerConsumerQueue<SQLOperation*>* q, MySQLConnectionInfo& connInfo);
+    HotfixDatabaseConnection(DatabaseWorkQueue* q, MySQLConnectionInfo& connInfo);
     ~HotfixDatabaseConnection();
 
     //- Loads database type specific prepared statements
@@ -53,7 +53,7 @@ m_Mysql(nullptr),
 m_connectionInfo(connInfo),
 m_connectionFlags(CONNECTION_SYNCH) { }
 
-MySQLConnection::MySQLConnection(ProducerConsumerQueue<SQLOperation*>* queue, MySQLConnectionInfo& connInfo) :
+MySQLConnection::MySQLConnection(DatabaseWorkQueue* queue, MySQLConnectionInfo& connInfo) :
 m_reconnecting(false),
 m_prepareError(false),
 m_queue(queue),
@@ -192,6 +192,54 @@ bool MySQLConnection::Execute(char const* sql)
     return true;
 }
 
+bool MySQLConnection::ExecuteMultiStatement(char const* sql, size_t length)
+{
+    if (!m_Mysql)
+        return false;
+
+    uint32 _s = getMSTime();
+
+    // only enabled for this call, prepared statements and regular queries keep rejecting multiple statements
+    if (mysql_set_server_option(m_Mysql, MYSQL_OPTION_MULTI_STATEMENTS_ON))
+    {
+        TC_LOG_ERROR("sql.sql", "[%u] %s", mysql_errno(m_Mysql), mysql_error(m_Mysql));
+        return false;
+    }
+
+    bool success = true;
+    uint32 statements = 0;
+    int status = mysql_real_query(m_Mysql, sql, static_cast<unsigned long>(length));
+    while (!status)
+    {
+        ++statements;
+
+        // results of statements like SHOW or SELECT are discarded, they have to be read before the next statement runs
+        if (MYSQL_RES* result = mysql_store_result(m_Mysql))
+            mysql_free_result(result);
+        else if (mysql_field_count(m_Mysql))
+            break;
+
+        // 0 = next result available, -1 = no more results, > 0 = the next statement failed
+        status = mysql_next_result(m_Mysql);
+    }
+
+    if (status > 0 || (!status && mysql_field_count(m_Mysql)))
+    {
+        TC_LOG_ERROR("sql.sql", "[%u] %s (statement %u)", mysql_errno(m_Mysql), mysql_error(m_Mysql), statements + 1);
+        success = false;
+
+        // results still pending after a failed read must be consumed before the connection is usable again
+        while (mysql_more_results(m_Mysql) && !mysql_next_result(m_Mysql))
+            if (MYSQL_RES* result = mysql_store_result(m_Mysql))
+                mysql_free_result(result);
+    }
+    else
+        TC_LOG_DEBUG("sql.sql", "[%u ms] Executed %u statements", getMSTimeDiff(_s, getMSTime()), statements);
+
+    mysql_set_server_option(m_Mysql, MYSQL_OPTION_MULTI_STATEMENTS_OFF);
+    return success;
+}
+
 bool MySQLConnection::Execute(PreparedStatementBase* stmt)
 {
     if (!m_Mysql)
@@ -310,7 +358,23 @@ ResultSet* MySQLConnection::Query(char const* sql)
     return new ResultSet(result, fields, rowCount, fieldCount);
 }
 
-bool MySQLConnection::_Query(const char* sql, MySQLResult** pResult, MySQLField** pFields, uint64* pRowCount, uint32* pFieldCount)
+ResultSet* MySQLConnection::StreamQuery(char const* sql)
+{
+    if (!sql)
+        return nullptr;
+
+    MySQLResult* result = nullptr;
+    MySQLField* fields = nullptr;
+    uint64 rowCount = 0;
+    uint32 fieldCount = 0;
+
+    if (!_Query(sql, &result, &fields, &rowCount, &fieldCount, true))
+        return nullptr;
+
+    return new ResultSet(result, fields, rowCount, fieldCount, this);
+}
+
+bool MySQLConnection::_Query(const char* sql, MySQLResult** pResult, MySQLField** pFields, uint64* pRowCount, uint32* pFieldCount, bool stream /*= false*/)
 {
     if (!m_Mysql)
         return false;
@@ -325,22 +389,31 @@ bool MySQLConnection::_Query(const char* sql, MySQLResult** pResult, MySQLField*
             TC_LOG_ERROR("sql.sql", "[%u] %s", lErrno, mysql_error(m_Mysql));
 
             if (_HandleMySQLErrno(lErrno))      // If it returns true, an error was handled successfully (i.e. reconnection)
-                return _Query(sql, pResult, pFields, pRowCount, pFieldCount);    // We try again
+                return _Query(sql, pResult, pFields, pRowCount, pFieldCount, stream);    // We try again
 
             return false;
         }
         else
             TC_LOG_DEBUG("sql.sql", "[%u ms] SQL: %s", getMSTimeDiff(_s, getMSTime()), sql);
 
-        *pResult = reinterpret_cast<MySQLResult*>(mysql_store_result(m_Mysql));
-        *pRowCount = mysql_affected_rows(m_Mysql);
+        if (stream)
+        {
+            // row count is not known until all rows are fetched
+            *pResult = reinterpret_cast<MySQLResult*>(mysql_use_result(m_Mysql));
+            *pRowCount = 0;
+        }
+        else
+        {
+            *pResult = reinterpret_cast<MySQLResult*>(mysql_store_result(m_Mysql));
+            *pRowCount = mysql_affected_rows(m_Mysql);
+        }
         *pFieldCount = mysql_field_count(m_Mysql);
     }
 
     if (!*pResult )
         return false;
 
-    if (!*pRowCount)
+    if (!stream && !*pRowCount)
     {
         mysql_free_result(*pResult);
         return false;
@@ -361,9 +434,9 @@ void MySQLConnection::RollbackTransaction()
     Execute("ROLLBACK");
 }
 
-void MySQLConnection::CommitTransaction()
+bool MySQLConnection::CommitTransaction()
 {
-    Execute("COMMIT");
+    return Execute("COMMIT");
 }
 
 int MySQLConnection::ExecuteTransaction(std::shared_ptr<TransactionBase> transaction)
@@ -374,22 +447,35 @@ int MySQLConnection::ExecuteTransaction(std::shared_ptr<TransactionBase> transac
 
     BeginTransaction();
 
-    for (auto itr = queries.begin(); itr != queries.end(); ++itr)
+    if (!ExecuteTransactionQueries(queries))
     {
-        SQLElementData const& data = *itr;
-        switch (itr->type)
+        TC_LOG_WARN("sql.sql", "Transaction aborted. %u queries not executed.", (uint32)queries.size());
+        int errorCode = GetLastError();
+        RollbackTransaction();
+        return errorCode;
+    }
+
+    // we might encounter errors during certain queries, and depending on the kind of error
+    // we might want to restart the transaction. So to prevent data loss, we only clean up when it's all done.
+    // This is done in calling functions DatabaseWorkerPool<T>::DirectCommitTransaction and TransactionTask::Execute,
+    // and not while iterating over every element.
+
+    CommitTransaction();
+    return 0;
+}
+
+bool MySQLConnection::ExecuteTransactionQueries(std::vector<SQLElementData> const& queries)
+{
+    for (SQLElementData const& data : queries)
+    {
+        switch (data.type)
         {
             case SQL_ELEMENT_PREPARED:
             {
                 PreparedStatementBase* stmt = data.element.stmt;
                 ASSERT(stmt);
                 if (!Execute(stmt))
-                {
-                    TC_LOG_WARN("sql.sql", "Transaction aborted. %u queries not executed.", (uint32)queries.size());
-                    int errorCode = GetLastError();
-                    RollbackTransaction();
-                    return errorCode;
-                }
+                    return false;
                 break;
             }
             case SQL_ELEMENT_RAW:
@@ -397,24 +483,13 @@ int MySQLConnection::ExecuteTransaction(std::shared_ptr<TransactionBase> transac
                 char const* sql = data.element.query;
                 ASSERT(sql);
                 if (!Execute(sql))
-                {
-                    TC_LOG_WARN("sql.sql", "Transaction aborted. %u queries not executed.", (uint32)queries.size());
-                    int errorCode = GetLastError();
-                    RollbackTransaction();
-                    return errorCode;
-                }
+                    return false;
                 break;
             }
         }
     }
 
-    // we might encounter errors during certain queries, and depending on the kind of error
-    // we might want to restart the transaction. So to prevent data loss, we only clean up when it's all done.
-    // This is done in calling functions DatabaseWorkerPool<T>::DirectCommitTransaction and TransactionTask::Execute,
-    // and not while iterating over every element.
-
-    CommitTransaction();
-    return 0;
+    return true;
 }
 
 size_t MySQLConnection::EscapeString(char* to, const char* from, size_t length)
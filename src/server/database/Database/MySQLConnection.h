@@ -26,12 +26,11 @@
 #include <string>
 #include <vector>
 
-template <typename T>
-class ProducerConsumerQueue;
-
+class DatabaseWorkQueue;
 class DatabaseWorker;
 class MySQLPreparedStatement;
 class SQLOperation;
+struct SQLElementData;
 
 enum ConnectionFlags
 {
@@ -55,10 +54,11 @@ class TC_DATABASE_API MySQLConnection
 {
     template <class T> friend class DatabaseWorkerPool;
     friend class PingOperation;
+    friend class ResultSet;
 
     public:
         MySQLConnection(MySQLConnectionInfo& connInfo);                               //! Constructor for synchronous connections.
-        MySQLConnection(ProducerConsumerQueue<SQLOperation*>* queue, MySQLConnectionInfo& connInfo);  //! Constructor for asynchronous connections.
+        MySQLConnection(DatabaseWorkQueue* queue, MySQLConnectionInfo& connInfo);    //! Constructor for asynchronous connections.
         virtual ~MySQLConnection();
 
         virtual uint32 Open();
@@ -68,15 +68,21 @@ class TC_DATABASE_API MySQLConnection
 
         bool Execute(char const* sql);
         bool Execute(PreparedStatementBase* stmt);
+        //! Executes one or more ';' separated statements in a single round trip, stops at the first failing statement
+        bool ExecuteMultiStatement(char const* sql, size_t length);
         ResultSet* Query(char const* sql);
+        //! Rows are fetched from the server while iterating, connection stays locked until the result is destroyed
+        ResultSet* StreamQuery(char const* sql);
         PreparedResultSet* Query(PreparedStatementBase* stmt);
-        bool _Query(char const* sql, MySQLResult** pResult, MySQLField** pFields, uint64* pRowCount, uint32* pFieldCount);
+        bool _Query(char const* sql, MySQLResult** pResult, MySQLField** pFields, uint64* pRowCount, uint32* pFieldCount, bool stream = false);
         bool _Query(PreparedStatementBase* stmt, MySQLResult** pResult, uint64* pRowCount, uint32* pFieldCount);
 
         void BeginTransaction();
         void RollbackTransaction();
-        void CommitTransaction();
+        bool CommitTransaction();
         int ExecuteTransaction(std::shared_ptr<TransactionBase> transaction);
+        //! Executes the queries of a transaction in order, stops at the first failure. Does not start or end the transaction.
+        bool ExecuteTransactionQueries(std::vector<SQLElementData> const& queries);
         size_t EscapeString(char* to, const char* from, size_t length);
         void Ping();
 
@@ -105,7 +111,7 @@ class TC_DATABASE_API MySQLConnection
     private:
         bool _HandleMySQLErrno(uint32 errNo, uint8 attempts = 5);
 
-        ProducerConsumerQueue<SQLOperation*>* m_queue;      //! Queue shared with other asynchronous connections.
+        DatabaseWorkQueue* m_queue;                         //! Queue shared with other asynchronous connections.
         std::unique_ptr<DatabaseWorker> m_worker;           //! Core worker task.
         MySQLHandle*          m_Mysql;                      //! MySQL Handle.
         MySQLConnectionInfo&  m_connectionInfo;             //! Connection info (used for logging)
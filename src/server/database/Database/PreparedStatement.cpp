@@ -228,3 +228,8 @@ bool PreparedStatementTask::Execute()
 
     return m_conn->Execute(m_stmt);
 }
+
+bool PreparedStatementTask::ExecuteInGroupCommit()
+{
+    return m_conn->Execute(m_stmt);
+}
@@ -141,6 +141,8 @@ class TC_DATABASE_API PreparedStatementTask : public SQLOperation
         ~PreparedStatementTask();
 
         bool Execute() override;
+        bool CanGroupCommit() const override { return !m_has_result; }
+        bool ExecuteInGroupCommit() override;
         PreparedQueryResultFuture GetFuture() { return m_result->get_future(); }
 
     protected:
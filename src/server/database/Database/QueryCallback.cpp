@@ -59,51 +59,6 @@ inline void MoveFrom(T* to, T&& from)
         to->_prepared = std::move(from._prepared);
 }
 
-struct QueryCallback::QueryCallbackData
-{
-public:
-    friend class QueryCallback;
-
-    QueryCallbackData(std::function<void(QueryCallback&, QueryResult)>&& callback) : _string(std::move(callback)), _isPrepared(false) { }
-    QueryCallbackData(std::function<void(QueryCallback&, PreparedQueryResult)>&& callback) : _prepared(std::move(callback)), _isPrepared(true) { }
-    QueryCallbackData(QueryCallbackData&& right)
-    {
-        _isPrepared = right._isPrepared;
-        ConstructActiveMember(this);
-        MoveFrom(this, std::move(right));
-    }
-    QueryCallbackData& operator=(QueryCallbackData&& right)
-    {
-        if (this != &right)
-        {
-            if (_isPrepared != right._isPrepared)
-            {
-                DestroyActiveMember(this);
-                _isPrepared = right._isPrepared;
-                ConstructActiveMember(this);
-            }
-            MoveFrom(this, std::move(right));
-        }
-        return *this;
-    }
-    ~QueryCallbackData() { DestroyActiveMember(this); }
-
-private:
-    QueryCallbackData(QueryCallbackData const&) = delete;
-    QueryCallbackData& operator=(QueryCallbackData const&) = delete;
-
-    template<typename T> friend void ConstructActiveMember(T* obj);
-    template<typename T> friend void DestroyActiveMember(T* obj);
-    template<typename T> friend void MoveFrom(T* to, T&& from);
-
-    union
-    {
-        std::function<void(QueryCallback&, QueryResult)> _string;
-        std::function<void(QueryCallback&, PreparedQueryResult)> _prepared;
-    };
-    bool _isPrepared;
-};
-
 // Not using initialization lists to work around segmentation faults when compiling with clang without precompiled headers
 QueryCallback::QueryCallback(std::future<QueryResult>&& result)
 {
@@ -146,27 +101,11 @@ QueryCallback::~QueryCallback()
     DestroyActiveMember(this);
 }
 
-QueryCallback&& QueryCallback::WithCallback(std::function<void(QueryResult)>&& callback)
-{
-    return WithChainingCallback([callback](QueryCallback& /*this*/, QueryResult result) { callback(std::move(result)); });
-}
-
-QueryCallback&& QueryCallback::WithPreparedCallback(std::function<void(PreparedQueryResult)>&& callback)
-{
-    return WithChainingPreparedCallback([callback](QueryCallback& /*this*/, PreparedQueryResult result) { callback(std::move(result)); });
-}
-
-QueryCallback&& QueryCallback::WithChainingCallback(std::function<void(QueryCallback&, QueryResult)>&& callback)
-{
-    ASSERT(!_callbacks.empty() || !_isPrepared, "Attempted to set callback function for string query on a prepared async query");
-    _callbacks.emplace(std::move(callback));
-    return std::move(*this);
-}
-
-QueryCallback&& QueryCallback::WithChainingPreparedCallback(std::function<void(QueryCallback&, PreparedQueryResult)>&& callback)
+QueryCallback&& QueryCallback::AddCallback(QueryCallbackData&& callback)
 {
-    ASSERT(!_callbacks.empty() || _isPrepared, "Attempted to set callback function for prepared query on a string async query");
-    _callbacks.emplace(std::move(callback));
+    ASSERT(!_callbacks.empty() || _isPrepared == callback.IsPrepared(), "Attempted to set callback function for %s query on a %s async query",
+        callback.IsPrepared() ? "prepared" : "string", _isPrepared ? "prepared" : "string");
+    _callbacks.push_back(std::move(callback));
     return std::move(*this);
 }
 
@@ -177,10 +116,9 @@ void QueryCallback::SetNextQuery(QueryCallback&& next)
 
 bool QueryCallback::InvokeIfReady()
 {
-    QueryCallbackData& callback = _callbacks.front();
     auto checkStateAndReturnCompletion = [this]()
     {
-        _callbacks.pop();
+        _callbacks.erase(_callbacks.begin());
         bool hasNext = !_isPrepared ? _string.valid() : _prepared.valid();
         if (_callbacks.empty())
         {
@@ -192,7 +130,7 @@ bool QueryCallback::InvokeIfReady()
         if (!hasNext)
             return true;
 
-        ASSERT(_isPrepared == _callbacks.front()._isPrepared);
+        ASSERT(_isPrepared == _callbacks.front().IsPrepared());
         return false;
     };
 
@@ -201,8 +139,9 @@ bool QueryCallback::InvokeIfReady()
         if (_string.valid() && _string.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
         {
             QueryResultFuture f(std::move(_string));
-            std::function<void(QueryCallback&, QueryResult)> cb(std::move(callback._string));
-            cb(*this, f.get());
+            QueryCallbackData cb(std::move(_callbacks.front()));
+            QueryResult result = f.get();
+            cb.Invoke(*this, &result);
             return checkStateAndReturnCompletion();
         }
     }
@@ -211,8 +150,9 @@ bool QueryCallback::InvokeIfReady()
         if (_prepared.valid() && _prepared.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
         {
             PreparedQueryResultFuture f(std::move(_prepared));
-            std::function<void(QueryCallback&, PreparedQueryResult)> cb(std::move(callback._prepared));
-            cb(*this, f.get());
+            QueryCallbackData cb(std::move(_callbacks.front()));
+            PreparedQueryResult result = f.get();
+            cb.Invoke(*this, &result);
             return checkStateAndReturnCompletion();
         }
     }
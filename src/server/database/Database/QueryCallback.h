@@ -14,16 +14,16 @@
  * You should have received a copy of the GNU General Public License along
  * with this program. If not, see <http://www.gnu.org/licenses/>.
  */
-
 #ifndef _QUERY_CALLBACK_H
 #define _QUERY_CALLBACK_H
 
 #include "Define.h"
 #include "DatabaseEnvFwd.h"
-#include <functional>
+#include <boost/container/small_vector.hpp>
+#include <cstddef>
 #include <future>
-#include <list>
-#include <queue>
+#include <new>
+#include <type_traits>
 #include <utility>
 
 class TC_DATABASE_API QueryCallback
@@ -35,11 +35,29 @@ public:
     QueryCallback& operator=(QueryCallback&& right);
     ~QueryCallback();
 
-    QueryCallback&& WithCallback(std::function<void(QueryResult)>&& callback);
-    QueryCallback&& WithPreparedCallback(std::function<void(PreparedQueryResult)>&& callback);
+    template<typename Callback>
+    QueryCallback&& WithCallback(Callback&& callback)
+    {
+        return WithChainingCallback([callback = std::forward<Callback>(callback)](QueryCallback& /*this*/, QueryResult result) mutable { callback(std::move(result)); });
+    }
+
+    template<typename Callback>
+    QueryCallback&& WithPreparedCallback(Callback&& callback)
+    {
+        return WithChainingPreparedCallback([callback = std::forward<Callback>(callback)](QueryCallback& /*this*/, PreparedQueryResult result) mutable { callback(std::move(result)); });
+    }
+
+    template<typename Callback>
+    QueryCallback&& WithChainingCallback(Callback&& callback)
+    {
+        return AddCallback(QueryCallbackData(std::in_place_type<QueryResult>, std::forward<Callback>(callback)));
+    }
 
-    QueryCallback&& WithChainingCallback(std::function<void(QueryCallback&, QueryResult)>&& callback);
-    QueryCallback&& WithChainingPreparedCallback(std::function<void(QueryCallback&, PreparedQueryResult)>&& callback);
+    template<typename Callback>
+    QueryCallback&& WithChainingPreparedCallback(Callback&& callback)
+    {
+        return AddCallback(QueryCallbackData(std::in_place_type<PreparedQueryResult>, std::forward<Callback>(callback)));
+    }
 
     // Moves std::future from next to this object
     void SetNextQuery(QueryCallback&& next);
@@ -55,6 +73,103 @@ private:
     template<typename T> friend void DestroyActiveMember(T* obj);
     template<typename T> friend void MoveFrom(T* to, T&& from);
 
+    //! Type erased continuation, stored inline unless its captures exceed InlineSize
+    class QueryCallbackData
+    {
+    public:
+        static constexpr std::size_t InlineSize = 6 * sizeof(void*);
+
+        template<typename Result, typename Callback>
+        QueryCallbackData(std::in_place_type_t<Result>, Callback&& callback) : _isPrepared(std::is_same<Result, PreparedQueryResult>::value)
+        {
+            using Stored = std::decay_t<Callback>;
+            if constexpr (IsStoredInline<Stored>())
+            {
+                new (&_storage) Stored(std::forward<Callback>(callback));
+                _ops = &InlineOps<Result, Stored>;
+            }
+            else
+            {
+                *reinterpret_cast<Stored**>(&_storage) = new Stored(std::forward<Callback>(callback));
+                _ops = &HeapOps<Result, Stored>;
+            }
+        }
+
+        QueryCallbackData(QueryCallbackData&& right) noexcept : _ops(right._ops), _isPrepared(right._isPrepared)
+        {
+            if (_ops)
+                _ops->Move(&_storage, &right._storage);
+            right._ops = nullptr;
+        }
+
+        QueryCallbackData& operator=(QueryCallbackData&& right) noexcept
+        {
+            if (this != &right)
+            {
+                Reset();
+                _ops = right._ops;
+                _isPrepared = right._isPrepared;
+                if (_ops)
+                    _ops->Move(&_storage, &right._storage);
+                right._ops = nullptr;
+            }
+            return *this;
+        }
+
+        ~QueryCallbackData() { Reset(); }
+
+        bool IsPrepared() const { return _isPrepared; }
+
+        //! result must point to a QueryResult or a PreparedQueryResult, matching IsPrepared()
+        void Invoke(QueryCallback& queryCallback, void* result) { _ops->Invoke(&_storage, queryCallback, result); }
+
+    private:
+        QueryCallbackData(QueryCallbackData const&) = delete;
+        QueryCallbackData& operator=(QueryCallbackData const&) = delete;
+
+        struct Operations
+        {
+            void(*Invoke)(void* storage, QueryCallback& queryCallback, void* result);
+            void(*Move)(void* to, void* from);        // leaves from destroyed
+            void(*Destroy)(void* storage);
+        };
+
+        template<typename Stored>
+        static constexpr bool IsStoredInline()
+        {
+            return sizeof(Stored) <= InlineSize && alignof(Stored) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible<Stored>::value;
+        }
+
+        template<typename Result, typename Stored>
+        static constexpr Operations InlineOps =
+        {
+            [](void* storage, QueryCallback& queryCallback, void* result) { (*static_cast<Stored*>(storage))(queryCallback, std::move(*static_cast<Result*>(result))); },
+            [](void* to, void* from) { new (to) Stored(std::move(*static_cast<Stored*>(from))); static_cast<Stored*>(from)->~Stored(); },
+            [](void* storage) { static_cast<Stored*>(storage)->~Stored(); }
+        };
+
+        template<typename Result, typename Stored>
+        static constexpr Operations HeapOps =
+        {
+            [](void* storage, QueryCallback& queryCallback, void* result) { (**static_cast<Stored**>(storage))(queryCallback, std::move(*static_cast<Result*>(result))); },
+            [](void* to, void* from) { *static_cast<Stored**>(to) = *static_cast<Stored**>(from); },
+            [](void* storage) { delete *static_cast<Stored**>(storage); }
+        };
+
+        void Reset()
+        {
+            if (_ops)
+                _ops->Destroy(&_storage);
+            _ops = nullptr;
+        }
+
+        alignas(std::max_align_t) unsigned char _storage[InlineSize];
+        Operations const* _ops;
+        bool _isPrepared;
+    };
+
+    QueryCallback&& AddCallback(QueryCallbackData&& callback);
+
     union
     {
         QueryResultFuture _string;
@@ -62,8 +177,8 @@ private:
     };
     bool _isPrepared;
 
-    struct QueryCallbackData;
-    std::queue<QueryCallbackData, std::list<QueryCallbackData>> _callbacks;
+    // chains rarely have more than one continuation
+    boost::container::small_vector<QueryCallbackData, 1> _callbacks;
 };
 
 #endif // _QUERY_CALLBACK_H
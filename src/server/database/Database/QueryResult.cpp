@@ -19,6 +19,7 @@
 #include "Errors.h"
 #include "Field.h"
 #include "Log.h"
+#include "MySQLConnection.h"
 #include "MySQLHacks.h"
 #include "MySQLWorkaround.h"
 #include <cstring>
@@ -165,11 +166,14 @@ void InitializeDatabaseFieldMetadata(QueryResultFieldMetadata* meta, MySQLField
 }
 }
 
-ResultSet::ResultSet(MySQLResult* result, MySQLField* fields, uint64 rowCount, uint32 fieldCount) :
+ResultSet::ResultSet(MySQLResult* result, MySQLField* fields, uint64 rowCount, uint32 fieldCount, MySQLConnection* streamConnection /*= nullptr*/) :
 _rowCount(rowCount),
 _fieldCount(fieldCount),
 _result(result),
-_fields(fields)
+_fields(fields),
+_streamConnection(streamConnection),
+_snapshotRow(nullptr),
+_snapshotRowsEnd(nullptr)
 {
     _fieldMetadata.resize(_fieldCount);
     _currentRow = new Field[_fieldCount];
@@ -180,46 +184,73 @@ _fields(fields)
     }
 }
 
+ResultSet::ResultSet(std::vector<QueryResultFieldMetadata>&& fieldMetadata, char const* snapshotRows, char const* snapshotRowsEnd, uint64 rowCount) :
+_fieldMetadata(std::move(fieldMetadata)),
+_rowCount(rowCount),
+_fieldCount(uint32(_fieldMetadata.size())),
+_result(nullptr),
+_fields(nullptr),
+_streamConnection(nullptr),
+_snapshotRow(snapshotRows),
+_snapshotRowsEnd(snapshotRowsEnd)
+{
+    _currentRow = new Field[_fieldCount];
+    for (uint32 i = 0; i < _fieldCount; i++)
+        _currentRow[i].SetMetadata(&_fieldMetadata[i]);
+}
+
 PreparedResultSet::PreparedResultSet(MySQLStmt* stmt, MySQLResult*result, uint64 rowCount, uint32 fieldCount) :
 m_rowCount(rowCount),
 m_rowPosition(0),
 m_fieldCount(fieldCount),
-m_rBind(nullptr),
+m_data(nullptr),
 m_stmt(stmt),
 m_metadataResult(result)
 {
     if (!m_metadataResult)
         return;
 
-    if (m_stmt->bind_result_done)
+    //- This is where we store the (entire) resultset
+    if (mysql_stmt_store_result(m_stmt))
     {
-        delete[] m_stmt->bind->length;
-        delete[] m_stmt->bind->is_null;
+        TC_LOG_WARN("sql.sql", "%s:mysql_stmt_store_result, cannot bind result from MySQL server. Error: %s", __FUNCTION__, mysql_stmt_error(m_stmt));
+        m_rowCount = 0;
+        return;
     }
 
-    m_rBind = new MySQLBind[m_fieldCount];
+    m_rowCount = mysql_stmt_num_rows(m_stmt);
 
-    //- for future readers wondering where the fuck this is freed - mysql_stmt_bind_result moves pointers to these
-    // from m_rBind to m_stmt->bind and it is later freed by the `if (m_stmt->bind_result_done)` block just above here
-    // MYSQL_STMT lifetime is equal to connection lifetime
-    MySQLBool* m_isNull = new MySQLBool[m_fieldCount];
-    unsigned long* m_length = new unsigned long[m_fieldCount];
+    // most lookups on the async paths come back empty, there is nothing to bind or buffer for them
+    if (!m_rowCount)
+    {
+        mysql_stmt_free_result(m_stmt);
+        return;
+    }
 
-    memset(m_isNull, 0, sizeof(MySQLBool) * m_fieldCount);
-    memset(m_rBind, 0, sizeof(MySQLBind) * m_fieldCount);
-    memset(m_length, 0, sizeof(unsigned long) * m_fieldCount);
+    // the bind array is only read until mysql_stmt_bind_result copies it into m_stmt->bind, keep one per thread
+    static thread_local std::vector<MySQLBind> resultBind;
+    resultBind.assign(m_fieldCount, MySQLBind());
+    MySQLBind* rBind = resultBind.data();
 
-    //- This is where we store the (entire) resultset
-    if (mysql_stmt_store_result(m_stmt))
+    //- for future readers wondering where the fuck this is freed - mysql_stmt_bind_result moves pointers to these
+    // from rBind to m_stmt->bind and they are freed in ~MySQLPreparedStatement
+    // MYSQL_STMT lifetime is equal to connection lifetime and the field count of a statement never changes,
+    // so once bound the arrays are reused by every following execution
+    MySQLBool* isNull;
+    unsigned long* length;
+    if (m_stmt->bind_result_done)
     {
-        TC_LOG_WARN("sql.sql", "%s:mysql_stmt_store_result, cannot bind result from MySQL server. Error: %s", __FUNCTION__, mysql_stmt_error(m_stmt));
-        delete[] m_rBind;
-        delete[] m_isNull;
-        delete[] m_length;
-        return;
+        isNull = m_stmt->bind->is_null;
+        length = m_stmt->bind->length;
+    }
+    else
+    {
+        isNull = new MySQLBool[m_fieldCount];
+        length = new unsigned long[m_fieldCount];
     }
 
-    m_rowCount = mysql_stmt_num_rows(m_stmt);
+    memset(isNull, 0, sizeof(MySQLBool) * m_fieldCount);
+    memset(length, 0, sizeof(unsigned long) * m_fieldCount);
 
     //- This is where we prepare the buffer based on metadata
     MySQLField* field = reinterpret_cast<MySQLField*>(mysql_fetch_fields(m_metadataResult));
@@ -232,29 +263,32 @@ m_metadataResult(result)
 
         InitializeDatabaseFieldMetadata(&m_fieldMetadata[i], &field[i], i);
 
-        m_rBind[i].buffer_type = field[i].type;
-        m_rBind[i].buffer_length = size;
-        m_rBind[i].length = &m_length[i];
-        m_rBind[i].is_null = &m_isNull[i];
-        m_rBind[i].error = nullptr;
-        m_rBind[i].is_unsigned = field[i].flags & UNSIGNED_FLAG;
+        rBind[i].buffer_type = field[i].type;
+        rBind[i].buffer_length = size;
+        rBind[i].length = &length[i];
+        rBind[i].is_null = &isNull[i];
+        rBind[i].error = nullptr;
+        rBind[i].is_unsigned = field[i].flags & UNSIGNED_FLAG;
     }
 
-    char* dataBuffer = new char[rowSize * m_rowCount];
+    m_data = new char[rowSize * m_rowCount];
     for (uint32 i = 0, offset = 0; i < m_fieldCount; ++i)
     {
-        m_rBind[i].buffer = dataBuffer + offset;
-        offset += m_rBind[i].buffer_length;
+        rBind[i].buffer = m_data + offset;
+        offset += rBind[i].buffer_length;
     }
 
     //- This is where we bind the bind the buffer to the statement
-    if (mysql_stmt_bind_result(m_stmt, m_rBind))
+    if (mysql_stmt_bind_result(m_stmt, rBind))
     {
         TC_LOG_WARN("sql.sql", "%s:mysql_stmt_bind_result, cannot bind result from MySQL server. Error: %s", __FUNCTION__, mysql_stmt_error(m_stmt));
         mysql_stmt_free_result(m_stmt);
-        CleanUp();
-        delete[] m_isNull;
-        delete[] m_length;
+        if (!m_stmt->bind_result_done)
+        {
+            delete[] isNull;
+            delete[] length;
+        }
+        m_rowCount = 0;
         return;
     }
 
@@ -265,12 +299,12 @@ m_metadataResult(result)
         {
             m_rows[uint32(m_rowPosition) * m_fieldCount + fIndex].SetMetadata(&m_fieldMetadata[fIndex]);
 
-            unsigned long buffer_length = m_rBind[fIndex].buffer_length;
-            unsigned long fetched_length = *m_rBind[fIndex].length;
-            if (!*m_rBind[fIndex].is_null)
+            unsigned long buffer_length = rBind[fIndex].buffer_length;
+            unsigned long fetched_length = length[fIndex];
+            if (!isNull[fIndex])
             {
                 void* buffer = m_stmt->bind[fIndex].buffer;
-                switch (m_rBind[fIndex].buffer_type)
+                switch (rBind[fIndex].buffer_type)
                 {
                     case MYSQL_TYPE_TINY_BLOB:
                     case MYSQL_TYPE_MEDIUM_BLOB:
@@ -301,7 +335,7 @@ m_metadataResult(result)
             {
                 m_rows[uint32(m_rowPosition) * m_fieldCount + fIndex].SetByteValue(
                     nullptr,
-                    *m_rBind[fIndex].length);
+                    length[fIndex]);
             }
         }
         m_rowPosition++;
@@ -326,16 +360,25 @@ bool ResultSet::NextRow()
 {
     MYSQL_ROW row;
 
+    if (_snapshotRow)
+        return NextSnapshotRow();
+
     if (!_result)
         return false;
 
     row = mysql_fetch_row(_result);
     if (!row)
     {
+        if (_streamConnection && mysql_errno(_result->handle))
+            TC_LOG_ERROR("sql.sql", "%s:mysql_fetch_row, streamed result ended after " UI64FMTD " rows. Error %s.", __FUNCTION__, _rowCount, mysql_error(_result->handle));
+
         CleanUp();
         return false;
     }
 
+    if (_streamConnection)
+        ++_rowCount;
+
     unsigned long* lengths = mysql_fetch_lengths(_result);
     if (!lengths)
     {
@@ -350,6 +393,34 @@ bool ResultSet::NextRow()
     return true;
 }
 
+bool ResultSet::NextSnapshotRow()
+{
+    if (_snapshotRow == _snapshotRowsEnd)
+    {
+        _snapshotRow = nullptr;
+        CleanUp();
+        return false;
+    }
+
+    // layout was validated when the snapshot was loaded, see QueryResultSnapshot.cpp
+    for (uint32 i = 0; i < _fieldCount; i++)
+    {
+        uint32 length;
+        memcpy(&length, _snapshotRow, sizeof(length));
+        _snapshotRow += sizeof(length);
+
+        if (length == 0xFFFFFFFF)
+            _currentRow[i].SetStructuredValue(nullptr, 0);
+        else
+        {
+            _currentRow[i].SetStructuredValue(_snapshotRow, length);
+            _snapshotRow += length + 1;
+        }
+    }
+
+    return true;
+}
+
 bool PreparedResultSet::NextRow()
 {
     /// Only updates the m_rowPosition so upper level code knows in which element
@@ -381,9 +452,16 @@ void ResultSet::CleanUp()
 
     if (_result)
     {
+        // for streamed results this also reads and discards rows not fetched yet
         mysql_free_result(_result);
         _result = nullptr;
     }
+
+    if (_streamConnection)
+    {
+        _streamConnection->Unlock();
+        _streamConnection = nullptr;
+    }
 }
 
 Field const& ResultSet::operator[](std::size_t index) const
@@ -416,10 +494,6 @@ void PreparedResultSet::CleanUp()
     if (m_metadataResult)
         mysql_free_result(m_metadataResult);
 
-    if (m_rBind)
-    {
-        delete[](char*)m_rBind->buffer;
-        delete[] m_rBind;
-        m_rBind = nullptr;
-    }
+    delete[] m_data;
+    m_data = nullptr;
 }
@@ -22,14 +22,20 @@
 #include "DatabaseEnvFwd.h"
 #include <vector>
 
+class MySQLConnection;
+
 class TC_DATABASE_API ResultSet
 {
     public:
-        ResultSet(MySQLResult* result, MySQLField* fields, uint64 rowCount, uint32 fieldCount);
+        ResultSet(MySQLResult* result, MySQLField* fields, uint64 rowCount, uint32 fieldCount, MySQLConnection* streamConnection = nullptr);
+        /// rows stored by QueryResultSnapshot, read in place
+        ResultSet(std::vector<QueryResultFieldMetadata>&& fieldMetadata, char const* snapshotRows, char const* snapshotRowsEnd, uint64 rowCount);
         ~ResultSet();
 
         bool NextRow();
+        /// for streamed results only the number of rows fetched so far
         uint64 GetRowCount() const { return _rowCount; }
+        bool IsStreamed() const { return _streamConnection != nullptr; }
         uint32 GetFieldCount() const { return _fieldCount; }
 
         Field* Fetch() const { return _currentRow; }
@@ -45,8 +51,12 @@ class TC_DATABASE_API ResultSet
 
     private:
         void CleanUp();
+        bool NextSnapshotRow();
         MySQLResult* _result;
         MySQLField* _fields;
+        MySQLConnection* _streamConnection;     // locked until all rows are fetched or the result is destroyed
+        char const* _snapshotRow;
+        char const* _snapshotRowsEnd;
 
         ResultSet(ResultSet const& right) = delete;
         ResultSet& operator=(ResultSet const& right) = delete;
@@ -73,7 +83,7 @@ class TC_DATABASE_API PreparedResultSet
         uint32 m_fieldCount;
 
     private:
-        MySQLBind* m_rBind;
+        char* m_data;                     ///< Row buffer all fields of m_rows point into
         MySQLStmt* m_stmt;
         MySQLResult* m_metadataResult;    ///< Field metadata, returned by mysql_stmt_result_metadata
 
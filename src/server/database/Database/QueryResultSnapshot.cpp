@@ -0,0 +1,431 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "QueryResultSnapshot.h"
+#include "Field.h"
+#include "Log.h"
+#include "QueryResult.h"
+#include <boost/filesystem/operations.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+/*
+    File layout, all integers in native byte order:
+        char[4] magic, uint32 version, uint32 state hash length, state hash, uint32 entry count
+        entries: uint32 sql length, sql, uint64 data length, data
+
+    Entry data:
+        uint32 field count
+        fields: uint8 DatabaseFieldTypes, table name, table alias, name, alias, type name
+        uint64 row count
+        rows: for every field uint32 value length (NullValueLength for NULL) followed by the value
+
+    Strings and values are followed by a null terminator not included in their length, values are read in place
+    from the mapped file the same way as the text values of a mysql result.
+*/
+
+namespace
+{
+    char const SnapshotMagic[4] = { 'T', 'C', 'Q', 'S' };
+    uint32 const SnapshotVersion = 1;
+    uint32 const NullValueLength = 0xFFFFFFFF;
+
+    class SnapshotReader
+    {
+    public:
+        explicit SnapshotReader(std::string_view data) : _data(data) { }
+
+        template<typename T>
+        bool Read(T& value)
+        {
+            if (_data.size() < sizeof(T))
+                return false;
+
+            memcpy(&value, _data.data(), sizeof(T));
+            _data.remove_prefix(sizeof(T));
+            return true;
+        }
+
+        bool ReadBytes(std::string_view& value, std::size_t length)
+        {
+            if (_data.size() < length)
+                return false;
+
+            value = _data.substr(0, length);
+            _data.remove_prefix(length);
+            return true;
+        }
+
+        bool ReadString(char const*& value)
+        {
+            uint32 length = 0;
+            std::string_view bytes;
+            if (!Read(length) || length == NullValueLength || !ReadBytes(bytes, std::size_t(length) + 1) || bytes.back() != '\0')
+                return false;
+
+            value = bytes.data();
+            return true;
+        }
+
+        bool ReadMetadata(std::vector<QueryResultFieldMetadata>& metadata, uint64& rowCount)
+        {
+            uint32 fieldCount = 0;
+            if (!Read(fieldCount) || fieldCount > _data.size())
+                return false;
+
+            metadata.resize(fieldCount);
+            for (uint32 i = 0; i < fieldCount; ++i)
+            {
+                uint8 type = 0;
+                if (!Read(type) || type > uint8(DatabaseFieldTypes::Binary))
+                    return false;
+
+                QueryResultFieldMetadata& meta = metadata[i];
+                meta.Index = i;
+                meta.Type = DatabaseFieldTypes(type);
+                if (!ReadString(meta.TableName) || !ReadString(meta.TableAlias) || !ReadString(meta.Name)
+                    || !ReadString(meta.Alias) || !ReadString(meta.TypeName))
+                    return false;
+            }
+
+            return Read(rowCount);
+        }
+
+        std::string_view GetRemaining() const { return _data; }
+
+    private:
+        std::string_view _data;
+    };
+
+    template<typename T>
+    void Append(std::string& data, T value)
+    {
+        data.append(reinterpret_cast<char const*>(&value), sizeof(T));
+    }
+
+    void AppendValue(std::string& data, char const* value, std::size_t length)
+    {
+        Append(data, uint32(length));
+        data.append(value, length);
+        data.push_back('\0');
+    }
+
+    void AppendString(std::string& data, char const* value)
+    {
+        if (!value)
+            value = "";
+
+        AppendValue(data, value, strlen(value));
+    }
+}
+
+QueryResultSnapshot::QueryResultSnapshot(std::string path, std::string stateHash) : _path(std::move(path)), _stateHash(std::move(stateHash)),
+    _open(false), _invalidated(false), _modifiedWhileOpen(false)
+{
+}
+
+QueryResultSnapshot::~QueryResultSnapshot() = default;
+
+void QueryResultSnapshot::Load()
+{
+    _open = true;
+
+    boost::system::error_code error;
+    if (!boost::filesystem::exists(_path, error))
+    {
+        TC_LOG_INFO("sql.sql", "Query snapshot %s does not exist yet, it is written once loading is done.", _path.c_str());
+        return;
+    }
+
+    try
+    {
+        _file = std::make_unique<boost::interprocess::file_mapping>(_path.c_str(), boost::interprocess::read_only);
+        _region = std::make_unique<boost::interprocess::mapped_region>(*_file, boost::interprocess::read_only);
+    }
+    catch (boost::interprocess::interprocess_exception const& e)
+    {
+        TC_LOG_ERROR("sql.sql", "Query snapshot %s could not be mapped (%s), it is written again once loading is done.", _path.c_str(), e.what());
+        _region.reset();
+        _file.reset();
+        return;
+    }
+
+    SnapshotReader reader(std::string_view(static_cast<char const*>(_region->get_address()), _region->get_size()));
+    std::string_view magic, stateHash;
+    uint32 version = 0, stateHashLength = 0, entryCount = 0;
+    if (!reader.ReadBytes(magic, sizeof(SnapshotMagic)) || memcmp(magic.data(), SnapshotMagic, sizeof(SnapshotMagic)) != 0
+        || !reader.Read(version) || version != SnapshotVersion
+        || !reader.Read(stateHashLength) || !reader.ReadBytes(stateHash, stateHashLength) || !reader.Read(entryCount))
+    {
+        TC_LOG_ERROR("sql.sql", "Query snapshot %s has an unknown format, it is written again once loading is done.", _path.c_str());
+        _region.reset();
+        _file.reset();
+        return;
+    }
+
+    if (stateHash != _stateHash)
+    {
+        TC_LOG_INFO("sql.sql", "Query snapshot %s was written for another database state, it is written again once loading is done.", _path.c_str());
+        _region.reset();
+        _file.reset();
+        return;
+    }
+
+    for (uint32 i = 0; i < entryCount; ++i)
+    {
+        uint32 sqlLength = 0;
+        uint64 dataLength = 0;
+        std::string_view sql, data;
+        if (!reader.Read(sqlLength) || !reader.ReadBytes(sql, sqlLength) || !reader.Read(dataLength) || !reader.ReadBytes(data, dataLength)
+            || !IsValidEntry(data))
+        {
+            TC_LOG_ERROR("sql.sql", "Query snapshot %s is damaged, it is written again once loading is done.", _path.c_str());
+            _mapped.clear();
+            _region.reset();
+            _file.reset();
+            return;
+        }
+
+        _mapped[sql] = data;
+    }
+
+    TC_LOG_INFO("sql.sql", "Loaded query snapshot %s with " SZFMTD " results.", _path.c_str(), _mapped.size());
+}
+
+bool QueryResultSnapshot::IsValidEntry(std::string_view data)
+{
+    SnapshotReader reader(data);
+    std::vector<QueryResultFieldMetadata> metadata;
+    uint64 rowCount = 0;
+    if (!reader.ReadMetadata(metadata, rowCount))
+        return false;
+
+    for (uint64 row = 0; row < rowCount; ++row)
+    {
+        for (std::size_t i = 0; i < metadata.size(); ++i)
+        {
+            uint32 length = 0;
+            std::string_view value;
+            if (!reader.Read(length))
+                return false;
+
+            if (length != NullValueLength && (!reader.ReadBytes(value, std::size_t(length) + 1) || value.back() != '\0'))
+                return false;
+        }
+    }
+
+    return reader.GetRemaining().empty();
+}
+
+ResultSet* QueryResultSnapshot::CreateResultSet(std::string_view data)
+{
+    SnapshotReader reader(data);
+    std::vector<QueryResultFieldMetadata> metadata;
+    uint64 rowCount = 0;
+    reader.ReadMetadata(metadata, rowCount);
+
+    std::string_view rows = reader.GetRemaining();
+    return new ResultSet(std::move(metadata), rows.data(), rows.data() + rows.size(), rowCount);
+}
+
+ResultSet* QueryResultSnapshot::Find(std::string_view sql)
+{
+    if (!_open)
+        return nullptr;
+
+    std::lock_guard<std::mutex> lock(_lock);
+
+    // results stored before a write may not match the database anymore
+    if (_modifiedWhileOpen)
+        return nullptr;
+
+    auto itr = _mapped.find(sql);
+    if (itr != _mapped.end())
+    {
+        _used.insert(itr->first);
+        return CreateResultSet(itr->second);
+    }
+
+    auto recorded = _recorded.find(std::string(sql));
+    if (recorded != _recorded.end())
+        return CreateResultSet(*recorded->second);
+
+    return nullptr;
+}
+
+ResultSet* QueryResultSnapshot::Record(std::string_view sql, ResultSet* result)
+{
+    {
+        // the snapshot is discarded by Close, keep the result as it is
+        std::lock_guard<std::mutex> lock(_lock);
+        if (_modifiedWhileOpen)
+            return result;
+    }
+
+    std::unique_ptr<std::string> data = std::make_unique<std::string>();
+
+    // metadata points into the mysql result which is freed after the last row
+    uint32 fieldCount = result->GetFieldCount();
+    Append(*data, fieldCount);
+    for (uint32 i = 0; i < fieldCount; ++i)
+    {
+        QueryResultFieldMetadata const& meta = result->GetFieldMetadata(i);
+        Append(*data, uint8(meta.Type));
+        AppendString(*data, meta.TableName);
+        AppendString(*data, meta.TableAlias);
+        AppendString(*data, meta.Name);
+        AppendString(*data, meta.Alias);
+        AppendString(*data, meta.TypeName);
+    }
+
+    std::size_t rowCountOffset = data->size();
+    uint64 rowCount = 0;
+    Append(*data, rowCount);
+    while (result->NextRow())
+    {
+        Field const* fields = result->Fetch();
+        for (uint32 i = 0; i < fieldCount; ++i)
+        {
+            if (fields[i].IsNull())
+                Append(*data, NullValueLength);
+            else
+                AppendValue(*data, fields[i].data.value, fields[i].data.length);
+        }
+
+        ++rowCount;
+    }
+
+    memcpy(&(*data)[rowCountOffset], &rowCount, sizeof(rowCount));
+    delete result;
+
+    std::lock_guard<std::mutex> lock(_lock);
+    auto itr = _recorded.try_emplace(std::string(sql), std::move(data)).first;
+    return CreateResultSet(*itr->second);
+}
+
+void QueryResultSnapshot::Close()
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    if (!_open.exchange(false))
+        return;
+
+    // results stored before the write may not match the database anymore
+    if (_modifiedWhileOpen)
+    {
+        _used.clear();
+        _recorded.clear();
+        _mapped.clear();
+        _region.reset();
+        _file.reset();
+        Remove();
+        return;
+    }
+
+    if (!_recorded.empty())
+        Write();
+
+    _used.clear();
+    _recorded.clear();
+    _mapped.clear();
+    _region.reset();
+    _file.reset();
+}
+
+void QueryResultSnapshot::Write()
+{
+    std::string const tempPath = _path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            TC_LOG_ERROR("sql.sql", "Query snapshot %s could not be written.", tempPath.c_str());
+            return;
+        }
+
+        std::string header(SnapshotMagic, sizeof(SnapshotMagic));
+        Append(header, SnapshotVersion);
+        Append(header, uint32(_stateHash.size()));
+        header += _stateHash;
+        Append(header, uint32(_used.size() + _recorded.size()));
+        file.write(header.data(), header.size());
+
+        auto writeEntry = [&file](std::string_view sql, std::string_view data)
+        {
+            std::string entryHeader;
+            Append(entryHeader, uint32(sql.size()));
+            entryHeader += sql;
+            Append(entryHeader, uint64(data.size()));
+            file.write(entryHeader.data(), entryHeader.size());
+            file.write(data.data(), data.size());
+        };
+
+        for (std::string_view sql : _used)
+            writeEntry(sql, _mapped[sql]);
+
+        for (auto const& [sql, data] : _recorded)
+            writeEntry(sql, *data);
+
+        if (!file)
+        {
+            TC_LOG_ERROR("sql.sql", "Query snapshot %s could not be written.", tempPath.c_str());
+            return;
+        }
+    }
+
+    // the mapping has to be released before the file can be replaced
+    std::size_t entryCount = _used.size() + _recorded.size();
+    _used.clear();
+    _mapped.clear();
+    _region.reset();
+    _file.reset();
+
+    boost::system::error_code error;
+    boost::filesystem::rename(tempPath, _path, error);
+    if (error)
+        TC_LOG_ERROR("sql.sql", "Query snapshot %s could not be replaced: %s", _path.c_str(), error.message().c_str());
+    else
+        TC_LOG_INFO("sql.sql", "Wrote query snapshot %s with " SZFMTD " results.", _path.c_str(), entryCount);
+}
+
+void QueryResultSnapshot::Invalidate()
+{
+    if (_invalidated)
+        return;
+
+    std::lock_guard<std::mutex> lock(_lock);
+    if (_open)
+    {
+        _modifiedWhileOpen = true;
+        return;
+    }
+
+    Remove();
+}
+
+void QueryResultSnapshot::Remove()
+{
+    if (_invalidated.exchange(true))
+        return;
+
+    boost::system::error_code error;
+    if (boost::filesystem::remove(_path, error))
+        TC_LOG_INFO("sql.sql", "Removed query snapshot %s, the database was modified.", _path.c_str());
+}
@@ -0,0 +1,89 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef QueryResultSnapshot_h__
+#define QueryResultSnapshot_h__
+
+#include "Define.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
+class ResultSet;
+
+namespace boost::interprocess
+{
+    class file_mapping;
+    class mapped_region;
+}
+
+/// On-disk copy of the results of text queries, only valid for the database state it was written for
+/// Queries found in the memory mapped file are answered from it without a round trip to the server, queries
+/// missing from it are recorded and the file is rewritten when the snapshot is closed.
+/// Results returned by the snapshot must not outlive Close().
+class TC_DATABASE_API QueryResultSnapshot
+{
+public:
+    QueryResultSnapshot(std::string path, std::string stateHash);
+    ~QueryResultSnapshot();
+
+    /// Maps the file, it is ignored if it was written for another database state or is damaged
+    void Load();
+
+    bool IsOpen() const { return _open; }
+
+    /// Result of sql stored in the snapshot, nullptr if it is not part of it or the database was written to since Load
+    ResultSet* Find(std::string_view sql);
+
+    /// Stores all rows of result, which is deleted, and returns a result reading them back from the snapshot
+    /// Rows are copied one at a time, so a streamed result is never held in memory next to its copy
+    ResultSet* Record(std::string_view sql, ResultSet* result);
+
+    /// Stops answering queries, writes the file if any query was recorded and releases all stored results
+    void Close();
+
+    /// Removes the file once the database was written to, writes while the snapshot is open are applied by Close()
+    void Invalidate();
+
+private:
+    static ResultSet* CreateResultSet(std::string_view data);
+    static bool IsValidEntry(std::string_view data);
+
+    void Write();
+    void Remove();
+
+    std::string _path;
+    std::string _stateHash;
+    std::atomic<bool> _open;
+    std::atomic<bool> _invalidated;
+
+    std::unique_ptr<boost::interprocess::file_mapping> _file;
+    std::unique_ptr<boost::interprocess::mapped_region> _region;
+    std::unordered_map<std::string_view, std::string_view> _mapped;     // sql -> entry, pointing into _region
+
+    std::mutex _lock;
+    bool _modifiedWhileOpen;                                            // the file is removed instead of written by Close
+    std::unordered_set<std::string_view> _used;                         // mapped entries queried since Load
+    std::unordered_map<std::string, std::unique_ptr<std::string>> _recorded;
+};
+
+#endif // QueryResultSnapshot_h__
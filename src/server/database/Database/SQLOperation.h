@@ -58,6 +58,11 @@ class TC_DATABASE_API SQLOperation
         virtual bool Execute() = 0;
         virtual void SetConnection(MySQLConnection* con) { m_conn = con; }
 
+        //! One-way operations without a result can be committed together with others, see DatabaseWorker
+        virtual bool CanGroupCommit() const { return false; }
+        //! Executes the statements inside a transaction already started by the worker, without any retry
+        virtual bool ExecuteInGroupCommit() { return false; }
+
         MySQLConnection* m_conn;
 
     private:
@@ -111,6 +111,11 @@ int TransactionTask::TryExecute()
     return m_conn->ExecuteTransaction(m_trans);
 }
 
+bool TransactionTask::ExecuteInGroupCommit()
+{
+    return m_conn->ExecuteTransactionQueries(m_trans->m_queries);
+}
+
 void TransactionTask::CleanupOnFailure()
 {
     m_trans->Cleanup();
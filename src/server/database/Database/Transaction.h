@@ -80,8 +80,11 @@ class TC_DATABASE_API TransactionTask : public SQLOperation
         TransactionTask(std::shared_ptr<TransactionBase> trans) : m_trans(trans) { }
         ~TransactionTask() { }
 
+        bool CanGroupCommit() const override { return true; }
+
     protected:
         bool Execute() override;
+        bool ExecuteInGroupCommit() override;
         int TryExecute();
         void CleanupOnFailure();
 
@@ -95,6 +98,7 @@ public:
     TransactionWithResultTask(std::shared_ptr<TransactionBase> trans) : TransactionTask(trans) { }
 
     TransactionFuture GetFuture() { return m_result.get_future(); }
+    bool CanGroupCommit() const override { return false; }
 
 protected:
     bool Execute() override;
@@ -18,6 +18,7 @@
 #include "DBUpdater.h"
 #include "BuiltInConfig.h"
 #include "Config.h"
+#include "CryptoHash.h"
 #include "DatabaseEnv.h"
 #include "DatabaseLoader.h"
 #include "GitRevision.h"
@@ -25,9 +26,11 @@
 #include "QueryResult.h"
 #include "StartProcess.h"
 #include "UpdateFetcher.h"
+#include "Util.h"
 #include <boost/filesystem/operations.hpp>
 #include <fstream>
 #include <iostream>
+#include <iterator>
 
 std::string DBUpdaterUtil::GetCorrectedMySQLExecutable()
 {
@@ -64,6 +67,30 @@ std::string& DBUpdaterUtil::corrected_path()
     return path;
 }
 
+// Whether a line of the script starts with DELIMITER
+static bool UsesClientCommands(std::string const& script)
+{
+    static char const Command[] = "DELIMITER";
+
+    for (size_t lineStart = 0; lineStart < script.length();)
+    {
+        size_t pos = script.find_first_not_of(" \t", lineStart);
+        if (pos == std::string::npos)
+            break;
+
+        if (StringEqualI(std::string_view(script).substr(pos, sizeof(Command) - 1), Command))
+            return true;
+
+        lineStart = script.find('\n', pos);
+        if (lineStart == std::string::npos)
+            break;
+
+        ++lineStart;
+    }
+
+    return false;
+}
+
 // Auth Database
 template<>
 std::string DBUpdater<LoginDatabaseConnection>::GetConfigEntry()
@@ -237,7 +264,8 @@ bool DBUpdater<T>::Create(DatabaseWorkerPool<T>& pool)
 template<class T>
 bool DBUpdater<T>::Update(DatabaseWorkerPool<T>& pool)
 {
-    if (!DBUpdaterUtil::CheckExecutable())
+    bool const applyInProcess = sConfigMgr->GetBoolDefault("Updates.ApplyInProcess", false);
+    if (!applyInProcess && !DBUpdaterUtil::CheckExecutable())
         return false;
 
     TC_LOG_INFO("sql.updates", "Updating %s database...", DBUpdater<T>::GetTableName().c_str());
@@ -251,8 +279,15 @@ bool DBUpdater<T>::Update(DatabaseWorkerPool<T>& pool)
     }
 
     UpdateFetcher updateFetcher(sourceDirectory, [&](std::string const& query) { DBUpdater<T>::Apply(pool, query); },
-        [&](Path const& file) { DBUpdater<T>::ApplyFile(pool, file); },
-            [&](std::string const& query) -> QueryResult { return DBUpdater<T>::Retrieve(pool, query); });
+        [&](Path const& file)
+        {
+            if (applyInProcess)
+                DBUpdater<T>::ApplyFileInProcess(pool, file);
+            else
+                DBUpdater<T>::ApplyFile(pool, file);
+        },
+        [&](std::string const& query) -> QueryResult { return DBUpdater<T>::Retrieve(pool, query); },
+        sConfigMgr->GetStringDefault("Updates.HashCache", "update_hashes.cache"));
 
     UpdateResult result;
     try
@@ -339,6 +374,26 @@ bool DBUpdater<T>::Populate(DatabaseWorkerPool<T>& pool)
     return true;
 }
 
+template<class T>
+std::string DBUpdater<T>::GetStateHash(DatabaseWorkerPool<T>& pool)
+{
+    QueryResult const result = Retrieve(pool, "SELECT `name`, `hash` FROM `updates` ORDER BY `name`");
+    if (!result)
+        return "";
+
+    Trinity::Crypto::SHA1 sha;
+    do
+    {
+        Field* fields = result->Fetch();
+        sha.UpdateData(fields[0].GetString());
+        sha.UpdateData(fields[1].GetString());
+    }
+    while (result->NextRow());
+
+    sha.Finalize();
+    return ByteArrayToHexStr(sha.GetDigest());
+}
+
 template<class T>
 QueryResult DBUpdater<T>::Retrieve(DatabaseWorkerPool<T>& pool, std::string const& query)
 {
@@ -358,6 +413,41 @@ void DBUpdater<T>::ApplyFile(DatabaseWorkerPool<T>& pool, Path const& path)
         pool.GetConnectionInfo()->port_or_socket, pool.GetConnectionInfo()->database, path);
 }
 
+template<class T>
+void DBUpdater<T>::ApplyFileInProcess(DatabaseWorkerPool<T>& pool, Path const& path)
+{
+    std::ifstream in(path.c_str(), std::ios::binary);
+    if (!in.is_open())
+    {
+        TC_LOG_FATAL("sql.updates", "Failed to open the sql update \"%s\" for reading!", path.generic_string().c_str());
+        throw UpdateException("Opening the sql update failed!");
+    }
+
+    std::string const script{ std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+    in.close();
+
+    // DELIMITER only exists in the mysql CLI, the server can't split statements containing ';' (triggers, procedures) without it
+    if (UsesClientCommands(script))
+    {
+        TC_LOG_DEBUG("sql.updates", ">> \"%s\" uses mysql client commands, applying it with the mysql CLI.", path.filename().generic_string().c_str());
+
+        if (!DBUpdaterUtil::CheckExecutable())
+            throw UpdateException("update failed");
+
+        ApplyFile(pool, path);
+        return;
+    }
+
+    if (!pool.DirectExecuteMultiStatement(script))
+    {
+        TC_LOG_FATAL("sql.updates", "Applying of file \'%s\' to database \'%s\' failed!" \
+           " If you are a user, pull the latest revision from the repository. If you are a developer, fix your sql query.",
+            path.generic_string().c_str(), pool.GetConnectionInfo()->database.c_str());
+
+        throw UpdateException("update failed");
+    }
+}
+
 template<class T>
 void DBUpdater<T>::ApplyFile(DatabaseWorkerPool<T>& pool, std::string const& host, std::string const& user,
     std::string const& password, std::string const& port_or_socket, std::string const& database, Path const& path)
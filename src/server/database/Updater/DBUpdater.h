@@ -84,10 +84,15 @@ public:
 
     static bool Populate(DatabaseWorkerPool<T>& pool);
 
+    /// Hash of all applied updates, empty if the updates table could not be read
+    static std::string GetStateHash(DatabaseWorkerPool<T>& pool);
+
 private:
     static QueryResult Retrieve(DatabaseWorkerPool<T>& pool, std::string const& query);
     static void Apply(DatabaseWorkerPool<T>& pool, std::string const& query);
     static void ApplyFile(DatabaseWorkerPool<T>& pool, Path const& path);
+    //! Applies the file over a connection of the pool instead of the mysql CLI, unless it uses client commands
+    static void ApplyFileInProcess(DatabaseWorkerPool<T>& pool, Path const& path);
     static void ApplyFile(DatabaseWorkerPool<T>& pool, std::string const& host, std::string const& user,
         std::string const& password, std::string const& port_or_socket, std::string const& database, Path const& path);
 };
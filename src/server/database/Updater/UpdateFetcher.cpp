@@ -23,9 +23,12 @@
 #include "Field.h"
 #include "Log.h"
 #include "QueryResult.h"
+#include "Timer.h"
 #include "Util.h"
 #include <boost/filesystem/directory.hpp>
 #include <boost/filesystem/operations.hpp>
+#include <algorithm>
+#include <filesystem>
 #include <fstream>
 #include <sstream>
 
@@ -42,9 +45,10 @@ struct UpdateFetcher::DirectoryEntry
 UpdateFetcher::UpdateFetcher(Path const& sourceDirectory,
     std::function<void(std::string const&)> const& apply,
     std::function<void(Path const& path)> const& applyFile,
-    std::function<QueryResult(std::string const&)> const& retrieve) :
+    std::function<QueryResult(std::string const&)> const& retrieve,
+    std::string const& hashCacheFile) :
         _sourceDirectory(Trinity::make_unique<Path>(sourceDirectory)), _apply(apply), _applyFile(applyFile),
-        _retrieve(retrieve)
+        _retrieve(retrieve), _hashCacheFile(hashCacheFile)
 {
 }
 
@@ -174,13 +178,98 @@ std::string UpdateFetcher::ReadSQLUpdate(boost::filesystem::path const& file) co
     return update;
 }
 
+UpdateFetcher::HashCacheStorage UpdateFetcher::LoadHashCache() const
+{
+    HashCacheStorage cache;
+    if (_hashCacheFile.empty())
+        return cache;
+
+    std::ifstream in(_hashCacheFile);
+    if (!in.is_open())
+        return cache;
+
+    // One file per line: <hash> <size> <last write time> <path>
+    std::string line;
+    while (std::getline(in, line))
+    {
+        std::istringstream stream(line);
+        HashCacheEntry entry;
+        std::string path;
+        if (!(stream >> entry.hash >> entry.size >> entry.lastWriteTime) || !std::getline(stream >> std::ws, path))
+            continue;
+
+        entry.used = false;
+        cache[path] = std::move(entry);
+    }
+
+    TC_LOG_DEBUG("sql.updates", "Loaded " SZFMTD " cached update hashes from \"%s\".", cache.size(), _hashCacheFile.c_str());
+    return cache;
+}
+
+void UpdateFetcher::SaveHashCache(HashCacheStorage const& cache) const
+{
+    if (_hashCacheFile.empty())
+        return;
+
+    std::ofstream out(_hashCacheFile, std::ios::trunc);
+    if (!out.is_open())
+    {
+        TC_LOG_WARN("sql.updates", "Failed to write the update hash cache \"%s\", updates will be hashed again on the next start.",
+            _hashCacheFile.c_str());
+        return;
+    }
+
+    for (auto const& entry : cache)
+    {
+        // The cache is shared by the updaters of all databases, keep the entries of the others as long as their files exist
+        boost::system::error_code error;
+        if (!entry.second.used && !exists(Path(entry.first), error))
+            continue;
+
+        out << entry.second.hash << ' ' << entry.second.size << ' ' << entry.second.lastWriteTime << ' ' << entry.first << '\n';
+    }
+}
+
+std::string UpdateFetcher::GetHash(Path const& file, HashCacheStorage& cache, bool& hashed) const
+{
+    // boost only reports whole seconds, a file rewritten with the same size within the second of the
+    // cached write would keep its old hash, the file clock of the standard library is precise enough
+    std::error_code error;
+    std::filesystem::path const path(file.native());
+    uint64 const size = std::filesystem::file_size(path, error);
+    int64 const lastWriteTime = error ? 0 : int64(std::filesystem::last_write_time(path, error).time_since_epoch().count());
+    bool const cacheable = !_hashCacheFile.empty() && !error;
+
+    if (cacheable)
+    {
+        HashCacheStorage::iterator itr = cache.find(file.generic_string());
+        if (itr != cache.end() && itr->second.size == size && itr->second.lastWriteTime == lastWriteTime)
+        {
+            itr->second.used = true;
+            hashed = false;
+            return itr->second.hash;
+        }
+    }
+
+    // Calculate a Sha1 hash based on query content.
+    std::string hash = ByteArrayToHexStr(Trinity::Crypto::SHA1::GetDigestOf(ReadSQLUpdate(file)));
+    if (cacheable)
+        cache[file.generic_string()] = { hash, size, lastWriteTime, true };
+
+    hashed = true;
+    return hash;
+}
+
 UpdateResult UpdateFetcher::Update(bool const redundancyChecks,
                                    bool const allowRehash,
                                    bool const archivedRedundancy,
                                    int32 const cleanDeadReferencesMaxCount) const
 {
+    uint32 const startTime = getMSTime();
+
     LocaleFileStorage const available = GetFileList();
     AppliedFileStorage applied = ReceiveAppliedFiles();
+    HashCacheStorage hashCache = LoadHashCache();
 
     size_t countRecentUpdates = 0;
     size_t countArchivedUpdates = 0;
@@ -199,6 +288,13 @@ UpdateResult UpdateFetcher::Update(bool const redundancyChecks,
 
     size_t importedUpdates = 0;
 
+    // Timing report
+    size_t hashedFiles = 0;
+    size_t cachedHashes = 0;
+    std::chrono::steady_clock::duration hashingTime = std::chrono::steady_clock::duration::zero();
+    uint32 applyingTime = 0;
+    std::vector<std::pair<uint32, std::string>> applyTimes;
+
     for (auto const& availableQuery : available)
     {
         TC_LOG_DEBUG("sql.updates", "Checking update \"%s\"...", availableQuery.first.filename().generic_string().c_str());
@@ -223,8 +319,16 @@ UpdateResult UpdateFetcher::Update(bool const redundancyChecks,
             }
         }
 
-        // Calculate a Sha1 hash based on query content.
-        std::string const hash = ByteArrayToHexStr(Trinity::Crypto::SHA1::GetDigestOf(ReadSQLUpdate(availableQuery.first)));
+        auto const hashStartTime = std::chrono::steady_clock::now();
+        bool hashed = false;
+        std::string const hash = GetHash(availableQuery.first, hashCache, hashed);
+        if (hashed)
+        {
+            ++hashedFiles;
+            hashingTime += std::chrono::steady_clock::now() - hashStartTime;
+        }
+        else
+            ++cachedHashes;
 
         UpdateMode mode = MODE_APPLY;
 
@@ -308,6 +412,8 @@ UpdateResult UpdateFetcher::Update(bool const redundancyChecks,
         {
             case MODE_APPLY:
                 speed = Apply(availableQuery.first);
+                applyingTime += speed;
+                applyTimes.emplace_back(speed, file.name);
                 [[fallthrough]];
             case MODE_REHASH:
                 UpdateEntry(file, speed);
@@ -321,6 +427,9 @@ UpdateResult UpdateFetcher::Update(bool const redundancyChecks,
             ++importedUpdates;
     }
 
+    if (hashedFiles)
+        SaveHashCache(hashCache);
+
     // Cleanup up orphaned entries (if enabled)
     if (!applied.empty())
     {
@@ -344,6 +453,15 @@ UpdateResult UpdateFetcher::Update(bool const redundancyChecks,
         }
     }
 
+    TC_LOG_INFO("sql.updates", ">> Checked " SZFMTD " updates in %u ms: hashed " SZFMTD " in %u ms (" SZFMTD " hashes cached), applied " SZFMTD " in %u ms.",
+        available.size(), GetMSTimeDiffToNow(startTime), hashedFiles, uint32(std::chrono::duration_cast<Milliseconds>(hashingTime).count()), cachedHashes, importedUpdates, applyingTime);
+
+    // Report the slowest updates
+    size_t const slowest = std::min<size_t>(applyTimes.size(), 3);
+    std::partial_sort(applyTimes.begin(), applyTimes.begin() + slowest, applyTimes.end(), std::greater<>());
+    for (size_t i = 0; i < slowest; ++i)
+        TC_LOG_INFO("sql.updates", ">> Slowest update #" SZFMTD ": \"%s\" (%u ms).", i + 1, applyTimes[i].second.c_str(), applyTimes[i].first);
+
     return UpdateResult(importedUpdates, countRecentUpdates, countArchivedUpdates);
 }
 
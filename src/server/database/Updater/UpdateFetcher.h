@@ -54,7 +54,8 @@ public:
     UpdateFetcher(Path const& updateDirectory,
         std::function<void(std::string const&)> const& apply,
         std::function<void(Path const& path)> const& applyFile,
-        std::function<QueryResult(std::string const&)> const& retrieve);
+        std::function<QueryResult(std::string const&)> const& retrieve,
+        std::string const& hashCacheFile = "");
     ~UpdateFetcher();
 
     UpdateResult Update(bool const redundancyChecks, bool const allowRehash,
@@ -116,6 +117,18 @@ private:
     typedef std::unordered_map<std::string, AppliedFileEntry> AppliedFileStorage;
     typedef std::vector<UpdateFetcher::DirectoryEntry> DirectoryStorage;
 
+    // hash of a file as long as its size and last write time stay the same
+    struct HashCacheEntry
+    {
+        std::string hash;
+        uint64 size;
+        int64 lastWriteTime;
+        bool used;
+    };
+
+    // key is the generic path of the file
+    typedef std::unordered_map<std::string, HashCacheEntry> HashCacheStorage;
+
     LocaleFileStorage GetFileList() const;
     void FillFileListRecursively(Path const& path, LocaleFileStorage& storage,
         State const state, uint32 const depth) const;
@@ -125,6 +138,11 @@ private:
 
     std::string ReadSQLUpdate(Path const& file) const;
 
+    HashCacheStorage LoadHashCache() const;
+    void SaveHashCache(HashCacheStorage const& cache) const;
+    //! Returns the hash of the file from the cache or hashes it, sets hashed if the file had to be read
+    std::string GetHash(Path const& file, HashCacheStorage& cache, bool& hashed) const;
+
     uint32 Apply(Path const& path) const;
 
     void UpdateEntry(AppliedFileEntry const& entry, uint32 const speed = 0) const;
@@ -138,6 +156,7 @@ private:
     std::function<void(std::string const&)> const _apply;
     std::function<void(Path const& path)> const _applyFile;
     std::function<QueryResult(std::string const&)> const _retrieve;
+    std::string const _hashCacheFile;
 };
 
 #endif // UpdateFetcher_h__
@@ -103,6 +103,11 @@ void BattlefieldMgr::DestroyBattlefieldsForMap(Map const* map)
     _battlefieldsByMap.erase(map);
 }
 
+bool BattlefieldMgr::HasBattlefieldsForMap(Map const* map) const
+{
+    return _battlefieldsByMap.contains(map);
+}
+
 void BattlefieldMgr::AddZone(uint32 zoneId, Battlefield* bf)
 {
     _battlefieldsByZone[{ bf->GetMap(), zoneId }] = bf;
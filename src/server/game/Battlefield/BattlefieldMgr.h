@@ -46,6 +46,8 @@ class TC_GAME_API BattlefieldMgr
 
         void DestroyBattlefieldsForMap(Map const* map);
 
+        bool HasBattlefieldsForMap(Map const* map) const;
+
         // called when a player enters an battlefield area
         void HandlePlayerEnterZone(Player* player, uint32 zoneId);
         // called when player leaves an battlefield area
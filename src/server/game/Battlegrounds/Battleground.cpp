@@ -673,19 +673,23 @@ Position const* Battleground::GetTeamStartPosition(TeamId teamId) const
 
 void Battleground::SendPacketToAll(WorldPacket const* packet)
 {
+    LazySharedPacket sharedPacket(packet);
     for (BattlegroundPlayerMap::const_iterator itr = m_Players.begin(); itr != m_Players.end(); ++itr)
+    {
         if (Player* player = _GetPlayer(itr, "SendPacketToAll"))
-            player->SendDirectMessage(packet);
+            player->SendDirectMessage(sharedPacket.Get());
+    }
 }
 
 void Battleground::SendPacketToTeam(uint32 TeamID, WorldPacket* packet, Player* sender, bool self)
 {
+    LazySharedPacket sharedPacket(packet);
     for (BattlegroundPlayerMap::const_iterator itr = m_Players.begin(); itr != m_Players.end(); ++itr)
     {
         if (Player* player = _GetPlayerForTeam(TeamID, itr, "SendPacketToTeam"))
         {
             if (self || sender != player)
-                player->SendDirectMessage(packet);
+                player->SendDirectMessage(sharedPacket.Get());
         }
     }
 }
@@ -176,45 +176,53 @@ void DynamicObject::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player
     ByteBuffer fieldBuffer;
     UpdateMaskPacketBuilder updateMask(m_valuesCount);
 
-    uint32* flags = nullptr;
+    UpdateFieldFlagMask const* flags = nullptr;
     uint32 visibleFlag = GetUpdateFieldData(target, flags);
     ASSERT(flags);
 
-    for (uint16 index = 0; index < m_valuesCount; ++index)
+    updateMask.SelectFields(updateType == UPDATETYPE_VALUES ? &_changesMask : nullptr, m_uint32Values, *flags, visibleFlag, _fieldNotifyFlags);
+    for (uint32 index = updateMask.GetNextSetBit(0); index < m_valuesCount; index = updateMask.GetNextSetBit(index + 1))
     {
-        if (_fieldNotifyFlags & flags[index] ||
-            ((updateType == UPDATETYPE_VALUES ? _changesMask.GetBit(index) : m_uint32Values[index]) && (flags[index] & visibleFlag)))
+        if (index == DYNAMICOBJECT_BYTES)
         {
-            updateMask.SetBit(index);
-
-            if (index == DYNAMICOBJECT_BYTES)
+            if (Unit* caster = GetCaster())
             {
-                if (Unit* caster = GetCaster())
+                if (SpellInfo const* spellInfo = GetSpellInfo())
                 {
-                    if (SpellInfo const* spellInfo = GetSpellInfo())
+                    SpellVisualEntry const* rootVisual = sSpellVisualStore.LookupEntry(spellInfo->SpellVisual[0]);
+                    if (rootVisual && rootVisual->AlternativeVisualID)
                     {
-                        SpellVisualEntry const* rootVisual = sSpellVisualStore.LookupEntry(spellInfo->SpellVisual[0]);
-                        if (rootVisual && rootVisual->AlternativeVisualID)
+                        SpellVisualEntry const* alternativeVisual = sSpellVisualStore.LookupEntry(rootVisual->AlternativeVisualID);
+                        if (alternativeVisual && !caster->IsFriendlyTo(target))
                         {
-                            SpellVisualEntry const* alternativeVisual = sSpellVisualStore.LookupEntry(rootVisual->AlternativeVisualID);
-                            if (alternativeVisual && !caster->IsFriendlyTo(target))
-                            {
-                                fieldBuffer << (rootVisual->AlternativeVisualID | (DYNAMIC_OBJECT_AREA_SPELL << 28));
-                                continue;
-                            }
+                            fieldBuffer << (rootVisual->AlternativeVisualID | (DYNAMIC_OBJECT_AREA_SPELL << 28));
+                            continue;
                         }
                     }
                 }
             }
-
-            fieldBuffer << m_uint32Values[index];
         }
+
+        fieldBuffer << m_uint32Values[index];
     }
 
     updateMask.AppendToPacket(data);
     data->append(fieldBuffer);
 }
 
+bool DynamicObject::GetValuesUpdateVariant(Player* target, uint64& variant) const
+{
+    // hostile viewers may see the alternative visual in DYNAMICOBJECT_BYTES
+    variant = 0;
+    if (Unit* caster = GetCaster())
+        if (SpellInfo const* spellInfo = GetSpellInfo())
+            if (SpellVisualEntry const* rootVisual = sSpellVisualStore.LookupEntry(spellInfo->SpellVisual[0]))
+                if (rootVisual->AlternativeVisualID && sSpellVisualStore.LookupEntry(rootVisual->AlternativeVisualID) && !caster->IsFriendlyTo(target))
+                    variant = 1;
+
+    return true;
+}
+
 int32 DynamicObject::GetDuration() const
 {
     if (!_aura)
@@ -2946,73 +2946,102 @@ void GameObject::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player* t
 
     UpdateMaskPacketBuilder updateMask(m_valuesCount);
 
-    uint32* flags = GameObjectUpdateFieldFlags;
     uint32 visibleFlag = UF_FLAG_PUBLIC;
     if (GetOwnerGUID() == target->GetGUID())
         visibleFlag |= UF_FLAG_OWNER;
 
-    for (uint16 index = 0; index < m_valuesCount; ++index)
+    updateMask.SelectFields(updateType == UPDATETYPE_VALUES ? &_changesMask : nullptr, m_uint32Values, GameObjectUpdateFieldFlagMask, visibleFlag, _fieldNotifyFlags);
+    if (forcedFlags)
+        updateMask.SetBit(GAMEOBJECT_FLAGS);
+
+    for (uint32 index = updateMask.GetNextSetBit(0); index < m_valuesCount; index = updateMask.GetNextSetBit(index + 1))
     {
-        if (_fieldNotifyFlags & flags[index] ||
-            ((updateType == UPDATETYPE_VALUES ? _changesMask.GetBit(index) : m_uint32Values[index]) && (flags[index] & visibleFlag)) ||
-            (index == GAMEOBJECT_FLAGS && forcedFlags))
+        if (index == GAMEOBJECT_DYNAMIC)
         {
-            updateMask.SetBit(index);
+            uint32 dynamicFlags = m_uint32Values[GAMEOBJECT_DYNAMIC];
 
-            if (index == GAMEOBJECT_DYNAMIC)
+            uint16 dynFlags = 0;
+            uint16 pathProgress = 0xFFFF;
+            switch (GetGoType())
             {
-                uint32 dynamicFlags = m_uint32Values[GAMEOBJECT_DYNAMIC];
-
-                uint16 dynFlags = 0;
-                uint16 pathProgress = 0xFFFF;
-                switch (GetGoType())
+                case GAMEOBJECT_TYPE_QUESTGIVER:
+                    if (ActivateToQuest(target))
+                        dynFlags |= GO_DYNFLAG_LO_ACTIVATE;
+                    break;
+                case GAMEOBJECT_TYPE_CHEST:
+                case GAMEOBJECT_TYPE_GOOBER:
+                    if (ActivateToQuest(target))
+                        dynFlags |= GO_DYNFLAG_LO_ACTIVATE | GO_DYNFLAG_LO_SPARKLE;
+                    else if (targetIsGM)
+                        dynFlags |= GO_DYNFLAG_LO_ACTIVATE;
+                    break;
+                case GAMEOBJECT_TYPE_GENERIC:
+                    if (ActivateToQuest(target))
+                        dynFlags |= GO_DYNFLAG_LO_SPARKLE;
+                    break;
+                case GAMEOBJECT_TYPE_TRANSPORT:
+                case GAMEOBJECT_TYPE_MO_TRANSPORT:
                 {
-                    case GAMEOBJECT_TYPE_QUESTGIVER:
-                        if (ActivateToQuest(target))
-                            dynFlags |= GO_DYNFLAG_LO_ACTIVATE;
-                        break;
-                    case GAMEOBJECT_TYPE_CHEST:
-                    case GAMEOBJECT_TYPE_GOOBER:
-                        if (ActivateToQuest(target))
-                            dynFlags |= GO_DYNFLAG_LO_ACTIVATE | GO_DYNFLAG_LO_SPARKLE;
-                        else if (targetIsGM)
-                            dynFlags |= GO_DYNFLAG_LO_ACTIVATE;
-                        break;
-                    case GAMEOBJECT_TYPE_GENERIC:
-                        if (ActivateToQuest(target))
-                            dynFlags |= GO_DYNFLAG_LO_SPARKLE;
-                        break;
-                    case GAMEOBJECT_TYPE_TRANSPORT:
-                    case GAMEOBJECT_TYPE_MO_TRANSPORT:
-                    {
-                        dynFlags = dynamicFlags & 0xFFFF;
-                        pathProgress = dynamicFlags >> 16;
-                        break;
-                    }
-                    default:
-                        break;
+                    dynFlags = dynamicFlags & 0xFFFF;
+                    pathProgress = dynamicFlags >> 16;
+                    break;
                 }
-
-                fieldBuffer << ((uint32(pathProgress) << 16) | uint32(dynFlags));
+                default:
+                    break;
             }
-            else if (index == GAMEOBJECT_FLAGS)
-            {
-                uint32 goFlags = m_uint32Values[GAMEOBJECT_FLAGS];
-                if (GetGoType() == GAMEOBJECT_TYPE_CHEST)
-                    if (GetGOInfo()->chest.usegrouplootrules && !IsLootAllowedFor(target))
-                        goFlags |= GO_FLAG_LOCKED | GO_FLAG_NOT_SELECTABLE;
 
-                fieldBuffer << goFlags;
-            }
-            else
-                fieldBuffer << m_uint32Values[index];                // other cases
+            fieldBuffer << ((uint32(pathProgress) << 16) | uint32(dynFlags));
         }
+        else if (index == GAMEOBJECT_FLAGS)
+        {
+            uint32 goFlags = m_uint32Values[GAMEOBJECT_FLAGS];
+            if (GetGoType() == GAMEOBJECT_TYPE_CHEST)
+                if (GetGOInfo()->chest.usegrouplootrules && !IsLootAllowedFor(target))
+                    goFlags |= GO_FLAG_LOCKED | GO_FLAG_NOT_SELECTABLE;
+
+            fieldBuffer << goFlags;
+        }
+        else
+            fieldBuffer << m_uint32Values[index];                // other cases
     }
 
     updateMask.AppendToPacket(data);
     data->append(fieldBuffer);
 }
 
+bool GameObject::GetValuesUpdateVariant(Player* target, uint64& variant) const
+{
+    // same target checks as BuildValuesUpdate, only the outcome matters
+    enum
+    {
+        VARIANT_GAMEMASTER        = 0x1,
+        VARIANT_ACTIVATE_TO_QUEST = 0x2,
+        VARIANT_LOOT_ALLOWED      = 0x4
+    };
+
+    variant = 0;
+    if (target->IsGameMaster())
+        variant |= VARIANT_GAMEMASTER;
+
+    switch (GetGoType())
+    {
+        case GAMEOBJECT_TYPE_QUESTGIVER:
+        case GAMEOBJECT_TYPE_CHEST:
+        case GAMEOBJECT_TYPE_GOOBER:
+        case GAMEOBJECT_TYPE_GENERIC:
+            if (ActivateToQuest(target))
+                variant |= VARIANT_ACTIVATE_TO_QUEST;
+            break;
+        default:
+            break;
+    }
+
+    if (GetGoType() == GAMEOBJECT_TYPE_CHEST && GetGOInfo()->chest.usegrouplootrules && IsLootAllowedFor(target))
+        variant |= VARIANT_LOOT_ALLOWED;
+
+    return true;
+}
+
 std::vector<uint32> const* GameObject::GetPauseTimes() const
 {
     if (GameObjectType::Transport const* transport = dynamic_cast<GameObjectType::Transport const*>(m_goTypeImpl.get()))
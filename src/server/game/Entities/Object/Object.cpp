@@ -90,6 +90,7 @@ Object::Object()
     m_isNewObject       = false;
     m_isDestroyedObject = false;
     m_objectUpdated     = false;
+    m_updateObjectSlot  = 0;
 }
 
 WorldObject::~WorldObject()
@@ -679,19 +680,13 @@ void Object::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player* targe
     ByteBuffer fieldBuffer;
     UpdateMaskPacketBuilder updateMask(m_valuesCount);
 
-    uint32* flags = nullptr;
+    UpdateFieldFlagMask const* flags = nullptr;
     uint32 visibleFlag = GetUpdateFieldData(target, flags);
     ASSERT(flags);
 
-    for (uint16 index = 0; index < m_valuesCount; ++index)
-    {
-        if (_fieldNotifyFlags & flags[index] ||
-            ((updateType == UPDATETYPE_VALUES ? _changesMask.GetBit(index) : m_uint32Values[index]) && (flags[index] & visibleFlag)))
-        {
-            updateMask.SetBit(index);
-            fieldBuffer << m_uint32Values[index];
-        }
-    }
+    updateMask.SelectFields(updateType == UPDATETYPE_VALUES ? &_changesMask : nullptr, m_uint32Values, *flags, visibleFlag, _fieldNotifyFlags);
+    for (uint32 index = updateMask.GetNextSetBit(0); index < m_valuesCount; index = updateMask.GetNextSetBit(index + 1))
+        fieldBuffer << m_uint32Values[index];
 
     updateMask.AppendToPacket(data);
     data->append(fieldBuffer);
@@ -718,19 +713,36 @@ void Object::ClearUpdateMask(bool remove)
 
 void Object::BuildFieldsUpdate(Player* player, UpdateDataMapType& data_map) const
 {
-    UpdateDataMapType::iterator iter = data_map.find(player);
+    UpdateData& data = data_map.GetUpdateData(player, player->GetMapId());
 
-    if (iter == data_map.end())
+    uint64 variant = 0;
+    if (!GetValuesUpdateVariant(player, variant))
     {
-        std::pair<UpdateDataMapType::iterator, bool> p = data_map.emplace(player, UpdateData(player->GetMapId()));
-        ASSERT(p.second);
-        iter = p.first;
+        BuildValuesUpdateBlockForPlayer(&data, player);
+        return;
+    }
+
+    // players seeing the same fields with the same values share one serialized block
+    UpdateFieldFlagMask const* flags = nullptr;
+    uint32 visibleFlag = GetUpdateFieldData(player, flags);
+
+    std::shared_ptr<ByteBuffer const> block = data_map.GetValuesUpdateBlock(visibleFlag, variant);
+    if (!block)
+    {
+        std::shared_ptr<ByteBuffer> newBlock = std::make_shared<ByteBuffer>(500);
+        *newBlock << uint8(UPDATETYPE_VALUES);
+        *newBlock << GetPackGUID();
+
+        BuildValuesUpdate(UPDATETYPE_VALUES, newBlock.get(), player);
+
+        data_map.AddValuesUpdateBlock(visibleFlag, variant, newBlock);
+        block = std::move(newBlock);
     }
 
-    BuildValuesUpdateBlockForPlayer(&iter->second, iter->first);
+    data.AddUpdateBlock(std::move(block));
 }
 
-uint32 Object::GetUpdateFieldData(Player const* target, uint32*& flags) const
+uint32 Object::GetUpdateFieldData(Player const* target, UpdateFieldFlagMask const*& flags) const
 {
     uint32 visibleFlag = UF_FLAG_PUBLIC;
 
@@ -741,7 +753,7 @@ uint32 Object::GetUpdateFieldData(Player const* target, uint32*& flags) const
     {
         case TYPEID_ITEM:
         case TYPEID_CONTAINER:
-            flags = ItemUpdateFieldFlags;
+            flags = &ItemUpdateFieldFlagMask;
             if (((Item const*)this)->GetOwnerGUID() == target->GetGUID())
                 visibleFlag |= UF_FLAG_OWNER | UF_FLAG_ITEM_OWNER;
             break;
@@ -749,7 +761,7 @@ uint32 Object::GetUpdateFieldData(Player const* target, uint32*& flags) const
         case TYPEID_PLAYER:
         {
             Player* plr = ToUnit()->GetCharmerOrOwnerPlayerOrPlayerItself();
-            flags = UnitUpdateFieldFlags;
+            flags = &UnitUpdateFieldFlagMask;
             if (ToUnit()->GetOwnerGUID() == target->GetGUID())
                 visibleFlag |= UF_FLAG_OWNER;
 
@@ -765,22 +777,22 @@ uint32 Object::GetUpdateFieldData(Player const* target, uint32*& flags) const
             break;
         }
         case TYPEID_GAMEOBJECT:
-            flags = GameObjectUpdateFieldFlags;
+            flags = &GameObjectUpdateFieldFlagMask;
             if (ToGameObject()->GetOwnerGUID() == target->GetGUID())
                 visibleFlag |= UF_FLAG_OWNER;
             break;
         case TYPEID_DYNAMICOBJECT:
-            flags = DynamicObjectUpdateFieldFlags;
+            flags = &DynamicObjectUpdateFieldFlagMask;
             if (ToDynObject()->GetCasterGUID() == target->GetGUID())
                 visibleFlag |= UF_FLAG_OWNER;
             break;
         case TYPEID_CORPSE:
-            flags = CorpseUpdateFieldFlags;
+            flags = &CorpseUpdateFieldFlagMask;
             if (ToCorpse()->GetOwnerGUID() == target->GetGUID())
                 visibleFlag |= UF_FLAG_OWNER;
             break;
         case TYPEID_AREATRIGGER:
-            flags = AreaTriggerUpdateFieldFlags;
+            flags = &AreaTriggerUpdateFieldFlagMask;
             break;
         case TYPEID_OBJECT:
             break;
@@ -71,7 +71,8 @@ struct PositionFullTerrainStatus;
 struct QuaternionData;
 enum ZLiquidStatus : uint32;
 
-typedef std::unordered_map<Player*, UpdateData> UpdateDataMapType;
+class UpdateDataMap;
+typedef UpdateDataMap UpdateDataMapType;
 
 struct CreateObjectBits
 {
@@ -179,6 +180,10 @@ class TC_GAME_API Object
 
         void ClearUpdateMask(bool remove);
 
+        // position in the update list of the map while the object is queued for an update
+        std::size_t GetUpdateObjectSlot() const { return m_updateObjectSlot; }
+        void SetUpdateObjectSlot(std::size_t slot) { m_updateObjectSlot = slot; }
+
         uint16 GetValuesCount() const { return m_valuesCount; }
 
         virtual bool hasQuest(uint32 /* quest_id */) const { return false; }
@@ -251,10 +256,13 @@ class TC_GAME_API Object
         std::string _ConcatFields(uint16 startIndex, uint16 size) const;
         [[nodiscard]] bool _LoadIntoDataField(std::string const& data, uint32 startOffset, uint32 count);
 
-        uint32 GetUpdateFieldData(Player const* target, uint32*& flags) const;
+        uint32 GetUpdateFieldData(Player const* target, UpdateFieldFlagMask const*& flags) const;
 
         void BuildMovementUpdate(ByteBuffer* data, CreateObjectBits flags) const;
         virtual void BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, Player* target) const;
+        // Target dependent values of BuildValuesUpdate that are not covered by the update field visibility flags.
+        // Viewers with equal visibility flags and variant share one values update block, returns false if the block can't be shared
+        virtual bool GetValuesUpdateVariant(Player* /*target*/, uint64& variant) const { variant = 0; return true; }
 
         uint16 m_objectType;
 
@@ -279,6 +287,7 @@ class TC_GAME_API Object
         void AddToObjectUpdateIfNeeded();
 
         bool m_objectUpdated;
+        std::size_t m_updateObjectSlot;
 
     private:
         bool m_inWorld;
@@ -20,6 +20,8 @@
 #include "Opcodes.h"
 #include "World.h"
 #include "WorldPacket.h"
+#include <algorithm>
+#include <bit>
 
 UpdateData::UpdateData(uint16 map) : m_map(map), m_blockCount(0) { }
 
@@ -39,10 +41,20 @@ void UpdateData::AddUpdateBlock(const ByteBuffer &block)
     ++m_blockCount;
 }
 
+void UpdateData::AddUpdateBlock(std::shared_ptr<ByteBuffer const> block)
+{
+    m_sharedBlocks.emplace_back(m_data.wpos(), std::move(block));
+    ++m_blockCount;
+}
+
 bool UpdateData::BuildPacket(WorldPacket* packet)
 {
     ASSERT(packet->empty());                                // shouldn't happen
-    packet->Initialize(SMSG_UPDATE_OBJECT, 2 + 4 + (m_outOfRangeGUIDs.empty() ? 0 : 1 + 4 + 9 * m_outOfRangeGUIDs.size()) + m_data.wpos());
+    std::size_t dataSize = m_data.wpos();
+    for (std::pair<std::size_t, std::shared_ptr<ByteBuffer const>> const& sharedBlock : m_sharedBlocks)
+        dataSize += sharedBlock.second->wpos();
+
+    packet->Initialize(SMSG_UPDATE_OBJECT, 2 + 4 + (m_outOfRangeGUIDs.empty() ? 0 : 1 + 4 + 9 * m_outOfRangeGUIDs.size()) + dataSize);
 
     *packet << uint16(m_map);
     *packet << uint32(m_blockCount + (m_outOfRangeGUIDs.empty() ? 0 : 1));
@@ -56,14 +68,99 @@ bool UpdateData::BuildPacket(WorldPacket* packet)
             *packet << i->WriteAsPacked();
     }
 
-    packet->append(m_data);
+    std::size_t dataPos = 0;
+    for (std::pair<std::size_t, std::shared_ptr<ByteBuffer const>> const& sharedBlock : m_sharedBlocks)
+    {
+        if (sharedBlock.first > dataPos)
+            packet->append(m_data.contents() + dataPos, sharedBlock.first - dataPos);
+
+        packet->append(*sharedBlock.second);
+        dataPos = sharedBlock.first;
+    }
+
+    if (m_data.wpos() > dataPos)
+        packet->append(m_data.contents() + dataPos, m_data.wpos() - dataPos);
+
     return true;
 }
 
+// player pointers only differ in their higher bits because of allocator alignment,
+// fibonacci hashing spreads them over the whole power of two sized index
+static std::size_t GetIndexSlot(Player const* player, std::size_t indexSize)
+{
+    uint64 hash = uint64(reinterpret_cast<uintptr_t>(player)) * UI64LIT(0x9E3779B97F4A7C15);
+    return std::size_t(hash >> (64 - std::countr_zero(indexSize)));
+}
+
+UpdateData& UpdateDataMap::GetUpdateData(Player* player, uint16 map)
+{
+    // keep the table at most half full
+    if ((_size + 1) * 2 > _index.size())
+    {
+        _index.assign(std::max<std::size_t>(_index.size() * 2, 64), { nullptr, 0 });
+        for (std::size_t i = 0; i < _size; ++i)
+        {
+            std::size_t slot = GetIndexSlot(_entries[i].first, _index.size());
+            while (_index[slot].first)
+                slot = (slot + 1) & (_index.size() - 1);
+
+            _index[slot] = { _entries[i].first, uint32(i) };
+        }
+    }
+
+    std::size_t slot = GetIndexSlot(player, _index.size());
+    while (_index[slot].first)
+    {
+        if (_index[slot].first == player)
+            return _entries[_index[slot].second].second;
+
+        slot = (slot + 1) & (_index.size() - 1);
+    }
+
+    if (_size == _entries.size())
+        _entries.emplace_back(player, UpdateData(map));
+    else
+    {
+        _entries[_size].first = player;
+        _entries[_size].second.SetMapId(map);
+    }
+
+    _index[slot] = { player, uint32(_size) };
+    return _entries[_size++].second;
+}
+
+void UpdateDataMap::Reset()
+{
+    for (std::size_t i = 0; i < _size; ++i)
+    {
+        _entries[i].first = nullptr;
+        _entries[i].second.Clear();
+    }
+
+    std::fill(_index.begin(), _index.end(), std::make_pair<Player*, uint32>(nullptr, 0));
+    _size = 0;
+    _valuesUpdateBlocks.clear();
+}
+
+std::shared_ptr<ByteBuffer const> UpdateDataMap::GetValuesUpdateBlock(uint32 visibleFlag, uint64 variant) const
+{
+    for (ValuesUpdateBlock const& block : _valuesUpdateBlocks)
+        if (block.VisibleFlag == visibleFlag && block.Variant == variant)
+            return block.Block;
+
+    return nullptr;
+}
+
+void UpdateDataMap::AddValuesUpdateBlock(uint32 visibleFlag, uint64 variant, std::shared_ptr<ByteBuffer const> block)
+{
+    _valuesUpdateBlocks.push_back({ visibleFlag, variant, std::move(block) });
+}
+
 void UpdateData::Clear()
 {
     m_data.clear();
     m_outOfRangeGUIDs.clear();
+    m_sharedBlocks.clear();
     m_blockCount = 0;
     m_map = 0;
 }
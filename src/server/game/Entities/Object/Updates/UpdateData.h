@@ -21,8 +21,12 @@
 #include "Define.h"
 #include "ByteBuffer.h"
 #include "ObjectGuid.h"
+#include <memory>
 #include <set>
+#include <utility>
+#include <vector>
 
+class Player;
 class WorldPacket;
 
 enum OBJECT_UPDATE_TYPE
@@ -39,16 +43,18 @@ class UpdateData
         UpdateData(uint16 map);
         UpdateData(UpdateData&& right) : m_map(right.m_map), m_blockCount(right.m_blockCount),
             m_outOfRangeGUIDs(std::move(right.m_outOfRangeGUIDs)),
-            m_data(std::move(right.m_data))
+            m_data(std::move(right.m_data)), m_sharedBlocks(std::move(right.m_sharedBlocks))
         {
         }
 
         void AddOutOfRangeGUID(GuidSet& guids);
         void AddOutOfRangeGUID(ObjectGuid guid);
         void AddUpdateBlock(const ByteBuffer &block);
+        void AddUpdateBlock(std::shared_ptr<ByteBuffer const> block);
         bool BuildPacket(WorldPacket* packet);
         bool HasData() const { return m_blockCount > 0 || !m_outOfRangeGUIDs.empty(); }
         void Clear();
+        void SetMapId(uint16 map) { m_map = map; }
 
         GuidSet const& GetOutOfRangeGUIDs() const { return m_outOfRangeGUIDs; }
 
@@ -57,8 +63,52 @@ class UpdateData
         uint32 m_blockCount;
         GuidSet m_outOfRangeGUIDs;
         ByteBuffer m_data;
+        // blocks shared with other players, each is written before m_data contents starting at the stored offset
+        std::vector<std::pair<std::size_t, std::shared_ptr<ByteBuffer const>>> m_sharedBlocks;
 
         UpdateData(UpdateData const& right) = delete;
         UpdateData& operator=(UpdateData const& right) = delete;
 };
+
+// Per player update data of one Map::SendObjectUpdates pass.
+// Entries are only cleared by Reset() so their buffers are reused by the next pass
+class UpdateDataMap
+{
+    public:
+        typedef std::pair<Player*, UpdateData> value_type;
+        typedef std::vector<value_type>::iterator iterator;
+
+        UpdateDataMap() : _size(0) { }
+
+        UpdateData& GetUpdateData(Player* player, uint16 map);
+
+        iterator begin() { return _entries.begin(); }
+        iterator end() { return _entries.begin() + _size; }
+        std::size_t size() const { return _size; }
+        bool empty() const { return _size == 0; }
+
+        void Reset();
+
+        // Values update blocks of the object currently being built, see Object::GetValuesUpdateVariant
+        std::shared_ptr<ByteBuffer const> GetValuesUpdateBlock(uint32 visibleFlag, uint64 variant) const;
+        void AddValuesUpdateBlock(uint32 visibleFlag, uint64 variant, std::shared_ptr<ByteBuffer const> block);
+        void ResetValuesUpdateBlocks() { _valuesUpdateBlocks.clear(); }
+
+    private:
+        struct ValuesUpdateBlock
+        {
+            uint32 VisibleFlag;
+            uint64 Variant;
+            std::shared_ptr<ByteBuffer const> Block;
+        };
+
+        // open addressing table of player -> index in _entries
+        std::vector<std::pair<Player*, uint32>> _index;
+        std::vector<value_type> _entries;
+        std::size_t _size;
+        std::vector<ValuesUpdateBlock> _valuesUpdateBlocks;
+
+        UpdateDataMap(UpdateDataMap const& right) = delete;
+        UpdateDataMap& operator=(UpdateDataMap const& right) = delete;
+};
 #endif
@@ -1656,3 +1656,19 @@ uint32 AreaTriggerUpdateFieldFlags[AREATRIGGER_END] =
     UF_FLAG_PUBLIC,                                         // AREATRIGGER_FINAL_POS+1
     UF_FLAG_PUBLIC,                                         // AREATRIGGER_FINAL_POS+2
 };
+
+UpdateFieldFlagMask::UpdateFieldFlagMask(uint32 const* flags, uint32 fieldCount) : _blocks((fieldCount + BLOCK_BITS - 1) / BLOCK_BITS)
+{
+    for (uint32 index = 0; index < fieldCount; ++index)
+        for (uint32 flag = 0; flag < FLAG_COUNT; ++flag)
+            if (flags[index] & (1 << flag))
+                _blocks[index / BLOCK_BITS][flag] |= BlockType(1) << (index % BLOCK_BITS);
+}
+
+// defined after the flag tables, these are initialized in order of definition
+UpdateFieldFlagMask const ItemUpdateFieldFlagMask(ItemUpdateFieldFlags, CONTAINER_END);
+UpdateFieldFlagMask const UnitUpdateFieldFlagMask(UnitUpdateFieldFlags, PLAYER_END);
+UpdateFieldFlagMask const GameObjectUpdateFieldFlagMask(GameObjectUpdateFieldFlags, GAMEOBJECT_END);
+UpdateFieldFlagMask const DynamicObjectUpdateFieldFlagMask(DynamicObjectUpdateFieldFlags, DYNAMICOBJECT_END);
+UpdateFieldFlagMask const CorpseUpdateFieldFlagMask(CorpseUpdateFieldFlags, CORPSE_END);
+UpdateFieldFlagMask const AreaTriggerUpdateFieldFlagMask(AreaTriggerUpdateFieldFlags, AREATRIGGER_END);
@@ -20,6 +20,9 @@
 
 #include "UpdateFields.h"
 #include "Define.h"
+#include <array>
+#include <bit>
+#include <vector>
 
 enum UpdatefieldFlags
 {
@@ -35,6 +38,35 @@ enum UpdatefieldFlags
     UF_FLAG_DYNAMIC      = 0x100
 };
 
+// Field flag table transposed into one bit per field for every UpdatefieldFlags value
+// so the fields matching a set of flags can be selected 64 at a time
+class TC_GAME_API UpdateFieldFlagMask
+{
+public:
+    typedef uint64 BlockType;
+
+    static constexpr uint32 BLOCK_BITS = sizeof(BlockType) * 8;
+    static constexpr uint32 FLAG_COUNT = 9;
+
+    UpdateFieldFlagMask(uint32 const* flags, uint32 fieldCount);
+
+    /// Fields [block * BLOCK_BITS, (block + 1) * BLOCK_BITS) having any of flags
+    BlockType GetBlock(uint32 block, uint32 flags) const
+    {
+        std::array<BlockType, FLAG_COUNT> const& masks = _blocks[block];
+        BlockType result = 0;
+        for (flags &= (1 << FLAG_COUNT) - 1; flags; flags &= flags - 1)
+            result |= masks[std::countr_zero(flags)];
+
+        return result;
+    }
+
+    uint32 GetBlockCount() const { return uint32(_blocks.size()); }
+
+private:
+    std::vector<std::array<BlockType, FLAG_COUNT>> _blocks;
+};
+
 TC_GAME_API extern uint32 ItemUpdateFieldFlags[CONTAINER_END];
 TC_GAME_API extern uint32 UnitUpdateFieldFlags[PLAYER_END];
 TC_GAME_API extern uint32 GameObjectUpdateFieldFlags[GAMEOBJECT_END];
@@ -42,4 +74,11 @@ TC_GAME_API extern uint32 DynamicObjectUpdateFieldFlags[DYNAMICOBJECT_END];
 TC_GAME_API extern uint32 CorpseUpdateFieldFlags[CORPSE_END];
 TC_GAME_API extern uint32 AreaTriggerUpdateFieldFlags[AREATRIGGER_END];
 
+TC_GAME_API extern UpdateFieldFlagMask const ItemUpdateFieldFlagMask;
+TC_GAME_API extern UpdateFieldFlagMask const UnitUpdateFieldFlagMask;
+TC_GAME_API extern UpdateFieldFlagMask const GameObjectUpdateFieldFlagMask;
+TC_GAME_API extern UpdateFieldFlagMask const DynamicObjectUpdateFieldFlagMask;
+TC_GAME_API extern UpdateFieldFlagMask const CorpseUpdateFieldFlagMask;
+TC_GAME_API extern UpdateFieldFlagMask const AreaTriggerUpdateFieldFlagMask;
+
 #endif // _UPDATEFIELDFLAGS_H
@@ -19,47 +19,67 @@
 #define __UPDATEMASK_H
 
 #include "UpdateFields.h"
+#include "UpdateFieldFlags.h"
 #include "Errors.h"
 #include "ByteBuffer.h"
+#include <algorithm>
+#include <bit>
+#include <memory>
 
 class UpdateMask
 {
 public:
-    UpdateMask() : _bits(nullptr), _fieldCount(0) { }
+    typedef uint64 BlockType;
+
+    static constexpr uint32 BLOCK_BITS = sizeof(BlockType) * 8;
+
+    UpdateMask() : _blocks(nullptr), _fieldCount(0) { }
 
     void SetBit(uint32 index)
     {
-        _bits[index] = 1;
+        _blocks[index / BLOCK_BITS] |= BlockType(1) << (index % BLOCK_BITS);
     }
 
     void UnsetBit(uint32 index)
     {
-        _bits[index] = 0;
+        _blocks[index / BLOCK_BITS] &= ~(BlockType(1) << (index % BLOCK_BITS));
     }
 
     bool GetBit(uint32 index) const
     {
-        return _bits[index] != 0;
+        return (_blocks[index / BLOCK_BITS] & (BlockType(1) << (index % BLOCK_BITS))) != 0;
+    }
+
+    BlockType GetBlock(uint32 block) const
+    {
+        return _blocks[block];
     }
 
     void SetCount(uint32 valuesCount)
     {
-        _bits = std::make_unique<uint8[]>(valuesCount);
-        std::uninitialized_fill_n(&_bits[0], valuesCount, 0);
+        _blocks = std::make_unique<BlockType[]>(GetBlockCount(valuesCount));
+        std::uninitialized_fill_n(&_blocks[0], GetBlockCount(valuesCount), 0);
         _fieldCount = valuesCount;
     }
 
     void Clear()
     {
-        if (_bits)
-            std::fill_n(&_bits[0], _fieldCount, 0);
+        if (_blocks)
+            std::fill_n(&_blocks[0], GetBlockCount(_fieldCount), 0);
+    }
+
+    static constexpr uint32 GetBlockCount(uint32 fieldCount)
+    {
+        return (fieldCount + BLOCK_BITS - 1) / BLOCK_BITS;
     }
 
 private:
-    std::unique_ptr<uint8[]> _bits;
+    std::unique_ptr<BlockType[]> _blocks;
     uint32 _fieldCount;
 };
 
+static_assert(UpdateMask::BLOCK_BITS == UpdateFieldFlagMask::BLOCK_BITS, "UpdateMask and UpdateFieldFlagMask blocks must cover the same fields");
+
 class UpdateMaskPacketBuilder
 {
 public:
@@ -71,45 +91,95 @@ public:
         CLIENT_UPDATE_MASK_BITS = sizeof(ClientUpdateMaskType) * 8,
     };
 
-    explicit UpdateMaskPacketBuilder(uint32 valuesCount) : _lastSetBit(0)
+    explicit UpdateMaskPacketBuilder(uint32 valuesCount) : _fieldCount(valuesCount)
     {
-        std::size_t blockCount = CalculateBlockCount(valuesCount);
-        _mask = std::make_unique<ClientUpdateMaskType[]>(blockCount);
+        std::size_t blockCount = UpdateMask::GetBlockCount(valuesCount);
+        _mask = std::make_unique<UpdateMask::BlockType[]>(blockCount);
         std::uninitialized_fill_n(&_mask[0], blockCount, 0);
     }
 
     void SetBit(uint32 bit)
     {
-        _mask[GetBlockIndex(bit)] |= GetBlockFlag(bit);
-        _lastSetBit = bit;
+        _mask[bit / UpdateMask::BLOCK_BITS] |= UpdateMask::BlockType(1) << (bit % UpdateMask::BLOCK_BITS);
+    }
+
+    /**
+     * Selects every field sent to a viewer seeing fields with visibleFlag:
+     * fields having alwaysSentFlag and visible fields that changed (changesMask) or are non-zero (creation, changesMask is null).
+     * Works on whole mask blocks instead of testing the flags of every single field.
+     */
+    void SelectFields(UpdateMask const* changesMask, uint32 const* values, UpdateFieldFlagMask const& fieldFlags, uint32 visibleFlag, uint32 alwaysSentFlag)
+    {
+        uint32 blockCount = UpdateMask::GetBlockCount(_fieldCount);
+        for (uint32 block = 0; block < blockCount; ++block)
+        {
+            UpdateMask::BlockType updated;
+            if (changesMask)
+                updated = changesMask->GetBlock(block);
+            else
+            {
+                updated = 0;
+                uint32 first = block * UpdateMask::BLOCK_BITS;
+                uint32 count = std::min(UpdateMask::BLOCK_BITS, _fieldCount - first);
+                for (uint32 i = 0; i < count; ++i)
+                    updated |= UpdateMask::BlockType(values[first + i] != 0) << i;
+            }
+
+            _mask[block] |= (updated & fieldFlags.GetBlock(block, visibleFlag)) | fieldFlags.GetBlock(block, alwaysSentFlag);
+        }
+
+        // fields past _fieldCount are not sent even if set (player fields not visible to others)
+        if (uint32 tail = _fieldCount % UpdateMask::BLOCK_BITS)
+            _mask[blockCount - 1] &= (UpdateMask::BlockType(1) << tail) - 1;
+    }
+
+    /// Index of the first selected field at or after bit, valuesCount if there is none
+    uint32 GetNextSetBit(uint32 bit) const
+    {
+        uint32 block = bit / UpdateMask::BLOCK_BITS;
+        uint32 blockCount = UpdateMask::GetBlockCount(_fieldCount);
+        if (block >= blockCount)
+            return _fieldCount;
+
+        UpdateMask::BlockType bits = _mask[block] & (~UpdateMask::BlockType(0) << (bit % UpdateMask::BLOCK_BITS));
+        while (!bits)
+        {
+            if (++block >= blockCount)
+                return _fieldCount;
+
+            bits = _mask[block];
+        }
+
+        return block * UpdateMask::BLOCK_BITS + std::countr_zero(bits);
     }
 
     void AppendToPacket(ByteBuffer* data)
     {
-        uint8 blockCount = CalculateBlockCount(_lastSetBit + 1);
+        uint8 blockCount = CalculateBlockCount(GetLastSetBit() + 1);
         *data << uint8(blockCount);
-        if (blockCount)
-            data->append(&_mask[0], blockCount);
+        for (uint8 i = 0; i < blockCount; ++i)
+            *data << ClientUpdateMaskType(_mask[i / 2] >> (i % 2 * CLIENT_UPDATE_MASK_BITS));
     }
 
 private:
+    static_assert(UpdateMask::BLOCK_BITS == 2 * CLIENT_UPDATE_MASK_BITS, "Each mask block is sent as two client blocks");
+
     static constexpr uint8 CalculateBlockCount(uint32 fieldCount)
     {
         return (fieldCount + CLIENT_UPDATE_MASK_BITS - 1) / CLIENT_UPDATE_MASK_BITS;
     }
 
-    static constexpr std::size_t GetBlockIndex(uint32 bit)
+    uint32 GetLastSetBit() const
     {
-        return bit / 32;
-    }
+        for (uint32 block = UpdateMask::GetBlockCount(_fieldCount); block > 0; --block)
+            if (_mask[block - 1])
+                return (block - 1) * UpdateMask::BLOCK_BITS + UpdateMask::BLOCK_BITS - 1 - std::countl_zero(_mask[block - 1]);
 
-    static constexpr uint32 GetBlockFlag(uint32 bit)
-    {
-        return 1u << (bit % 32);
+        return 0;
     }
 
-    std::unique_ptr<ClientUpdateMaskType[]> _mask;
-    uint32 _lastSetBit;
+    std::unique_ptr<UpdateMask::BlockType[]> _mask;
+    uint32 _fieldCount;
 };
 
 #endif
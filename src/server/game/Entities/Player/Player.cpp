@@ -75,6 +75,7 @@
 #include "LootPackets.h"
 #include "Mail.h"
 #include "MapManager.h"
+#include "Metric.h"
 #include "MiscPackets.h"
 #include "MotionMaster.h"
 #include "MovementPacketSender.h"
@@ -152,6 +153,38 @@ std::array<uint32, MAX_CLASSES> const MasterySpells =
 
 uint64 const MAX_MONEY_AMOUNT = 9999999999ULL;
 
+namespace
+{
+    char const* const PlayerSaveDomainNames[MAX_PLAYER_SAVE_DOMAINS] =
+    {
+        "fishing_steps", "mail", "bg_data", "inventory", "void_storage", "quest_status", "daily_quest_status",
+        "weekly_quest_status", "seasonal_quest_status", "monthly_quest_status", "lfg_reward_status", "talents",
+        "spells", "spell_history", "actions", "auras", "skills", "achievements", "reputation", "equipment_sets",
+        "tutorials", "glyphs", "instance_times", "currency", "cuf_profiles", "stats"
+    };
+
+    std::array<std::atomic<uint32>, MAX_PLAYER_SAVE_DOMAINS> PlayerSavesWritten;
+    std::array<std::atomic<uint32>, MAX_PLAYER_SAVE_DOMAINS> PlayerSavesSkipped;
+
+    // A save domain was written when it appended statements to the transaction
+    class PlayerSaveDomainCounter
+    {
+    public:
+        explicit PlayerSaveDomainCounter(CharacterDatabaseTransaction const& trans) : _trans(trans), _queries(trans->GetSize()) { }
+
+        void Count(PlayerSaveDomain domain)
+        {
+            std::size_t queries = _trans->GetSize();
+            (queries != _queries ? PlayerSavesWritten : PlayerSavesSkipped)[domain].fetch_add(1, std::memory_order_relaxed);
+            _queries = queries;
+        }
+
+    private:
+        CharacterDatabaseTransaction const& _trans;
+        std::size_t _queries;
+    };
+}
+
 Player::Player(WorldSession* session): Unit(true)
 {
     m_objectType |= TYPEMASK_PLAYER;
@@ -208,6 +241,7 @@ Player::Player(WorldSession* session): Unit(true)
     mSemaphoreTeleport_Far = false;
 
     m_DelayedOperations = 0;
+    m_changedSaveDomains = 0;
     m_bCanDelayTeleport = false;
     m_bHasDelayedTeleport = false;
     m_teleport_options = TELE_TO_NONE;
@@ -1207,7 +1241,10 @@ void Player::Update(uint32 p_time)
         for (InstanceTimeMap::iterator itr = _instanceResetTimes.begin(); itr != _instanceResetTimes.end();)
         {
             if (itr->second < now)
+            {
                 _instanceResetTimes.erase(itr++);
+                SetSaveDomainChanged(PLAYER_SAVE_INSTANCE_TIMES);
+            }
             else
                 ++itr;
         }
@@ -1680,6 +1717,7 @@ void Player::ProcessDelayedOperations()
         {
             CastSpell(this, m_bgData.mountSpell, true);
             m_bgData.mountSpell = 0;
+            SetSaveDomainChanged(PLAYER_SAVE_BG_DATA);
         }
     }
 
@@ -1690,6 +1728,7 @@ void Player::ProcessDelayedOperations()
             m_taxi.AddTaxiDestination(m_bgData.taxiPath[0]);
             m_taxi.AddTaxiDestination(m_bgData.taxiPath[1]);
             m_bgData.ClearTaxiPath();
+            SetSaveDomainChanged(PLAYER_SAVE_BG_DATA);
 
             ContinueTaxiFlight();
         }
@@ -5316,6 +5355,7 @@ bool Player::UpdateFishingSkill()
 
     uint8 stepsNeededToLevelUp = GetFishingStepsNeededToLevelUp(SkillValue);
     ++m_fishingSteps;
+    SetSaveDomainChanged(PLAYER_SAVE_FISHING_STEPS);
 
     if (m_fishingSteps >= stepsNeededToLevelUp)
     {
@@ -5981,6 +6021,11 @@ void Player::SendDirectMessage(WorldPacket const* data) const
     m_session->SendPacket(data);
 }
 
+void Player::SendDirectMessage(std::shared_ptr<WorldPacket const> const& data) const
+{
+    m_session->SendPacket(data);
+}
+
 void Player::SendCinematicStart(uint32 cinematicId)
 {
     WorldPackets::Misc::TriggerCinematic packet;
@@ -16792,6 +16837,7 @@ bool Player::LoadFromDB(ObjectGuid guid, CharacterDatabaseQueryHolder const& hol
 
             // We are not in BG anymore
             m_bgData.bgInstanceID = 0;
+            SetSaveDomainChanged(PLAYER_SAVE_BG_DATA);
         }
     }
     // currently we do not support transport in bg
@@ -18914,7 +18960,10 @@ bool Player::CheckInstanceCount(uint32 instanceId) const
 void Player::AddInstanceEnterTime(uint32 instanceId, time_t enterTime)
 {
     if (_instanceResetTimes.find(instanceId) == _instanceResetTimes.end())
+    {
         _instanceResetTimes.insert(InstanceTimeMap::value_type(instanceId, enterTime + HOUR));
+        SetSaveDomainChanged(PLAYER_SAVE_INSTANCE_TIMES);
+    }
 }
 
 bool Player::_LoadHomeBind(PreparedQueryResult result)
@@ -18987,7 +19036,8 @@ void Player::SaveToDB(bool create /*=false*/)
 
     SaveToDB(trans, create);
 
-    CharacterDatabase.CommitTransaction(trans);
+    // keyed like the login query holder, a relog must not load data older than this save
+    CharacterDatabase.CommitTransaction(trans, GetGUID().GetCounter());
 }
 
 void Player::SaveToDB(CharacterDatabaseTransaction trans, bool create /* = false */)
@@ -19014,9 +19064,9 @@ void Player::SaveToDB(CharacterDatabaseTransaction trans, bool create /* = false
     CharacterDatabasePreparedStatement* stmt = nullptr;
     uint8 index = 0;
 
-    stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_CHAR_FISHINGSTEPS);
-    stmt->setUInt32(0, GetGUID().GetCounter());
-    trans->Append(stmt);
+    // a new character has none of its rows yet
+    if (create)
+        m_changedSaveDomains = (1 << MAX_PLAYER_SAVE_DOMAINS) - 1;
 
     auto finiteAlways = [](float f) { return std::isfinite(f) ? f : 0.0f; };
 
@@ -19286,52 +19336,105 @@ void Player::SaveToDB(CharacterDatabaseTransaction trans, bool create /* = false
 
     trans->Append(stmt);
 
-    if (m_fishingSteps != 0)
+    PlayerSaveDomainCounter saveCounter(trans);
+
+    if (ConsumeSaveDomainChange(PLAYER_SAVE_FISHING_STEPS))
     {
-        stmt = CharacterDatabase.GetPreparedStatement(CHAR_INS_CHAR_FISHINGSTEPS);
-        index = 0;
-        stmt->setUInt32(index++, GetGUID().GetCounter());
-        stmt->setUInt32(index++, m_fishingSteps);
+        stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_CHAR_FISHINGSTEPS);
+        stmt->setUInt32(0, GetGUID().GetCounter());
         trans->Append(stmt);
+
+        if (m_fishingSteps != 0)
+        {
+            stmt = CharacterDatabase.GetPreparedStatement(CHAR_INS_CHAR_FISHINGSTEPS);
+            index = 0;
+            stmt->setUInt32(index++, GetGUID().GetCounter());
+            stmt->setUInt32(index++, m_fishingSteps);
+            trans->Append(stmt);
+        }
     }
+    saveCounter.Count(PLAYER_SAVE_FISHING_STEPS);
 
     if (m_mailsUpdated)                                     //save mails only when needed
         _SaveMail(trans);
+    saveCounter.Count(PLAYER_SAVE_MAIL);
 
     _SaveBGData(trans);
+    saveCounter.Count(PLAYER_SAVE_BG_DATA);
     _SaveInventory(trans);
+    saveCounter.Count(PLAYER_SAVE_INVENTORY);
     _SaveVoidStorage(trans);
+    saveCounter.Count(PLAYER_SAVE_VOID_STORAGE);
     _SaveQuestStatus(trans);
+    saveCounter.Count(PLAYER_SAVE_QUEST_STATUS);
     _SaveDailyQuestStatus(trans);
+    saveCounter.Count(PLAYER_SAVE_DAILY_QUEST_STATUS);
     _SaveWeeklyQuestStatus(trans);
+    saveCounter.Count(PLAYER_SAVE_WEEKLY_QUEST_STATUS);
     _SaveSeasonalQuestStatus(trans);
+    saveCounter.Count(PLAYER_SAVE_SEASONAL_QUEST_STATUS);
     _SaveMonthlyQuestStatus(trans);
+    saveCounter.Count(PLAYER_SAVE_MONTHLY_QUEST_STATUS);
     _SaveLFGRewardStatus(trans);
+    saveCounter.Count(PLAYER_SAVE_LFG_REWARD_STATUS);
     _SaveTalents(trans);
+    saveCounter.Count(PLAYER_SAVE_TALENTS);
     _SaveSpells(trans);
+    saveCounter.Count(PLAYER_SAVE_SPELLS);
     GetSpellHistory()->SaveToDB<Player>(trans);
+    saveCounter.Count(PLAYER_SAVE_SPELL_HISTORY);
     _SaveActions(trans);
+    saveCounter.Count(PLAYER_SAVE_ACTIONS);
     _SaveAuras(trans);
+    saveCounter.Count(PLAYER_SAVE_AURAS);
     _SaveSkills(trans);
+    saveCounter.Count(PLAYER_SAVE_SKILLS);
     m_achievementMgr->SaveToDB(trans);
+    saveCounter.Count(PLAYER_SAVE_ACHIEVEMENTS);
     m_reputationMgr->SaveToDB(trans);
+    saveCounter.Count(PLAYER_SAVE_REPUTATION);
     _SaveEquipmentSets(trans);
+    saveCounter.Count(PLAYER_SAVE_EQUIPMENT_SETS);
     GetSession()->SaveTutorialsData(trans);                 // changed only while character in game
+    saveCounter.Count(PLAYER_SAVE_TUTORIALS);
     _SaveGlyphs(trans);
+    saveCounter.Count(PLAYER_SAVE_GLYPHS);
     _SaveInstanceTimeRestrictions(trans);
+    saveCounter.Count(PLAYER_SAVE_INSTANCE_TIMES);
     _SaveCurrency(trans);
+    saveCounter.Count(PLAYER_SAVE_CURRENCY);
     _SaveCUFProfiles(trans);
+    saveCounter.Count(PLAYER_SAVE_CUF_PROFILES);
 
     // check if stats should only be saved on logout
     // save stats can be out of transaction
     if (m_session->isLogingOut() || !sWorld->getBoolConfig(CONFIG_STATS_SAVE_ONLY_ON_LOGOUT))
         _SaveStats(trans);
+    saveCounter.Count(PLAYER_SAVE_STATS);
 
     // save pet (hunter pet level and experience and all type pets health/mana).
     if (Pet* pet = GetPet())
         pet->SavePetToDB(PET_SAVE_CURRENT_STATE);
 }
 
+bool Player::ConsumeSaveDomainChange(PlayerSaveDomain domain)
+{
+    if (!(m_changedSaveDomains & (1 << domain)))
+        return false;
+
+    m_changedSaveDomains &= ~(1 << domain);
+    return true;
+}
+
+void Player::LogSaveStatistics()
+{
+    for (uint8 i = 0; i < MAX_PLAYER_SAVE_DOMAINS; ++i)
+    {
+        TC_METRIC_VALUE("player_save_written", PlayerSavesWritten[i].exchange(0, std::memory_order_relaxed), TC_METRIC_TAG("domain", PlayerSaveDomainNames[i]));
+        TC_METRIC_VALUE("player_save_skipped", PlayerSavesSkipped[i].exchange(0, std::memory_order_relaxed), TC_METRIC_TAG("domain", PlayerSaveDomainNames[i]));
+    }
+}
+
 // fast save function for item/money cheating preventing - save only inventory and money state
 void Player::SaveInventoryAndGoldToDB(CharacterDatabaseTransaction& trans)
 {
@@ -19598,6 +19701,9 @@ void Player::_SaveInventory(CharacterDatabaseTransaction& trans)
 
 void Player::_SaveVoidStorage(CharacterDatabaseTransaction& trans)
 {
+    if (!ConsumeSaveDomainChange(PLAYER_SAVE_VOID_STORAGE))
+        return;
+
     CharacterDatabasePreparedStatement* stmt = nullptr;
     uint32 lowGuid = GetGUID().GetCounter();
 
@@ -19630,6 +19736,9 @@ void Player::_SaveVoidStorage(CharacterDatabaseTransaction& trans)
 
 void Player::_SaveCUFProfiles(CharacterDatabaseTransaction& trans)
 {
+    if (!ConsumeSaveDomainChange(PLAYER_SAVE_CUF_PROFILES))
+        return;
+
     CharacterDatabasePreparedStatement* stmt = nullptr;
     uint32 lowGuid = GetGUID().GetCounter();
 
@@ -22532,6 +22641,8 @@ void Player::SetBattlegroundEntryPoint()
 
     if (m_bgData.joinPos.m_mapId == MAPID_INVALID) // In error cases use homebind position
         m_bgData.joinPos = WorldLocation(m_homebindMapId, m_homebindX, m_homebindY, m_homebindZ, 0.0f);
+
+    SetSaveDomainChanged(PLAYER_SAVE_BG_DATA);
 }
 
 void Player::GetLFGLeavePoint(Position* pos)
@@ -22559,6 +22670,7 @@ void Player::SetLFGLeavePoint()
 void Player::SetBGTeam(uint32 team)
 {
     m_bgData.bgTeam = team;
+    SetSaveDomainChanged(PLAYER_SAVE_BG_DATA);
     SetByteValue(PLAYER_BYTES_3, PLAYER_BYTES_3_OFFSET_ARENA_FACTION, uint8(team == ALLIANCE ? 1 : 0));
 }
 
@@ -23819,6 +23931,7 @@ void Player::SetBattlegroundId(uint32 val, BattlegroundTypeId bgTypeId)
 {
     m_bgData.bgInstanceID = val;
     m_bgData.bgTypeID = bgTypeId;
+    SetSaveDomainChanged(PLAYER_SAVE_BG_DATA);
 }
 
 uint32 Player::AddBattlegroundQueueId(BattlegroundQueueTypeId val)
@@ -24983,6 +25096,7 @@ void Player::SetGlyph(uint8 slot, uint32 glyph)
 {
     _talentMgr->SpecInfo[GetActiveSpec()].Glyphs[slot] = glyph;
     SetUInt32Value(PLAYER_FIELD_GLYPHS_1 + slot, glyph);
+    SetSaveDomainChanged(PLAYER_SAVE_GLYPHS);
 }
 
 uint32 Player::GetGlyph(uint8 spec, uint8 slot) const
@@ -26396,6 +26510,9 @@ void Player::_SaveEquipmentSets(CharacterDatabaseTransaction& trans)
 
 void Player::_SaveBGData(CharacterDatabaseTransaction& trans)
 {
+    if (!ConsumeSaveDomainChange(PLAYER_SAVE_BG_DATA))
+        return;
+
     CharacterDatabasePreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_PLAYER_BGDATA);
     stmt->setUInt32(0, GetGUID().GetCounter());
     trans->Append(stmt);
@@ -26484,8 +26601,11 @@ void Player::_LoadGlyphs(PreparedQueryResult result)
     while (result->NextRow());
 }
 
-void Player::_SaveGlyphs(CharacterDatabaseTransaction& trans) const
+void Player::_SaveGlyphs(CharacterDatabaseTransaction& trans)
 {
+    if (!ConsumeSaveDomainChange(PLAYER_SAVE_GLYPHS))
+        return;
+
     CharacterDatabasePreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_CHAR_GLYPHS);
     stmt->setUInt32(0, GetGUID().GetCounter());
     trans->Append(stmt);
@@ -27288,7 +27408,7 @@ void Player::_LoadInstanceTimeRestrictions(PreparedQueryResult result)
 
 void Player::_SaveInstanceTimeRestrictions(CharacterDatabaseTransaction& trans)
 {
-    if (_instanceResetTimes.empty())
+    if (!ConsumeSaveDomainChange(PLAYER_SAVE_INSTANCE_TIMES) || _instanceResetTimes.empty())
         return;
 
     CharacterDatabasePreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_ACCOUNT_INSTANCE_LOCK_TIMES);
@@ -27368,6 +27488,7 @@ uint8 Player::AddVoidStorageItem(VoidStorageItem const& item)
 
     _voidStorageItems[slot] = std::make_unique<VoidStorageItem>(item.ItemId, item.ItemEntry,
         item.CreatorGuid, item.ItemRandomPropertyId, item.ItemSuffixFactor);
+    SetSaveDomainChanged(PLAYER_SAVE_VOID_STORAGE);
     return slot;
 }
 
@@ -27388,6 +27509,7 @@ void Player::AddVoidStorageItemAtSlot(uint8 slot, const VoidStorageItem& item)
 
     _voidStorageItems[slot] = std::make_unique<VoidStorageItem>(item.ItemId, item.ItemId,
         item.CreatorGuid, item.ItemRandomPropertyId, item.ItemSuffixFactor);
+    SetSaveDomainChanged(PLAYER_SAVE_VOID_STORAGE);
 }
 
 void Player::DeleteVoidStorageItem(uint8 slot)
@@ -27399,6 +27521,7 @@ void Player::DeleteVoidStorageItem(uint8 slot)
     }
 
     _voidStorageItems[slot] = nullptr;
+    SetSaveDomainChanged(PLAYER_SAVE_VOID_STORAGE);
 }
 
 bool Player::SwapVoidStorageItem(uint8 oldSlot, uint8 newSlot)
@@ -27407,6 +27530,7 @@ bool Player::SwapVoidStorageItem(uint8 oldSlot, uint8 newSlot)
         return false;
 
     std::swap(_voidStorageItems[newSlot], _voidStorageItems[oldSlot]);
+    SetSaveDomainChanged(PLAYER_SAVE_VOID_STORAGE);
     return true;
 }
 
@@ -28076,6 +28200,9 @@ uint8 Player::GetSpecsCount() const
 
 void Player::SetSpecsCount(uint8 count)
 {
+    if (_talentMgr->SpecsCount != count)
+        SetSaveDomainChanged(PLAYER_SAVE_GLYPHS);
+
     _talentMgr->SpecsCount = count;
 }
 
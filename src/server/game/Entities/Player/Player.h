@@ -831,6 +831,39 @@ enum PlayerDelayedOperations
     DELAYED_END
 };
 
+// Parts of the character saved by Player::SaveToDB, used for statistics and for tracking
+// the parts that are otherwise rewritten as a whole on every save
+enum PlayerSaveDomain : uint8
+{
+    PLAYER_SAVE_FISHING_STEPS,
+    PLAYER_SAVE_MAIL,
+    PLAYER_SAVE_BG_DATA,
+    PLAYER_SAVE_INVENTORY,
+    PLAYER_SAVE_VOID_STORAGE,
+    PLAYER_SAVE_QUEST_STATUS,
+    PLAYER_SAVE_DAILY_QUEST_STATUS,
+    PLAYER_SAVE_WEEKLY_QUEST_STATUS,
+    PLAYER_SAVE_SEASONAL_QUEST_STATUS,
+    PLAYER_SAVE_MONTHLY_QUEST_STATUS,
+    PLAYER_SAVE_LFG_REWARD_STATUS,
+    PLAYER_SAVE_TALENTS,
+    PLAYER_SAVE_SPELLS,
+    PLAYER_SAVE_SPELL_HISTORY,
+    PLAYER_SAVE_ACTIONS,
+    PLAYER_SAVE_AURAS,
+    PLAYER_SAVE_SKILLS,
+    PLAYER_SAVE_ACHIEVEMENTS,
+    PLAYER_SAVE_REPUTATION,
+    PLAYER_SAVE_EQUIPMENT_SETS,
+    PLAYER_SAVE_TUTORIALS,
+    PLAYER_SAVE_GLYPHS,
+    PLAYER_SAVE_INSTANCE_TIMES,
+    PLAYER_SAVE_CURRENCY,
+    PLAYER_SAVE_CUF_PROFILES,
+    PLAYER_SAVE_STATS,
+    MAX_PLAYER_SAVE_DOMAINS
+};
+
 // Player summoning auto-decline time (in secs)
 constexpr uint32 MAX_PLAYER_SUMMON_DELAY= 2 * MINUTE;
 // Maximum money amount : 2^31 - 1
@@ -1422,8 +1455,8 @@ class TC_GAME_API Player : public Unit, public GridObject<Player>
         void AddTimedQuest(uint32 questId) { m_timedquests.insert(questId); }
         void RemoveTimedQuest(uint32 questId) { m_timedquests.erase(questId); }
 
-        void SaveCUFProfile(uint8 id, std::nullptr_t) { _CUFProfiles[id] = nullptr; } ///> Empties a CUF profile at position 0-4
-        void SaveCUFProfile(uint8 id, std::unique_ptr<CUFProfile> profile) { _CUFProfiles[id] = std::move(profile); } ///> Replaces a CUF profile at position 0-4
+        void SaveCUFProfile(uint8 id, std::nullptr_t) { _CUFProfiles[id] = nullptr; SetSaveDomainChanged(PLAYER_SAVE_CUF_PROFILES); } ///> Empties a CUF profile at position 0-4
+        void SaveCUFProfile(uint8 id, std::unique_ptr<CUFProfile> profile) { _CUFProfiles[id] = std::move(profile); SetSaveDomainChanged(PLAYER_SAVE_CUF_PROFILES); } ///> Replaces a CUF profile at position 0-4
         CUFProfile* GetCUFProfile(uint8 id) const { return _CUFProfiles[id].get(); } ///> Retrieves a CUF profile at position 0-4
         uint8 GetCUFProfilesCount() const
         {
@@ -1468,6 +1501,9 @@ class TC_GAME_API Player : public Unit, public GridObject<Player>
         static void DeleteOldCharacters();
         static void DeleteOldCharacters(uint32 keepDays);
 
+        //! Sends the number of written and skipped saves of each PlayerSaveDomain to the metric server and resets them
+        static void LogSaveStatistics();
+
         bool m_mailsUpdated;
 
         void SetBindPoint(ObjectGuid guid) const;
@@ -2029,6 +2065,7 @@ class TC_GAME_API Player : public Unit, public GridObject<Player>
         void SendInitWorldStates(uint32 zone, uint32 area);
         void SendUpdateWorldState(uint32 variable, uint32 value, bool hidden = false) const;
         void SendDirectMessage(WorldPacket const* data) const;
+        void SendDirectMessage(std::shared_ptr<WorldPacket const> const& data) const;
 
         void SendAurasForTarget(Unit* target) const;
 
@@ -2487,7 +2524,7 @@ class TC_GAME_API Player : public Unit, public GridObject<Player>
         void _SaveSpells(CharacterDatabaseTransaction& trans);
         void _SaveEquipmentSets(CharacterDatabaseTransaction& trans);
         void _SaveBGData(CharacterDatabaseTransaction& trans);
-        void _SaveGlyphs(CharacterDatabaseTransaction& trans) const;
+        void _SaveGlyphs(CharacterDatabaseTransaction& trans);
         void _SaveTalents(CharacterDatabaseTransaction& trans);
         void _SaveStats(CharacterDatabaseTransaction& trans) const;
         void _SaveInstanceTimeRestrictions(CharacterDatabaseTransaction& trans);
@@ -2694,6 +2731,10 @@ class TC_GAME_API Player : public Unit, public GridObject<Player>
         void SetDelayedTeleportFlag(bool setting) { m_bHasDelayedTeleport = setting; }
         void ScheduleDelayedOperation(uint32 operation) { if (operation < DELAYED_END) m_DelayedOperations |= operation; }
 
+        // Parts saved as a whole (bg data, void storage, glyphs...) are only written after they changed
+        void SetSaveDomainChanged(PlayerSaveDomain domain) { m_changedSaveDomains |= 1 << domain; }
+        bool ConsumeSaveDomainChange(PlayerSaveDomain domain);
+
         bool IsInstanceLoginGameMasterException() const;
 
         MapReference m_mapRef;
@@ -2717,6 +2758,7 @@ class TC_GAME_API Player : public Unit, public GridObject<Player>
         bool mSemaphoreTeleport_Far;
 
         uint32 m_DelayedOperations;
+        uint32 m_changedSaveDomains;
         bool m_bCanDelayTeleport;
         bool m_bHasDelayedTeleport;
 
@@ -1690,6 +1690,7 @@ class TC_GAME_API Unit : public WorldObject
         explicit Unit (bool isWorldObject);
 
         void BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, Player* target) const override;
+        bool GetValuesUpdateVariant(Player* target, uint64& variant) const override;
 
         void _UpdateSpells(uint32 time);
         void _DeleteRemovedAuras();
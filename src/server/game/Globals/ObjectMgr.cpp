@@ -141,6 +141,16 @@ std::string GetScriptCommandName(ScriptCommands command)
     return res;
 }
 
+// Streamed results only know their row count once every row was fetched. The stores filled from them are
+// sized with a separate count, which must run before the stream locks its connection
+static uint64 GetWorldTableRowCount(char const* table)
+{
+    if (QueryResult result = WorldDatabase.PQuery("SELECT COUNT(*) FROM %s", table))
+        return (*result)[0].GetUInt64();
+
+    return 0;
+}
+
 std::string ScriptInfo::GetDebugInfo() const
 {
     char sz[256];
@@ -412,8 +422,10 @@ void ObjectMgr::LoadCreatureTemplates()
 {
     uint32 oldMSTime = getMSTime();
 
+    uint64 rowCount = GetWorldTableRowCount("creature_template");
+
     //                                               0      1                   2                   3                   4            5            6         7         8
-    QueryResult result = WorldDatabase.Query("SELECT entry, difficulty_entry_1, difficulty_entry_2, difficulty_entry_3, KillCredit1, KillCredit2, modelid1, modelid2, modelid3, "
+    QueryResult result = WorldDatabase.StreamQuery("SELECT entry, difficulty_entry_1, difficulty_entry_2, difficulty_entry_3, KillCredit1, KillCredit2, modelid1, modelid2, modelid3, "
     //                                        9         10    11          12       13        14              15        16        17                      18       19       20       21          22
                                              "modelid4, name, femaleName, subname, IconName, gossip_menu_id, minlevel, maxlevel, HealthScalingExpansion, exp_unk, faction, npcflag, speed_walk, speed_run, "
     //                                        23      24     25         26              27               28            29             30          31          32
@@ -435,7 +447,7 @@ void ObjectMgr::LoadCreatureTemplates()
         return;
     }
 
-    _creatureTemplateStore.reserve(result->GetRowCount());
+    _creatureTemplateStore.reserve(rowCount);
     do
     {
         Field* fields = result->Fetch();
@@ -2056,8 +2068,10 @@ void ObjectMgr::LoadCreatures()
 {
     uint32 oldMSTime = getMSTime();
 
+    uint64 rowCount = GetWorldTableRowCount("creature");
+
     //                                               0              1   2    3           4           5           6            7        8             9              10
-    QueryResult result = WorldDatabase.Query("SELECT creature.guid, id, map, position_x, position_y, position_z, orientation, modelid, equipment_id, spawntimesecs, wander_distance, "
+    QueryResult result = WorldDatabase.StreamQuery("SELECT creature.guid, id, map, position_x, position_y, position_z, orientation, modelid, equipment_id, spawntimesecs, wander_distance, "
     //   11               12         13       14            15         16          17           18                19                    20                    21
         "currentwaypoint, curhealth, curmana, MovementType, spawnMask, eventEntry, poolSpawnId, creature.npcflag, creature.unit_flags,  creature.unit_flags2, creature.phaseUseFlags, "
     //   22                23                   24                       25
@@ -2082,7 +2096,7 @@ void ObjectMgr::LoadCreatures()
 
     PhaseShift phaseShift;
 
-    _creatureDataStore.reserve(result->GetRowCount());
+    _creatureDataStore.reserve(rowCount);
 
     do
     {
@@ -2339,8 +2353,10 @@ void ObjectMgr::LoadGameObjects()
 {
     uint32 oldMSTime = getMSTime();
 
+    uint64 rowCount = GetWorldTableRowCount("gameobject");
+
     //                                               0                1   2    3           4           5           6
-    QueryResult result = WorldDatabase.Query("SELECT gameobject.guid, id, map, position_x, position_y, position_z, orientation, "
+    QueryResult result = WorldDatabase.StreamQuery("SELECT gameobject.guid, id, map, position_x, position_y, position_z, orientation, "
     //   7          8          9          10         11             12            13     14         15          16
         "rotation0, rotation1, rotation2, rotation3, spawntimesecs, animprogress, state, spawnMask, eventEntry, poolSpawnId, "
     //   17             18       19          20              21
@@ -2364,7 +2380,7 @@ void ObjectMgr::LoadGameObjects()
 
     PhaseShift phaseShift;
 
-    _gameObjectDataStore.reserve(result->GetRowCount());
+    _gameObjectDataStore.reserve(rowCount);
 
     do
     {
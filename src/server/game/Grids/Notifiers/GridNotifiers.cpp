@@ -321,6 +321,19 @@ void MessageDistDeliverer::Visit(DynamicObjectMapType &m)
     }
 }
 
+void MessageDistDeliverer::SendPacket(Player* player)
+{
+    // never send packet to self
+    if (player == i_source || (team && player->GetTeam() != team) || skipped_receiver == player)
+        return;
+
+    if (!player->HaveAtClient(i_source))
+        return;
+
+    // copied once, every receiver shares the same payload
+    player->SendDirectMessage(i_sharedMessage.Get());
+}
+
 void MessageDistDelivererToHostile::Visit(PlayerMapType &m)
 {
     for (PlayerMapType::iterator iter = m.begin(); iter != m.end(); ++iter)
@@ -389,6 +402,15 @@ void MessageDistDelivererToHostile::Visit(DynamicObjectMapType &m)
     }
 }
 
+void MessageDistDelivererToHostile::SendPacket(Player* player)
+{
+    // never send packet to self
+    if (player == i_source || !player->HaveAtClient(i_source) || player->IsFriendlyTo(i_source))
+        return;
+
+    player->SendDirectMessage(i_sharedMessage.Get());
+}
+
 /*
 void
 MessageDistDeliverer::VisitObject(Player* player)
@@ -118,11 +118,12 @@ namespace Trinity
     {
         WorldObject const* i_source;
         WorldPacket const* i_message;
+        LazySharedPacket i_sharedMessage;
         float i_distSq;
         uint32 team;
         Player const* skipped_receiver;
         MessageDistDeliverer(WorldObject const* src, WorldPacket const* msg, float dist, bool own_team_only = false, Player const* skipped = nullptr)
-            : i_source(src), i_message(msg), i_distSq(dist * dist)
+            : i_source(src), i_message(msg), i_sharedMessage(msg), i_distSq(dist * dist)
             , team(0)
             , skipped_receiver(skipped)
         {
@@ -136,27 +137,18 @@ namespace Trinity
         void Visit(DynamicObjectMapType &m);
         template<class SKIP> void Visit(GridRefManager<SKIP> &) { }
 
-        void SendPacket(Player* player)
-        {
-            // never send packet to self
-            if (player == i_source || (team && player->GetTeam() != team) || skipped_receiver == player)
-                return;
-
-            if (!player->HaveAtClient(i_source))
-                return;
-
-            player->SendDirectMessage(i_message);
-        }
+        void SendPacket(Player* player);
     };
 
     struct TC_GAME_API MessageDistDelivererToHostile
     {
         Unit* i_source;
         WorldPacket* i_message;
+        LazySharedPacket i_sharedMessage;
         float i_distSq;
 
         MessageDistDelivererToHostile(Unit* src, WorldPacket* msg, float dist)
-            : i_source(src), i_message(msg), i_distSq(dist * dist)
+            : i_source(src), i_message(msg), i_sharedMessage(msg), i_distSq(dist * dist)
         {
         }
 
@@ -165,14 +157,7 @@ namespace Trinity
         void Visit(DynamicObjectMapType &m);
         template<class SKIP> void Visit(GridRefManager<SKIP> &) { }
 
-        void SendPacket(Player* player)
-        {
-            // never send packet to self
-            if (player == i_source || !player->HaveAtClient(i_source) || player->IsFriendlyTo(i_source))
-                return;
-
-            player->SendDirectMessage(i_message);
-        }
+        void SendPacket(Player* player);
     };
 
     struct ObjectUpdater
@@ -1601,16 +1586,11 @@ namespace Trinity
         public:
             explicit LocalizedPacketDo(Builder& builder) : i_builder(builder) { }
 
-            ~LocalizedPacketDo()
-            {
-                for (size_t i = 0; i < i_data_cache.size(); ++i)
-                    delete i_data_cache[i];
-            }
             void operator()(Player* p);
 
         private:
             Builder& i_builder;
-            std::vector<WorldPacket*> i_data_cache;         // 0 = default, i => i-1 locale index
+            std::vector<std::shared_ptr<WorldPacket const>> i_data_cache; // 0 = default, i => i-1 locale index, shared by all receivers
     };
 
     // Prepare using Builder localized packets with caching and send to player
@@ -1621,17 +1601,11 @@ namespace Trinity
             typedef std::vector<WorldPacket*> WorldPacketList;
             explicit LocalizedPacketListDo(Builder& builder) : i_builder(builder) { }
 
-            ~LocalizedPacketListDo()
-            {
-                for (size_t i = 0; i < i_data_cache.size(); ++i)
-                    for (size_t j = 0; j < i_data_cache[i].size(); ++j)
-                        delete i_data_cache[i][j];
-            }
             void operator()(Player* p);
 
         private:
             Builder& i_builder;
-            std::vector<WorldPacketList> i_data_cache;
+            std::vector<std::vector<std::shared_ptr<WorldPacket const>>> i_data_cache;
                                                             // 0 = default, i => i-1 locale index
     };
 }
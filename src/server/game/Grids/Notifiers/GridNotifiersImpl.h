@@ -562,7 +562,6 @@ void Trinity::LocalizedPacketDo<Builder>::operator()(Player* p)
 {
     LocaleConstant loc_idx = p->GetSession()->GetSessionDbLocaleIndex();
     uint32 cache_idx = loc_idx+1;
-    WorldPacket* data;
 
     // create if not cached yet
     if (i_data_cache.size() < cache_idx + 1 || !i_data_cache[cache_idx])
@@ -570,16 +569,14 @@ void Trinity::LocalizedPacketDo<Builder>::operator()(Player* p)
         if (i_data_cache.size() < cache_idx + 1)
             i_data_cache.resize(cache_idx + 1);
 
-        data = new WorldPacket();
+        std::shared_ptr<WorldPacket> data = std::make_shared<WorldPacket>();
 
         i_builder(*data, loc_idx);
 
-        i_data_cache[cache_idx] = data;
+        i_data_cache[cache_idx] = std::move(data);
     }
-    else
-        data = i_data_cache[cache_idx];
 
-    p->SendDirectMessage(data);
+    p->SendDirectMessage(i_data_cache[cache_idx]);
 }
 
 template<class Builder>
@@ -587,7 +584,6 @@ void Trinity::LocalizedPacketListDo<Builder>::operator()(Player* p)
 {
     LocaleConstant loc_idx = p->GetSession()->GetSessionDbLocaleIndex();
     uint32 cache_idx = loc_idx+1;
-    WorldPacketList* data_list;
 
     // create if not cached yet
     if (i_data_cache.size() < cache_idx+1 || i_data_cache[cache_idx].empty())
@@ -595,15 +591,16 @@ void Trinity::LocalizedPacketListDo<Builder>::operator()(Player* p)
         if (i_data_cache.size() < cache_idx+1)
             i_data_cache.resize(cache_idx+1);
 
-        data_list = &i_data_cache[cache_idx];
+        WorldPacketList data_list;
+        i_builder(data_list, loc_idx);
 
-        i_builder(*data_list, loc_idx);
+        // cache takes ownership of the built packets
+        for (WorldPacket* data : data_list)
+            i_data_cache[cache_idx].emplace_back(data);
     }
-    else
-        data_list = &i_data_cache[cache_idx];
 
-    for (size_t i = 0; i < data_list->size(); ++i)
-        p->SendDirectMessage((*data_list)[i]);
+    for (std::shared_ptr<WorldPacket const> const& data : i_data_cache[cache_idx])
+        p->SendDirectMessage(data);
 }
 
 #endif                                                      // TRINITY_GRIDNOTIFIERSIMPL_H
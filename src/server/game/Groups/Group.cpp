@@ -1834,6 +1834,7 @@ void Group::UpdatePlayerOutOfRange(Player* player)
 
 void Group::BroadcastAddonMessagePacket(WorldPacket const* packet, const std::string& prefix, bool ignorePlayersInBGRaid, int group, uint64 ignore)
 {
+    LazySharedPacket sharedPacket(packet);
     for (GroupReference* itr = GetFirstMember(); itr != nullptr; itr = itr->next())
     {
         Player* player = itr->GetSource();
@@ -1843,12 +1844,13 @@ void Group::BroadcastAddonMessagePacket(WorldPacket const* packet, const std::st
         if (WorldSession* session = player->GetSession())
             if (session && (group == -1 || itr->getSubGroup() == group))
                 if (session->IsAddonRegistered(prefix))
-                    session->SendPacket(packet);
+                    session->SendPacket(sharedPacket.Get());
     }
 }
 
 void Group::BroadcastPacket(WorldPacket const* packet, bool ignorePlayersInBGRaid, int group, ObjectGuid ignoredPlayer)
 {
+    LazySharedPacket sharedPacket(packet);
     for (GroupReference* itr = GetFirstMember(); itr != nullptr; itr = itr->next())
     {
         Player* player = itr->GetSource();
@@ -1856,18 +1858,21 @@ void Group::BroadcastPacket(WorldPacket const* packet, bool ignorePlayersInBGRai
             continue;
 
         if (player->GetSession() && (group == -1 || itr->getSubGroup() == group))
-            player->SendDirectMessage(packet);
+            player->SendDirectMessage(sharedPacket.Get());
     }
 }
 
 void Group::BroadcastReadyCheck(WorldPacket const* packet)
 {
+    LazySharedPacket sharedPacket(packet);
     for (GroupReference* itr = GetFirstMember(); itr != nullptr; itr = itr->next())
     {
         Player* player = itr->GetSource();
         if (player && player->GetSession())
+        {
             if (IsLeader(player->GetGUID()) || IsAssistant(player->GetGUID()))
-                player->SendDirectMessage(packet);
+                player->SendDirectMessage(sharedPacket.Get());
+        }
     }
 }
 
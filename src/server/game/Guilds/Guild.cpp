@@ -2790,25 +2790,38 @@ void Guild::BroadcastAddonToGuild(WorldSession* session, bool officerOnly, std::
 
 void Guild::BroadcastPacketToRank(WorldPacket const* packet, uint8 rankId) const
 {
+    LazySharedPacket sharedPacket(packet);
     for (auto itr = m_members.begin(); itr != m_members.end(); ++itr)
+    {
         if (itr->second->IsRank(rankId))
+        {
             if (Player* player = itr->second->FindConnectedPlayer())
-                player->SendDirectMessage(packet);
+                player->SendDirectMessage(sharedPacket.Get());
+        }
+    }
 }
 
 void Guild::BroadcastPacket(WorldPacket const* packet) const
 {
+    LazySharedPacket sharedPacket(packet);
     for (auto itr = m_members.begin(); itr != m_members.end(); ++itr)
+    {
         if (Player* player = itr->second->FindPlayer())
-            player->SendDirectMessage(packet);
+            player->SendDirectMessage(sharedPacket.Get());
+    }
 }
 
 void Guild::BroadcastPacketIfTrackingAchievement(WorldPacket const* packet, uint32 criteriaId) const
 {
+    LazySharedPacket sharedPacket(packet);
     for (Members::const_iterator itr = m_members.begin(); itr != m_members.end(); ++itr)
+    {
         if (itr->second->IsTrackingCriteriaId(criteriaId))
+        {
             if (Player* player = itr->second->FindPlayer())
-                player->SendDirectMessage(packet);
+                player->SendDirectMessage(sharedPacket.Get());
+        }
+    }
 }
 
 void Guild::MassInviteToEvent(WorldSession* session, uint32 minLevel, uint32 maxLevel, uint32 minRank)
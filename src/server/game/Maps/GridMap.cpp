@@ -21,10 +21,50 @@
 #include "Log.h"
 #include <G3D/Plane.h>
 #include <G3D/Ray.h>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <cstdint>
+#include <cstring>
 
 static uint16 const holetab_h[4] = { 0x1111, 0x2222, 0x4444, 0x8888 };
 static uint16 const holetab_v[4] = { 0x000F, 0x00F0, 0x0F00, 0xF000 };
 
+namespace
+{
+    // Consumes a mapped section front to back, failing like a short fread when the file is truncated
+    class MapSectionReader
+    {
+    public:
+        MapSectionReader(char const* data, uint32 size) : _data(data), _size(size) { }
+
+        template<class T>
+        bool Read(T& value)
+        {
+            char const* data = Skip(sizeof(T));
+            if (!data)
+                return false;
+
+            memcpy(&value, data, sizeof(T));
+            return true;
+        }
+
+        char const* Skip(uint32 size)
+        {
+            if (_size < size)
+                return nullptr;
+
+            char const* data = _data;
+            _data += size;
+            _size -= size;
+            return data;
+        }
+
+    private:
+        char const* _data;
+        uint32 _size;
+    };
+}
+
 // *****************************
 // Grid function
 // *****************************
@@ -65,68 +105,69 @@ GridMap::LoadResult GridMap::loadData(const char* filename)
     // Unload old data if exist
     unloadData();
 
-    map_fileheader header;
-    // Not return error if file not found
-    FILE* in = fopen(filename, "rb");
-    if (!in)
-        return LoadResult::FileDoesNotExist;
+    try
+    {
+        boost::interprocess::file_mapping file(filename, boost::interprocess::read_only);
+        _region = std::make_unique<boost::interprocess::mapped_region>(file, boost::interprocess::read_only);
+    }
+    catch (boost::interprocess::interprocess_exception const& e)
+    {
+        unloadData();
+        // Not return error if file not found
+        if (e.get_error_code() == boost::interprocess::not_found_error)
+            return LoadResult::FileDoesNotExist;
+
+        TC_LOG_ERROR("maps", "Map file '%s' could not be mapped (%s)", filename, e.what());
+        return LoadResult::InvalidFile;
+    }
+
+    // height lookups touch most of the file, start reading it in the background
+    _region->advise(boost::interprocess::mapped_region::advice_willneed);
 
-    if (fread(&header, sizeof(header), 1, in) != 1)
+    char const* data = static_cast<char const*>(_region->get_address());
+    uint32 size = uint32(_region->get_size());
+
+    map_fileheader header;
+    if (size < sizeof(header))
     {
-        fclose(in);
+        unloadData();
         return LoadResult::InvalidFile;
     }
 
+    memcpy(&header, data, sizeof(header));
     if (header.mapMagic == MapMagic && header.versionMagic == MapVersionMagic)
     {
-        // load up area data
-        if (header.areaMapOffset && !loadAreaData(in, header.areaMapOffset, header.areaMapSize))
+        auto loadSection = [&](uint32 offset, bool (GridMap::*loader)(char const*, uint32), char const* name)
         {
-            TC_LOG_ERROR("maps", "Error loading map area data\n");
-            fclose(in);
-            return LoadResult::InvalidFile;
-        }
-        // load up height data
-        if (header.heightMapOffset && !loadHeightData(in, header.heightMapOffset, header.heightMapSize))
-        {
-            TC_LOG_ERROR("maps", "Error loading map height data\n");
-            fclose(in);
-            return LoadResult::InvalidFile;
-        }
-        // load up liquid data
-        if (header.liquidMapOffset && !loadLiquidData(in, header.liquidMapOffset, header.liquidMapSize))
-        {
-            TC_LOG_ERROR("maps", "Error loading map liquids data\n");
-            fclose(in);
-            return LoadResult::InvalidFile;
-        }
-        // loadup holes data (if any. check header.holesOffset)
-        if (header.holesSize && !loadHolesData(in, header.holesOffset, header.holesSize))
+            if (offset <= size && (this->*loader)(data + offset, size - offset))
+                return true;
+
+            TC_LOG_ERROR("maps", "Error loading map %s data\n", name);
+            return false;
+        };
+
+        if ((header.areaMapOffset && !loadSection(header.areaMapOffset, &GridMap::loadAreaData, "area"))
+            || (header.heightMapOffset && !loadSection(header.heightMapOffset, &GridMap::loadHeightData, "height"))
+            || (header.liquidMapOffset && !loadSection(header.liquidMapOffset, &GridMap::loadLiquidData, "liquids"))
+            // loadup holes data (if any. check header.holesOffset)
+            || (header.holesSize && !loadSection(header.holesOffset, &GridMap::loadHolesData, "holes")))
         {
-            TC_LOG_ERROR("maps", "Error loading map holes data\n");
-            fclose(in);
+            unloadData();
             return LoadResult::InvalidFile;
         }
-        fclose(in);
+
         return LoadResult::Ok;
     }
 
     TC_LOG_ERROR("maps", "Map file '%s' is from an incompatible map version (%.*s v%u), %.*s v%u is expected. Please pull your source, recompile tools and recreate maps using the updated mapextractor, then replace your old map files with new files. If you still have problems search on forum for error TCE00018.",
         filename, 4, header.mapMagic.data(), header.versionMagic, 4, MapMagic.data(), MapVersionMagic);
-    fclose(in);
+    unloadData();
     return LoadResult::InvalidFile;
 }
 
 void GridMap::unloadData()
 {
-    delete[] _areaMap;
-    delete[] m_V9;
-    delete[] m_V8;
     delete[] _minHeightPlanes;
-    delete[] _liquidEntry;
-    delete[] _liquidFlags;
-    delete[] _liquidMap;
-    delete[] _holes;
     _areaMap = nullptr;
     m_V9 = nullptr;
     m_V8 = nullptr;
@@ -136,32 +177,47 @@ void GridMap::unloadData()
     _liquidMap  = nullptr;
     _holes = nullptr;
     _gridGetHeight = &GridMap::getHeightFromFlat;
+    _copiedSections.clear();
+    _region = nullptr;
 }
 
-bool GridMap::loadAreaData(FILE* in, uint32 offset, uint32 /*size*/)
+template<class T>
+T const* GridMap::mapSection(char const* data, uint32 count)
 {
-    map_areaHeader header;
-    fseek(in, offset, SEEK_SET);
+    if (reinterpret_cast<std::uintptr_t>(data) % alignof(T) == 0)
+        return reinterpret_cast<T const*>(data);
+
+    std::unique_ptr<char[]> copy = std::make_unique<char[]>(sizeof(T) * count);
+    memcpy(copy.get(), data, sizeof(T) * count);
+    T const* section = reinterpret_cast<T const*>(copy.get());
+    _copiedSections.push_back(std::move(copy));
+    return section;
+}
 
-    if (fread(&header, sizeof(header), 1, in) != 1 || header.areaMagic != MapAreaMagic)
+bool GridMap::loadAreaData(char const* data, uint32 size)
+{
+    MapSectionReader reader(data, size);
+    map_areaHeader header;
+    if (!reader.Read(header) || header.areaMagic != MapAreaMagic)
         return false;
 
     _gridArea = header.gridArea;
     if (!header.flags.HasFlag(map_areaHeaderFlags::NoArea))
     {
-        _areaMap = new uint16[16 * 16];
-        if (fread(_areaMap, sizeof(uint16), 16 * 16, in) != 16 * 16)
+        char const* areaMap = reader.Skip(sizeof(uint16) * 16 * 16);
+        if (!areaMap)
             return false;
+
+        _areaMap = mapSection<uint16>(areaMap, 16 * 16);
     }
     return true;
 }
 
-bool GridMap::loadHeightData(FILE* in, uint32 offset, uint32 /*size*/)
+bool GridMap::loadHeightData(char const* data, uint32 size)
 {
+    MapSectionReader reader(data, size);
     map_heightHeader header;
-    fseek(in, offset, SEEK_SET);
-
-    if (fread(&header, sizeof(header), 1, in) != 1 || header.heightMagic != MapHeightMagic)
+    if (!reader.Read(header) || header.heightMagic != MapHeightMagic)
         return false;
 
     _gridHeight = header.gridHeight;
@@ -169,31 +225,34 @@ bool GridMap::loadHeightData(FILE* in, uint32 offset, uint32 /*size*/)
     {
         if (header.flags.HasFlag(map_heightHeaderFlags::HeightAsInt16))
         {
-            m_uint16_V9 = new uint16 [129*129];
-            m_uint16_V8 = new uint16 [128*128];
-            if (fread(m_uint16_V9, sizeof(uint16), 129*129, in) != 129*129 ||
-                fread(m_uint16_V8, sizeof(uint16), 128*128, in) != 128*128)
+            char const* v9 = reader.Skip(sizeof(uint16) * 129 * 129);
+            char const* v8 = reader.Skip(sizeof(uint16) * 128 * 128);
+            if (!v9 || !v8)
                 return false;
+            m_uint16_V9 = mapSection<uint16>(v9, 129 * 129);
+            m_uint16_V8 = mapSection<uint16>(v8, 128 * 128);
             _gridIntHeightMultiplier = (header.gridMaxHeight - header.gridHeight) / 65535;
             _gridGetHeight = &GridMap::getHeightFromUint16;
         }
         else if (header.flags.HasFlag(map_heightHeaderFlags::HeightAsInt8))
         {
-            m_uint8_V9 = new uint8 [129*129];
-            m_uint8_V8 = new uint8 [128*128];
-            if (fread(m_uint8_V9, sizeof(uint8), 129*129, in) != 129*129 ||
-                fread(m_uint8_V8, sizeof(uint8), 128*128, in) != 128*128)
+            char const* v9 = reader.Skip(sizeof(uint8) * 129 * 129);
+            char const* v8 = reader.Skip(sizeof(uint8) * 128 * 128);
+            if (!v9 || !v8)
                 return false;
+            m_uint8_V9 = mapSection<uint8>(v9, 129 * 129);
+            m_uint8_V8 = mapSection<uint8>(v8, 128 * 128);
             _gridIntHeightMultiplier = (header.gridMaxHeight - header.gridHeight) / 255;
             _gridGetHeight = &GridMap::getHeightFromUint8;
         }
         else
         {
-            m_V9 = new float [129*129];
-            m_V8 = new float [128*128];
-            if (fread(m_V9, sizeof(float), 129*129, in) != 129*129 ||
-                fread(m_V8, sizeof(float), 128*128, in) != 128*128)
+            char const* v9 = reader.Skip(sizeof(float) * 129 * 129);
+            char const* v8 = reader.Skip(sizeof(float) * 128 * 128);
+            if (!v9 || !v8)
                 return false;
+            m_V9 = mapSection<float>(v9, 129 * 129);
+            m_V8 = mapSection<float>(v8, 128 * 128);
             _gridGetHeight = &GridMap::getHeightFromFloat;
         }
     }
@@ -204,8 +263,7 @@ bool GridMap::loadHeightData(FILE* in, uint32 offset, uint32 /*size*/)
     {
         std::array<int16, 9> maxHeights;
         std::array<int16, 9> minHeights;
-        if (fread(maxHeights.data(), sizeof(int16), maxHeights.size(), in) != maxHeights.size() ||
-            fread(minHeights.data(), sizeof(int16), minHeights.size(), in) != minHeights.size())
+        if (!reader.Read(maxHeights) || !reader.Read(minHeights))
             return false;
 
         static uint32 constexpr indices[8][3] =
@@ -245,12 +303,11 @@ bool GridMap::loadHeightData(FILE* in, uint32 offset, uint32 /*size*/)
     return true;
 }
 
-bool GridMap::loadLiquidData(FILE* in, uint32 offset, uint32 /*size*/)
+bool GridMap::loadLiquidData(char const* data, uint32 size)
 {
+    MapSectionReader reader(data, size);
     map_liquidHeader header;
-    fseek(in, offset, SEEK_SET);
-
-    if (fread(&header, sizeof(header), 1, in) != 1 || header.liquidMagic != MapLiquidMagic)
+    if (!reader.Read(header) || header.liquidMagic != MapLiquidMagic)
         return false;
 
     _liquidGlobalEntry = header.liquidType;
@@ -263,32 +320,34 @@ bool GridMap::loadLiquidData(FILE* in, uint32 offset, uint32 /*size*/)
 
     if (!header.flags.HasFlag(map_liquidHeaderFlags::NoType))
     {
-        _liquidEntry = new uint16[16*16];
-        if (fread(_liquidEntry, sizeof(uint16), 16*16, in) != 16*16)
+        char const* liquidEntry = reader.Skip(sizeof(uint16) * 16 * 16);
+        char const* liquidFlags = reader.Skip(sizeof(map_liquidHeaderTypeFlags) * 16 * 16);
+        if (!liquidEntry || !liquidFlags)
             return false;
 
-        _liquidFlags = new map_liquidHeaderTypeFlags[16*16];
-        if (fread(_liquidFlags, sizeof(map_liquidHeaderTypeFlags), 16*16, in) != 16*16)
-            return false;
+        _liquidEntry = mapSection<uint16>(liquidEntry, 16 * 16);
+        _liquidFlags = mapSection<map_liquidHeaderTypeFlags>(liquidFlags, 16 * 16);
     }
     if (!header.flags.HasFlag(map_liquidHeaderFlags::NoHeight))
     {
-        _liquidMap = new float[uint32(_liquidWidth) * uint32(_liquidHeight)];
-        if (fread(_liquidMap, sizeof(float), _liquidWidth*_liquidHeight, in) != (uint32(_liquidWidth) * uint32(_liquidHeight)))
+        uint32 count = uint32(_liquidWidth) * uint32(_liquidHeight);
+        char const* liquidMap = reader.Skip(sizeof(float) * count);
+        if (!liquidMap)
             return false;
+
+        _liquidMap = mapSection<float>(liquidMap, count);
     }
     return true;
 }
 
-bool GridMap::loadHolesData(FILE* in, uint32 offset, uint32 /*size*/)
+bool GridMap::loadHolesData(char const* data, uint32 size)
 {
-    if (fseek(in, offset, SEEK_SET) != 0)
-        return false;
-
-    _holes = new uint16[16 * 16];
-    if (fread(_holes, sizeof(uint16), 16 * 16, in) != 16 * 16)
+    MapSectionReader reader(data, size);
+    char const* holes = reader.Skip(sizeof(uint16) * 16 * 16);
+    if (!holes)
         return false;
 
+    _holes = mapSection<uint16>(holes, 16 * 16);
     return true;
 }
 
@@ -414,7 +473,7 @@ float GridMap::getHeightFromUint8(float x, float y) const
         return INVALID_HEIGHT;
 
     int32 a, b, c;
-    uint8 *V9_h1_ptr = &m_uint8_V9[x_int*128 + x_int + y_int];
+    uint8 const* V9_h1_ptr = &m_uint8_V9[x_int*128 + x_int + y_int];
     if (x+y < 1)
     {
         if (x > y)
@@ -484,7 +543,7 @@ float GridMap::getHeightFromUint16(float x, float y) const
         return INVALID_HEIGHT;
 
     int32 a, b, c;
-    uint16 *V9_h1_ptr = &m_uint16_V9[x_int*128 + x_int + y_int];
+    uint16 const* V9_h1_ptr = &m_uint16_V9[x_int*128 + x_int + y_int];
     if (x+y < 1)
     {
         if (x > y)
@@ -21,24 +21,30 @@
 #include "Define.h"
 #include "MapDefines.h"
 #include "Optional.h"
-#include <cstdio>
+#include <memory>
+#include <vector>
 
 struct LiquidData;
 enum ZLiquidStatus : uint32;
 namespace G3D { class Plane; }
 
+namespace boost::interprocess
+{
+    class mapped_region;
+}
+
 class TC_GAME_API GridMap
 {
     uint32  _flags;
     union{
-        float* m_V9;
-        uint16* m_uint16_V9;
-        uint8* m_uint8_V9;
+        float const* m_V9;
+        uint16 const* m_uint16_V9;
+        uint8 const* m_uint8_V9;
     };
     union{
-        float* m_V8;
-        uint16* m_uint16_V8;
-        uint8* m_uint8_V8;
+        float const* m_V8;
+        uint16 const* m_uint16_V8;
+        uint8 const* m_uint8_V8;
     };
     G3D::Plane* _minHeightPlanes;
     // Height level data
@@ -46,13 +52,13 @@ class TC_GAME_API GridMap
     float _gridIntHeightMultiplier;
 
     // Area data
-    uint16* _areaMap;
+    uint16 const* _areaMap;
 
     // Liquid data
     float _liquidLevel;
-    uint16* _liquidEntry;
-    map_liquidHeaderTypeFlags* _liquidFlags;
-    float* _liquidMap;
+    uint16 const* _liquidEntry;
+    map_liquidHeaderTypeFlags const* _liquidFlags;
+    float const* _liquidMap;
     uint16 _gridArea;
     uint16 _liquidGlobalEntry;
     map_liquidHeaderTypeFlags _liquidGlobalFlags;
@@ -61,12 +67,21 @@ class TC_GAME_API GridMap
     uint8 _liquidWidth;
     uint8 _liquidHeight;
 
-    uint16* _holes;
+    uint16 const* _holes;
+
+    // the whole file is mapped read only, the data arrays above point into it so grids share the os page cache
+    // the mapping outlives the file handle, no descriptor is kept open per grid
+    std::unique_ptr<boost::interprocess::mapped_region> _region;
+    // copies of sections that are not aligned for their type, only needed for files from older extractors
+    std::vector<std::unique_ptr<char[]>> _copiedSections;
+
+    template<class T>
+    T const* mapSection(char const* data, uint32 count);
 
-    bool loadAreaData(FILE* in, uint32 offset, uint32 size);
-    bool loadHeightData(FILE* in, uint32 offset, uint32 size);
-    bool loadLiquidData(FILE* in, uint32 offset, uint32 size);
-    bool loadHolesData(FILE* in, uint32 offset, uint32 size);
+    bool loadAreaData(char const* data, uint32 size);
+    bool loadHeightData(char const* data, uint32 size);
+    bool loadLiquidData(char const* data, uint32 size);
+    bool loadHolesData(char const* data, uint32 size);
     bool isHole(int row, int col) const;
 
     // Get height functions and pointers
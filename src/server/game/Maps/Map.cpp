@@ -23,6 +23,7 @@
 #include "DatabaseEnv.h"
 #include "DBCStores.h"
 #include "DynamicTree.h"
+#include "FlightPathMovementGenerator.h"
 #include "GameObjectModel.h"
 #include "GameTime.h"
 #include "GridNotifiers.h"
@@ -45,7 +46,9 @@
 #include "PhasingHandler.h"
 #include "ScriptMgr.h"
 #include "TerrainMgr.h"
+#include "ThreadPool.h"
 #include "Transport.h"
+#include "UpdateData.h"
 #include "Vehicle.h"
 #include "VMapFactory.h"
 #include "VMapManager2.h"
@@ -60,6 +63,7 @@
 #endif
 
 #include <boost/heap/fibonacci_heap.hpp>
+#include <latch>
 #include <unordered_set>
 #include <vector>
 
@@ -142,9 +146,10 @@ _creatureToMoveLock(false), _gameObjectsToMoveLock(false), _dynamicObjectsToMove
 i_mapEntry(sMapStore.LookupEntry(id)), i_spawnMode(SpawnMode), i_InstanceId(InstanceId),
 m_unloadTimer(0), m_VisibleDistance(DEFAULT_VISIBILITY_DISTANCE),
 m_VisibilityNotifyPeriod(DEFAULT_VISIBILITY_NOTIFY_PERIOD),
-m_activeNonPlayersIter(m_activeNonPlayers.end()), _transportsUpdateIter(_transports.end()),
+_transportsUpdateIter(_transports.end()),
 i_gridExpiry(expiry), m_terrain(sTerrainMgr.LoadTerrain(id)),  m_forceEnabledNavMeshFilterFlags(0), m_forceDisabledNavMeshFilterFlags(0),
-i_scriptLock(false), _respawnTimes(std::make_unique<RespawnListContainer>()), _respawnCheckTimer(0)
+_regionUpdateActive(false), i_scriptLock(false), _respawnTimes(std::make_unique<RespawnListContainer>()), _respawnCheckTimer(0),
+_updateDataMap(std::make_unique<UpdateDataMap>()), _updatePacket(std::make_unique<WorldPacket>())
 {
     m_parentMap = (_parent ? _parent : this);
 #ifdef ELUNA
@@ -170,6 +175,7 @@ i_scriptLock(false), _respawnTimes(std::make_unique<RespawnListContainer>()), _r
     Map::InitVisibilityDistance();
 
     _weatherUpdateTimer.SetInterval(time_t(1 * IN_MILLISECONDS));
+    _gridPrefetchTimer.SetInterval(time_t(1 * IN_MILLISECONDS));
 
     _poolData = sPoolMgr->InitPoolsForMap(this);
 
@@ -365,6 +371,7 @@ void Map::DeleteFromWorld(Player* player)
 //But object data is not loaded here
 void Map::EnsureGridCreated(GridCoord const& p)
 {
+    auto regionLock = LockForRegionUpdate();
     if (!getNGrid(p.x_coord, p.y_coord))
     {
         TC_LOG_DEBUG("maps", "Creating grid[%u, %u] for map %u instance %u", p.x_coord, p.y_coord, GetId(), i_InstanceId);
@@ -385,6 +392,86 @@ void Map::EnsureGridCreated(GridCoord const& p)
     }
 }
 
+void Map::PrefetchGridsAhead(Trinity::ThreadPool& pool)
+{
+    float const lookahead = float(sWorld->getIntConfig(CONFIG_MAP_GRID_PREFETCH_LOOKAHEAD));
+    float const radius = GetVisibilityRange();
+
+    for (MapRefManager::iterator itr = m_mapRefManager.begin(); itr != m_mapRefManager.end(); ++itr)
+    {
+        Player* player = itr->GetSource();
+        if (!player || !player->IsInWorld())
+            continue;
+
+        if (player->GetMotionMaster()->GetCurrentMovementGeneratorType() == FLIGHT_MOTION_TYPE)
+        {
+            // follow the taxi route while it stays on this map
+            FlightPathMovementGenerator* flight = static_cast<FlightPathMovementGenerator*>(player->GetMotionMaster()->top());
+            TaxiPathNodeList const& path = flight->GetPath();
+            float x = player->GetPositionX();
+            float y = player->GetPositionY();
+            float remaining = PLAYER_FLIGHT_SPEED * lookahead;
+            for (uint32 i = flight->GetCurrentNode(); i < path.size() && remaining > 0.0f; ++i)
+            {
+                if (path[i]->ContinentID != GetId())
+                    break;
+
+                remaining -= std::hypot(path[i]->Loc.X - x, path[i]->Loc.Y - y);
+                x = path[i]->Loc.X;
+                y = path[i]->Loc.Y;
+                PrefetchGridsAround(x, y, radius, pool);
+            }
+        }
+        else if (player->isMoving())
+        {
+            float orientation = player->GetOrientation();
+            if (player->HasUnitMovementFlag(MOVEMENTFLAG_BACKWARD))
+                orientation += float(M_PI);
+
+            float const reach = player->GetSpeed(player->IsFlying() ? MOVE_FLIGHT : MOVE_RUN) * lookahead;
+            for (float dist = SIZE_OF_GRIDS / 2; dist < reach + SIZE_OF_GRIDS / 2; dist += SIZE_OF_GRIDS / 2)
+            {
+                dist = std::min(dist, reach);
+                PrefetchGridsAround(player->GetPositionX() + std::cos(orientation) * dist, player->GetPositionY() + std::sin(orientation) * dist, radius, pool);
+            }
+        }
+    }
+}
+
+void Map::PrefetchGridsAround(float x, float y, float radius, Trinity::ThreadPool& pool)
+{
+    if (!Trinity::IsValidMapCoord(x, y))
+        return;
+
+    float minX = x - radius, minY = y - radius, maxX = x + radius, maxY = y + radius;
+    Trinity::NormalizeMapCoord(minX);
+    Trinity::NormalizeMapCoord(minY);
+    Trinity::NormalizeMapCoord(maxX);
+    Trinity::NormalizeMapCoord(maxY);
+
+    GridCoord low = Trinity::ComputeGridCoord(minX, minY);
+    GridCoord high = Trinity::ComputeGridCoord(maxX, maxY);
+    for (uint32 gridX = low.x_coord; gridX <= high.x_coord; ++gridX)
+    {
+        for (uint32 gridY = low.y_coord; gridY <= high.y_coord; ++gridY)
+        {
+            if (getNGrid(gridX, gridY))
+                continue;
+
+            int32 gx = (MAX_NUMBER_OF_GRIDS - 1) - gridX;
+            int32 gy = (MAX_NUMBER_OF_GRIDS - 1) - gridY;
+            if (!m_terrain->RequestGridPrefetch(gx, gy))
+                continue;
+
+            pool.PostWork([terrain = std::weak_ptr<TerrainInfo>(m_terrain), gx, gy]()
+            {
+                if (std::shared_ptr<TerrainInfo> terrainRef = terrain.lock())
+                    terrainRef->PrefetchGrid(gx, gy);
+            });
+        }
+    }
+}
+
 //Load NGrid and make it active
 void Map::EnsureGridLoadedForActiveObject(const Cell &cell, WorldObject* object)
 {
@@ -404,6 +491,7 @@ void Map::EnsureGridLoadedForActiveObject(const Cell &cell, WorldObject* object)
 //Create NGrid and load the object data in it
 bool Map::EnsureGridLoaded(const Cell &cell)
 {
+    auto regionLock = LockForRegionUpdate();
     EnsureGridCreated(GridCoord(cell.GridX(), cell.GridY()));
     NGridType *grid = getNGrid(cell.GridX(), cell.GridY());
 
@@ -502,6 +590,8 @@ void Map::InitializeObject(GameObject* obj)
 template<class T>
 bool Map::AddToMap(T* obj)
 {
+    auto regionLock = LockForRegionUpdate();
+
     /// @todo Needs clean up. An object should not be added to map twice.
     if (obj->IsInWorld())
     {
@@ -589,33 +679,208 @@ bool Map::IsGridLoaded(const GridCoord &p) const
     return (getNGrid(p.x_coord, p.y_coord) && isGridObjectDataLoaded(p.x_coord, p.y_coord));
 }
 
-void Map::VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<Trinity::ObjectUpdater, GridTypeMapContainer> &gridVisitor, TypeContainerVisitor<Trinity::ObjectUpdater, WorldTypeMapContainer> &worldVisitor)
+void Map::MarkNearbyCellsOf(WorldObject* obj, WorldObject const* linkedTo /*= nullptr*/)
 {
     // Check for valid position
     if (!obj->IsPositionValid())
         return;
 
-    // Update mobs/objects in ALL visible cells around object!
     CellArea area = Cell::CalculateCellArea(obj->GetPositionX(), obj->GetPositionY(), obj->GetGridActivationRange());
 
     for (uint32 x = area.low_bound.x_coord; x <= area.high_bound.x_coord; ++x)
-    {
         for (uint32 y = area.low_bound.y_coord; y <= area.high_bound.y_coord; ++y)
+            markCell((y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x);
+
+    // objects updated because of another one (combat, auras) must end up in the same region
+    if (linkedTo && linkedTo->IsPositionValid())
+    {
+        GridCoord objGrid = Trinity::ComputeGridCoord(obj->GetPositionX(), obj->GetPositionY());
+        GridCoord linkedGrid = Trinity::ComputeGridCoord(linkedTo->GetPositionX(), linkedTo->GetPositionY());
+        _updateRegionLinks.emplace_back(objGrid.x_coord * MAX_NUMBER_OF_GRIDS + objGrid.y_coord, linkedGrid.x_coord * MAX_NUMBER_OF_GRIDS + linkedGrid.y_coord);
+    }
+}
+
+bool Map::CanUpdateByRegion()
+{
+    // instances are small and their scripts share state across the whole map
+    if (Instanceable() || !sMapMgr->GetRegionUpdatePool())
+        return false;
+
+    // outdoor pvp and battlefield zone scripts keep zone wide state that is not thread safe
+    if (sOutdoorPvPMgr->HasOutdoorPvPForMap(this) || sBattlefieldMgr->HasBattlefieldsForMap(this))
+        return false;
+
+#ifdef ELUNA
+    // the lua state of a map is not thread safe
+    if (GetEluna())
+        return false;
+#endif
+
+    return true;
+}
+
+void Map::UpdateCells(std::vector<uint32> const& cells, uint32 diff)
+{
+    Trinity::ObjectUpdater updater(diff);
+    TypeContainerVisitor<Trinity::ObjectUpdater, GridTypeMapContainer  > grid_object_update(updater);
+    TypeContainerVisitor<Trinity::ObjectUpdater, WorldTypeMapContainer > world_object_update(updater);
+
+    for (uint32 cellId : cells)
+    {
+        CellCoord pair(cellId % TOTAL_NUMBER_OF_CELLS_PER_MAP, cellId / TOTAL_NUMBER_OF_CELLS_PER_MAP);
+        Cell cell(pair);
+        cell.SetNoCreate();
+        Visit(cell, grid_object_update);
+        Visit(cell, world_object_update);
+    }
+}
+
+void Map::UpdateMarkedCells(uint32 diff)
+{
+    if (_updateRegions.empty())
+        _updateRegions.resize(1);
+
+    std::vector<uint32>& cells = _updateRegions.front();
+    cells.clear();
+
+    for (GridRefManager<NGridType>::iterator i = GridRefManager<NGridType>::begin(); i != GridRefManager<NGridType>::end(); ++i)
+    {
+        NGridType* grid = i->GetSource();
+        uint32 const cellX = grid->getX() * MAX_NUMBER_OF_CELLS;
+        uint32 const cellY = grid->getY() * MAX_NUMBER_OF_CELLS;
+        for (uint32 x = cellX; x < cellX + MAX_NUMBER_OF_CELLS; ++x)
         {
-            // marked cells are those that have been visited
-            // don't visit the same cell twice
-            uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
-            if (isCellMarked(cell_id))
-                continue;
+            for (uint32 y = cellY; y < cellY + MAX_NUMBER_OF_CELLS; ++y)
+            {
+                uint32 cellId = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
+                if (isCellMarked(cellId))
+                    cells.push_back(cellId);
+            }
+        }
+    }
+
+    _updateStatistics.CellsVisited = uint32(cells.size());
+    UpdateCells(cells, diff);
+}
 
-            markCell(cell_id);
-            CellCoord pair(x, y);
-            Cell cell(pair);
-            cell.SetNoCreate();
-            Visit(cell, gridVisitor);
-            Visit(cell, worldVisitor);
+void Map::UpdateMarkedCellsByRegion(uint32 diff)
+{
+    // union-find over grid ids, only entries of grids with marked cells are used
+    std::array<uint16, MAX_NUMBER_OF_GRIDS * MAX_NUMBER_OF_GRIDS> parent;
+    auto findRoot = [&parent](uint16 gridId)
+    {
+        while (parent[gridId] != gridId)
+            gridId = parent[gridId] = parent[parent[gridId]];
+        return gridId;
+    };
+
+    std::bitset<MAX_NUMBER_OF_GRIDS * MAX_NUMBER_OF_GRIDS> activeGrids;
+    std::vector<uint16> gridIds;
+    for (GridRefManager<NGridType>::iterator i = GridRefManager<NGridType>::begin(); i != GridRefManager<NGridType>::end(); ++i)
+    {
+        NGridType* grid = i->GetSource();
+        uint32 const cellX = grid->getX() * MAX_NUMBER_OF_CELLS;
+        uint32 const cellY = grid->getY() * MAX_NUMBER_OF_CELLS;
+        bool marked = false;
+        for (uint32 x = cellX; x < cellX + MAX_NUMBER_OF_CELLS && !marked; ++x)
+            for (uint32 y = cellY; y < cellY + MAX_NUMBER_OF_CELLS && !marked; ++y)
+                marked = isCellMarked((y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x);
+
+        if (!marked)
+            continue;
+
+        uint16 gridId = grid->getX() * MAX_NUMBER_OF_GRIDS + grid->getY();
+        parent[gridId] = gridId;
+        activeGrids.set(gridId);
+        gridIds.push_back(gridId);
+    }
+
+    // merge grids whose one grid wide halos overlap
+    for (uint16 gridId : gridIds)
+    {
+        int32 const gx = gridId / MAX_NUMBER_OF_GRIDS;
+        int32 const gy = gridId % MAX_NUMBER_OF_GRIDS;
+        for (int32 x = std::max(gx - 2, 0); x <= std::min(gx + 2, MAX_NUMBER_OF_GRIDS - 1); ++x)
+        {
+            for (int32 y = std::max(gy - 2, 0); y <= std::min(gy + 2, MAX_NUMBER_OF_GRIDS - 1); ++y)
+            {
+                uint16 otherId = x * MAX_NUMBER_OF_GRIDS + y;
+                if (otherId != gridId && activeGrids.test(otherId))
+                    parent[findRoot(otherId)] = findRoot(gridId);
+            }
+        }
+    }
+
+    for (std::pair<uint32, uint32> const& link : _updateRegionLinks)
+        if (activeGrids.test(link.first) && activeGrids.test(link.second))
+            parent[findRoot(link.first)] = findRoot(link.second);
+
+    _updateRegionLinks.clear();
+
+    std::array<int16, MAX_NUMBER_OF_GRIDS * MAX_NUMBER_OF_GRIDS> regionIndex;
+    std::size_t regionCount = 0;
+    for (uint16 gridId : gridIds)
+    {
+        uint16 root = findRoot(gridId);
+        if (root == gridId)
+            regionIndex[root] = int16(regionCount++);
+    }
+
+    if (_updateRegions.size() < regionCount)
+        _updateRegions.resize(regionCount);
+
+    for (std::size_t i = 0; i < regionCount; ++i)
+        _updateRegions[i].clear();
+
+    for (uint16 gridId : gridIds)
+    {
+        std::vector<uint32>& cells = _updateRegions[regionIndex[findRoot(gridId)]];
+        uint32 const cellX = (gridId / MAX_NUMBER_OF_GRIDS) * MAX_NUMBER_OF_CELLS;
+        uint32 const cellY = (gridId % MAX_NUMBER_OF_GRIDS) * MAX_NUMBER_OF_CELLS;
+        for (uint32 x = cellX; x < cellX + MAX_NUMBER_OF_CELLS; ++x)
+        {
+            for (uint32 y = cellY; y < cellY + MAX_NUMBER_OF_CELLS; ++y)
+            {
+                uint32 cellId = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
+                if (isCellMarked(cellId))
+                    cells.push_back(cellId);
+            }
         }
     }
+
+    _updateStatistics.CellsVisited = 0;
+    for (std::size_t i = 0; i < regionCount; ++i)
+        _updateStatistics.CellsVisited += uint32(_updateRegions[i].size());
+
+    if (regionCount <= 1)
+    {
+        if (regionCount)
+            UpdateCells(_updateRegions[0], diff);
+        return;
+    }
+
+    // biggest region stays on the map update thread
+    std::sort(_updateRegions.begin(), _updateRegions.begin() + regionCount, [](std::vector<uint32> const& left, std::vector<uint32> const& right)
+    {
+        return left.size() > right.size();
+    });
+
+    _regionUpdateActive = true;
+
+    std::latch regionsDone(regionCount - 1);
+    for (std::size_t i = 1; i < regionCount; ++i)
+    {
+        sMapMgr->GetRegionUpdatePool()->PostWork([this, i, diff, &regionsDone]()
+        {
+            UpdateCells(_updateRegions[i], diff);
+            regionsDone.count_down();
+        });
+    }
+
+    UpdateCells(_updateRegions[0], diff);
+    regionsDone.wait();
+
+    _regionUpdateActive = false;
 }
 
 void Map::UpdatePlayerZoneStats(uint32 oldZone, uint32 newZone)
@@ -660,13 +925,14 @@ void Map::Update(uint32 t_diff)
         _respawnCheckTimer -= t_diff;
 
     /// update active cells around players and active objects
+    /// every observer only marks the cells around it, the marked cells are then updated exactly once
     resetMarkedCells();
 
-    Trinity::ObjectUpdater updater(t_diff);
-    // for creature
-    TypeContainerVisitor<Trinity::ObjectUpdater, GridTypeMapContainer  > grid_object_update(updater);
-    // for pets
-    TypeContainerVisitor<Trinity::ObjectUpdater, WorldTypeMapContainer > world_object_update(updater);
+    bool const updateByRegion = CanUpdateByRegion();
+    auto markNearbyCellsOf = [this, updateByRegion](WorldObject* obj, WorldObject const* linkedTo)
+    {
+        MarkNearbyCellsOf(obj, updateByRegion ? linkedTo : nullptr);
+    };
 
     // the player iterator is stored in the map object
     // to make sure calls to Map::Remove don't invalidate it
@@ -680,61 +946,44 @@ void Map::Update(uint32 t_diff)
         // update players at tick
         player->Update(t_diff);
 
-        VisitNearbyCellsOf(player, grid_object_update, world_object_update);
+        markNearbyCellsOf(player, nullptr);
 
         // If player is using far sight or mind vision, visit that object too
         if (WorldObject* viewPoint = player->GetViewpoint())
-            VisitNearbyCellsOf(viewPoint, grid_object_update, world_object_update);
+            markNearbyCellsOf(viewPoint, player);
 
         // Handle updates for creatures in combat with player and are more than 60 yards away
         if (player->IsInCombat())
         {
-            std::vector<Unit*> toVisit;
             for (auto const& pair : player->GetCombatManager().GetPvECombatRefs())
                 if (Creature* unit = pair.second->GetOther(player)->ToCreature())
                     if (unit->GetMapId() == player->GetMapId() && !unit->IsWithinDistInMap(player, GetVisibilityRange(), false))
-                        toVisit.push_back(unit);
-            for (Unit* unit : toVisit)
-                VisitNearbyCellsOf(unit, grid_object_update, world_object_update);
+                        markNearbyCellsOf(unit, player);
         }
 
-        { // Update any creatures that own auras the player has applications of
-            std::unordered_set<Unit*> toVisit;
-            for (std::pair<uint32, AuraApplication*> pair : player->GetAppliedAuras())
-            {
-                if (Unit* caster = pair.second->GetBase()->GetCaster())
-                    if (caster->GetTypeId() != TYPEID_PLAYER && !caster->IsWithinDistInMap(player, GetVisibilityRange(), false))
-                        toVisit.insert(caster);
-            }
-            for (Unit* unit : toVisit)
-                VisitNearbyCellsOf(unit, grid_object_update, world_object_update);
-        }
-
-        { // Update any creatures that own auras the player has applications of
-            std::unordered_set<Unit*> toVisit;
-            for (std::pair<uint32, AuraApplication*> pair : player->GetAppliedAuras())
-            {
-                if (Unit* caster = pair.second->GetBase()->GetCaster())
-                    if (caster->GetTypeId() != TYPEID_PLAYER && !caster->IsWithinDistInMap(player, GetVisibilityRange(), false))
-                        toVisit.insert(caster);
-            }
-            for (Unit* unit : toVisit)
-                VisitNearbyCellsOf(unit, grid_object_update, world_object_update);
+        // Update any creatures that own auras the player has applications of
+        for (std::pair<uint32, AuraApplication*> pair : player->GetAppliedAuras())
+        {
+            if (Unit* caster = pair.second->GetBase()->GetCaster())
+                if (caster->GetTypeId() != TYPEID_PLAYER && !caster->IsWithinDistInMap(player, GetVisibilityRange(), false))
+                    markNearbyCellsOf(caster, player);
         }
     }
 
-    // non-player active objects, increasing iterator in the loop in case of object removal
-    for (m_activeNonPlayersIter = m_activeNonPlayers.begin(); m_activeNonPlayersIter != m_activeNonPlayers.end();)
+    // non-player active objects
+    for (WorldObject* obj : m_activeNonPlayers)
     {
-        WorldObject* obj = *m_activeNonPlayersIter;
-        ++m_activeNonPlayersIter;
-
         if (!obj || !obj->IsInWorld())
             continue;
 
-        VisitNearbyCellsOf(obj, grid_object_update, world_object_update);
+        markNearbyCellsOf(obj, nullptr);
     }
 
+    if (updateByRegion)
+        UpdateMarkedCellsByRegion(t_diff);
+    else
+        UpdateMarkedCells(t_diff);
+
     for (_transportsUpdateIter = _transports.begin(); _transportsUpdateIter != _transports.end();)
     {
         WorldObject* obj = *_transportsUpdateIter;
@@ -763,6 +1012,15 @@ void Map::Update(uint32 t_diff)
         _weatherUpdateTimer.Reset();
     }
 
+    _gridPrefetchTimer.Update(t_diff);
+    if (_gridPrefetchTimer.Passed())
+    {
+        if (Trinity::ThreadPool* prefetchPool = sMapMgr->GetGridPrefetchPool())
+            PrefetchGridsAhead(*prefetchPool);
+
+        _gridPrefetchTimer.Reset();
+    }
+
     MoveAllCreaturesInMoveList();
     MoveAllGameObjectsInMoveList();
 
@@ -888,6 +1146,7 @@ void Map::RemovePlayerFromMap(Player* player, bool remove)
 template<class T>
 void Map::RemoveFromMap(T *obj, bool remove)
 {
+    auto regionLock = LockForRegionUpdate();
     bool const inWorld = obj->IsInWorld() && obj->GetTypeId() >= TYPEID_UNIT && obj->GetTypeId() <= TYPEID_GAMEOBJECT;
     obj->RemoveFromWorld();
 
@@ -1080,6 +1339,7 @@ void Map::DynamicObjectRelocation(DynamicObject* dynObj, float x, float y, float
 
 void Map::AddCreatureToMoveList(Creature* c, float x, float y, float z, float ang)
 {
+    auto regionLock = LockForRegionUpdate();
     if (_creatureToMoveLock) //can this happen?
         return;
 
@@ -1090,6 +1350,7 @@ void Map::AddCreatureToMoveList(Creature* c, float x, float y, float z, float an
 
 void Map::RemoveCreatureFromMoveList(Creature* c)
 {
+    auto regionLock = LockForRegionUpdate();
     if (_creatureToMoveLock) //can this happen?
         return;
 
@@ -1099,6 +1360,7 @@ void Map::RemoveCreatureFromMoveList(Creature* c)
 
 void Map::AddGameObjectToMoveList(GameObject* go, float x, float y, float z, float ang)
 {
+    auto regionLock = LockForRegionUpdate();
     if (_gameObjectsToMoveLock) //can this happen?
         return;
 
@@ -1109,6 +1371,7 @@ void Map::AddGameObjectToMoveList(GameObject* go, float x, float y, float z, flo
 
 void Map::RemoveGameObjectFromMoveList(GameObject* go)
 {
+    auto regionLock = LockForRegionUpdate();
     if (_gameObjectsToMoveLock) //can this happen?
         return;
 
@@ -1118,6 +1381,7 @@ void Map::RemoveGameObjectFromMoveList(GameObject* go)
 
 void Map::AddDynamicObjectToMoveList(DynamicObject* dynObj, float x, float y, float z, float ang)
 {
+    auto regionLock = LockForRegionUpdate();
     if (_dynamicObjectsToMoveLock) //can this happen?
         return;
 
@@ -1128,6 +1392,7 @@ void Map::AddDynamicObjectToMoveList(DynamicObject* dynObj, float x, float y, fl
 
 void Map::RemoveDynamicObjectFromMoveList(DynamicObject* dynObj)
 {
+    auto regionLock = LockForRegionUpdate();
     if (_dynamicObjectsToMoveLock) //can this happen?
         return;
 
@@ -1585,6 +1850,7 @@ bool Map::IsUnderWater(PhaseShift const& phaseShift, float x, float y, float z)
 
 float Map::GetWaterOrGroundLevel(PhaseShift const& phaseShift, float x, float y, float z, float* ground, bool swim, float collisionHeight)
 {
+    auto lock = ReadLockDynamicTree();
     return m_terrain->GetWaterOrGroundLevel(phaseShift, GetId(), x, y, z, ground, swim, collisionHeight, &_dynamicTree);
 }
 
@@ -1593,9 +1859,12 @@ bool Map::isInLineOfSight(PhaseShift const& phaseShift, float x1, float y1, floa
     if ((checks & LINEOFSIGHT_CHECK_VMAP)
       && !VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(PhasingHandler::GetTerrainMapId(phaseShift, GetId(), m_terrain.get(), x1, y1), x1, y1, z1, x2, y2, z2, ignoreFlags))
         return false;
-    if (sWorld->getBoolConfig(CONFIG_CHECK_GOBJECT_LOS) && (checks & LINEOFSIGHT_CHECK_GOBJECT)
-      && !_dynamicTree.isInLineOfSight({x1, y1, z1}, {x2, y2, z2}, phaseShift))
-        return false;
+    if (sWorld->getBoolConfig(CONFIG_CHECK_GOBJECT_LOS) && (checks & LINEOFSIGHT_CHECK_GOBJECT))
+    {
+        auto lock = ReadLockDynamicTree();
+        if (!_dynamicTree.isInLineOfSight({x1, y1, z1}, {x2, y2, z2}, phaseShift))
+            return false;
+    }
     return true;
 }
 
@@ -1605,6 +1874,7 @@ bool Map::getObjectHitPos(PhaseShift const& phaseShift, float x1, float y1, floa
     G3D::Vector3 dstPos(x2, y2, z2);
 
     G3D::Vector3 resultPos;
+    auto lock = ReadLockDynamicTree();
     bool result = _dynamicTree.getObjectHitPos(startPos, dstPos, resultPos, modifyDist, phaseShift);
 
     rx = resultPos.x;
@@ -1811,26 +2081,48 @@ inline void Map::setNGrid(NGridType *grid, uint32 x, uint32 y)
     i_grids[x][y] = grid;
 }
 
-void Map::SendObjectUpdates()
+void Map::AddUpdateObject(Object* obj)
 {
-    UpdateDataMapType update_players;
+    auto regionLock = LockForRegionUpdate();
+    obj->SetUpdateObjectSlot(_updateObjects.size());
+    _updateObjects.push_back(obj);
+}
 
-    while (!_updateObjects.empty())
+void Map::RemoveUpdateObject(Object* obj)
+{
+    auto regionLock = LockForRegionUpdate();
+    // entries are only nulled, SendObjectUpdates may be iterating the container
+    std::size_t slot = obj->GetUpdateObjectSlot();
+    if (slot < _updateObjects.size() && _updateObjects[slot] == obj)
+        _updateObjects[slot] = nullptr;
+}
+
+void Map::SendObjectUpdates()
+{
+    // objects added while building updates are appended and still processed in this loop
+    for (std::size_t i = 0; i < _updateObjects.size(); ++i)
     {
-        Object* obj = *_updateObjects.begin();
+        Object* obj = _updateObjects[i];
+        if (!obj)
+            continue;
+
         ASSERT(obj->IsInWorld());
 
-        _updateObjects.erase(_updateObjects.begin());
-        obj->BuildUpdate(update_players);
+        _updateObjects[i] = nullptr;
+        _updateDataMap->ResetValuesUpdateBlocks();
+        obj->BuildUpdate(*_updateDataMap);
     }
 
-    WorldPacket packet;                                     // here we allocate a std::vector with a size of 0x10000
-    for (UpdateDataMapType::iterator iter = update_players.begin(); iter != update_players.end(); ++iter)
+    _updateObjects.clear();
+
+    for (UpdateDataMap::value_type& update : *_updateDataMap)
     {
-        iter->second.BuildPacket(&packet);
-        iter->first->SendDirectMessage(&packet);
-        packet.clear();                                     // clean the string
+        update.second.BuildPacket(_updatePacket.get());
+        update.first->SendDirectMessage(_updatePacket.get());
+        _updatePacket->clear();                             // keeps the buffer for the next player
     }
+
+    _updateDataMap->Reset();
 }
 
 // CheckRespawn MUST do one of the following:
@@ -2378,6 +2670,8 @@ void Map::AddObjectToRemoveList(WorldObject* obj)
 {
     ASSERT(obj->GetMapId() == GetId() && obj->GetInstanceId() == GetInstanceId());
 
+    auto regionLock = LockForRegionUpdate();
+
 #ifdef ELUNA
     if (Eluna* e = GetEluna())
     {
@@ -2403,6 +2697,7 @@ void Map::AddObjectToSwitchList(WorldObject* obj, bool on)
     if (obj->GetTypeId() != TYPEID_UNIT && obj->GetTypeId() != TYPEID_GAMEOBJECT)
         return;
 
+    auto regionLock = LockForRegionUpdate();
     std::map<WorldObject*, bool>::iterator itr = i_objectsToSwitch.find(obj);
     if (itr == i_objectsToSwitch.end())
         i_objectsToSwitch.insert(itr, std::make_pair(obj, on));
@@ -2540,6 +2835,7 @@ bool Map::ActiveObjectsNearGrid(NGridType const& ngrid) const
 
 void Map::AddToActive(WorldObject* obj)
 {
+    auto regionLock = LockForRegionUpdate();
     AddToActiveHelper(obj);
 
     Optional<Position> respawnLocation;
@@ -2579,6 +2875,7 @@ void Map::AddToActive(WorldObject* obj)
 
 void Map::RemoveFromActive(WorldObject* obj)
 {
+    auto regionLock = LockForRegionUpdate();
     RemoveFromActiveHelper(obj);
 
     Optional<Position> respawnLocation;
@@ -3198,26 +3495,31 @@ Player* Map::GetPlayer(ObjectGuid const& guid)
 
 AreaTrigger* Map::GetAreaTrigger(ObjectGuid const& guid)
 {
+    auto regionLock = LockForRegionUpdate();
     return _objectsStore.Find<AreaTrigger>(guid);
 }
 
 Corpse* Map::GetCorpse(ObjectGuid const& guid)
 {
+    auto regionLock = LockForRegionUpdate();
     return _objectsStore.Find<Corpse>(guid);
 }
 
 Creature* Map::GetCreature(ObjectGuid const& guid)
 {
+    auto regionLock = LockForRegionUpdate();
     return _objectsStore.Find<Creature>(guid);
 }
 
 DynamicObject* Map::GetDynamicObject(ObjectGuid const& guid)
 {
+    auto regionLock = LockForRegionUpdate();
     return _objectsStore.Find<DynamicObject>(guid);
 }
 
 Creature* Map::GetCreatureBySpawnId(ObjectGuid::LowType spawnId) const
 {
+    auto regionLock = LockForRegionUpdate();
     auto const bounds = GetCreatureBySpawnIdStore().equal_range(spawnId);
     if (bounds.first == bounds.second)
         return nullptr;
@@ -3232,6 +3534,7 @@ Creature* Map::GetCreatureBySpawnId(ObjectGuid::LowType spawnId) const
 
 GameObject* Map::GetGameObjectBySpawnId(ObjectGuid::LowType spawnId) const
 {
+    auto regionLock = LockForRegionUpdate();
     auto const bounds = GetGameObjectBySpawnIdStore().equal_range(spawnId);
     if (bounds.first == bounds.second)
         return nullptr;
@@ -3246,11 +3549,13 @@ GameObject* Map::GetGameObjectBySpawnId(ObjectGuid::LowType spawnId) const
 
 GameObject* Map::GetGameObject(ObjectGuid const& guid)
 {
+    auto regionLock = LockForRegionUpdate();
     return _objectsStore.Find<GameObject>(guid);
 }
 
 Pet* Map::GetPet(ObjectGuid const& guid)
 {
+    auto regionLock = LockForRegionUpdate();
     return _objectsStore.Find<Pet>(guid);
 }
 
@@ -3271,6 +3576,7 @@ void Map::UpdateIteratorBack(Player* player)
 
 void Map::SaveRespawnTime(SpawnObjectType type, ObjectGuid::LowType spawnId, uint32 entry, time_t respawnTime, uint32 gridId, CharacterDatabaseTransaction dbTrans, bool startup)
 {
+    auto regionLock = LockForRegionUpdate();
     SpawnMetadata const* data = sObjectMgr->GetSpawnMetadata(type, spawnId);
     if (!data)
     {
@@ -3436,6 +3742,7 @@ void Map::DeleteCorpseData()
 
 void Map::AddCorpse(Corpse* corpse)
 {
+    auto regionLock = LockForRegionUpdate();
     corpse->SetMap(this);
 
     _corpsesByCell[corpse->GetCellCoord().GetId()].insert(corpse);
@@ -3447,6 +3754,7 @@ void Map::AddCorpse(Corpse* corpse)
 
 void Map::RemoveCorpse(Corpse* corpse)
 {
+    auto regionLock = LockForRegionUpdate();
     ASSERT(corpse);
 
     corpse->UpdateObjectVisibilityOnDestroy();
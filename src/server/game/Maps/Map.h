@@ -27,6 +27,7 @@
 #include "MapDefines.h"
 #include "MapReference.h"
 #include "MapRefManager.h"
+#include "MapUpdater.h"
 #include "MPSCQueue.h"
 #include "ObjectGuid.h"
 #include "SharedDefines.h"
@@ -39,9 +40,12 @@
 #include "LuaValue.h"
 #endif
 
+#include <algorithm>
 #include <bitset>
 #include <list>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
 
 class Battleground;
 class BattlegroundMap;
@@ -58,6 +62,7 @@ class TempSummon;
 class TerrainInfo;
 class Transport;
 class Unit;
+class UpdateDataMap;
 class Weather;
 class WorldObject;
 class WorldPacket;
@@ -72,7 +77,7 @@ struct ScriptAction;
 struct ScriptInfo;
 struct SummonPropertiesEntry;
 enum Difficulty : uint8;
-namespace Trinity { struct ObjectUpdater; }
+namespace Trinity { struct ObjectUpdater; class ThreadPool; }
 namespace VMAP { enum class ModelIgnoreFlags : uint32; }
 
 namespace WorldPackets
@@ -196,7 +201,7 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         template<class T> bool AddToMap(T *);
         template<class T> void RemoveFromMap(T *, bool);
 
-        void VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<Trinity::ObjectUpdater, GridTypeMapContainer> &gridVisitor, TypeContainerVisitor<Trinity::ObjectUpdater, WorldTypeMapContainer> &worldVisitor);
+        void MarkNearbyCellsOf(WorldObject* obj, WorldObject const* linkedTo = nullptr);
         virtual void Update(uint32);
 
         float GetVisibilityRange() const { return m_VisibleDistance; }
@@ -341,6 +346,9 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         bool isCellMarked(uint32 pCellId) { return marked_cells.test(pCellId); }
         void markCell(uint32 pCellId) { marked_cells.set(pCellId); }
 
+        MapUpdateStatistics& GetUpdateStatistics() { return _updateStatistics; }
+        MapUpdateStatistics const& GetUpdateStatistics() const { return _updateStatistics; }
+
         bool HavePlayers() const { return !m_mapRefManager.isEmpty(); }
         uint32 GetPlayersCountExceptGMs() const;
         bool ActiveObjectsNearGrid(NGridType const& ngrid) const;
@@ -436,12 +444,13 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         BattlegroundMap const* ToBattlegroundMap() const { if (IsBattlegroundOrArena()) return reinterpret_cast<BattlegroundMap const*>(this); return nullptr; }
 
         bool isInLineOfSight(PhaseShift const& phaseShift, float x1, float y1, float z1, float x2, float y2, float z2, LineOfSightChecks checks, VMAP::ModelIgnoreFlags ignoreFlags) const;
-        void Balance() { _dynamicTree.balance(); }
-        void RemoveGameObjectModel(const GameObjectModel& model) { _dynamicTree.remove(model); }
-        void InsertGameObjectModel(const GameObjectModel& model) { _dynamicTree.insert(model); }
-        bool ContainsGameObjectModel(const GameObjectModel& model) const { return _dynamicTree.contains(model);}
+        void Balance() { auto lock = WriteLockDynamicTree(); _dynamicTree.balance(); }
+        void RemoveGameObjectModel(const GameObjectModel& model) { auto lock = WriteLockDynamicTree(); _dynamicTree.remove(model); }
+        void InsertGameObjectModel(const GameObjectModel& model) { auto lock = WriteLockDynamicTree(); _dynamicTree.insert(model); }
+        bool ContainsGameObjectModel(const GameObjectModel& model) const { auto lock = ReadLockDynamicTree(); return _dynamicTree.contains(model);}
         float GetGameObjectFloor(PhaseShift const& phaseShift, float x, float y, float z, float maxSearchDist = DEFAULT_HEIGHT_SEARCH) const
         {
+            auto lock = ReadLockDynamicTree();
             return _dynamicTree.getHeight(x, y, z, maxSearchDist, phaseShift);
         }
         bool getObjectHitPos(PhaseShift const& phaseShift, float x1, float y1, float z1, float x2, float y2, float z2, float& rx, float &ry, float& rz, float modifyDist);
@@ -494,6 +503,7 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         inline ObjectGuid::LowType GenerateLowGuid()
         {
             static_assert(ObjectGuidTraits<high>::MapSpecific, "Only map specific guid can be generated in Map context");
+            auto regionLock = LockForRegionUpdate();
             return GetGuidSequenceGenerator<high>().Generate();
         }
 
@@ -504,14 +514,39 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
             return GetGuidSequenceGenerator<high>().GetNextAfterMaxUsed();
         }
 
-        void AddUpdateObject(Object* obj)
+        void AddUpdateObject(Object* obj);
+        void RemoveUpdateObject(Object* obj);
+
+        // While grid regions of this map are updated concurrently (MapUpdate.GridRegions.Threads)
+        // every access to map wide containers must hold this lock, it is a no-op otherwise.
+        // Objects are only deleted outside of the region update, so pointers returned by the
+        // locked getters stay valid until it ends. Objects of another region may still be
+        // updated concurrently and must only be read through thread safe accessors.
+        // Script and global state (zone scripts, script static data) is not audited for
+        // concurrent access, see CanUpdateByRegion for the maps that are kept serial.
+        std::unique_lock<std::recursive_mutex> LockForRegionUpdate() const
         {
-            _updateObjects.insert(obj);
+            if (!_regionUpdateActive)
+                return std::unique_lock<std::recursive_mutex>();
+
+            return std::unique_lock<std::recursive_mutex>(_regionUpdateLock);
         }
 
-        void RemoveUpdateObject(Object* obj)
+        // Game object models are inserted and removed by regions while others query line of sight
+        std::shared_lock<std::shared_mutex> ReadLockDynamicTree() const
         {
-            _updateObjects.erase(obj);
+            if (!_regionUpdateActive)
+                return std::shared_lock<std::shared_mutex>();
+
+            return std::shared_lock<std::shared_mutex>(_dynamicTreeLock);
+        }
+
+        std::unique_lock<std::shared_mutex> WriteLockDynamicTree() const
+        {
+            if (!_regionUpdateActive)
+                return std::unique_lock<std::shared_mutex>();
+
+            return std::unique_lock<std::shared_mutex>(_dynamicTreeLock);
         }
 
     private:
@@ -580,7 +615,6 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
 
         typedef std::set<WorldObject*> ActiveNonPlayers;
         ActiveNonPlayers m_activeNonPlayers;
-        ActiveNonPlayers::iterator m_activeNonPlayersIter;
 
         // Objects that must update even in inactive grids without activating them
         typedef std::set<Transport*> TransportsContainer;
@@ -607,6 +641,28 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         NGridType* i_grids[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
         std::bitset<TOTAL_NUMBER_OF_CELLS_PER_MAP*TOTAL_NUMBER_OF_CELLS_PER_MAP> marked_cells;
 
+        MapUpdateStatistics _updateStatistics;
+
+        // Updates the objects of every marked cell once
+        void UpdateMarkedCells(uint32 diff);
+
+        // Splits the marked cells into regions that are at least one grid apart and not linked by
+        // combat or auras, then updates the objects of each region on its own thread
+        bool CanUpdateByRegion();
+        void UpdateMarkedCellsByRegion(uint32 diff);
+        void UpdateCells(std::vector<uint32> const& cells, uint32 diff);
+
+        bool _regionUpdateActive;
+        mutable std::recursive_mutex _regionUpdateLock;
+        mutable std::shared_mutex _dynamicTreeLock;
+        std::vector<std::pair<uint32, uint32>> _updateRegionLinks;
+        std::vector<std::vector<uint32>> _updateRegions;
+
+        // Queues the terrain files of grids that moving players are about to enter on the prefetch pool
+        void PrefetchGridsAhead(Trinity::ThreadPool& pool);
+        void PrefetchGridsAround(float x, float y, float radius, Trinity::ThreadPool& pool);
+        IntervalTimer _gridPrefetchTimer;
+
         //these functions used to process player/mob aggro reactions and
         //visibility calculations. Highly optimized for massive calculations
         void ProcessRelocationNotifies(uint32 diff);
@@ -699,18 +755,7 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
 
         void RemoveFromActiveHelper(WorldObject* obj)
         {
-            // Map::Update for active object in proccess
-            if (m_activeNonPlayersIter != m_activeNonPlayers.end())
-            {
-                ActiveNonPlayers::iterator itr = m_activeNonPlayers.find(obj);
-                if (itr == m_activeNonPlayers.end())
-                    return;
-                if (itr == m_activeNonPlayersIter)
-                    ++m_activeNonPlayersIter;
-                m_activeNonPlayers.erase(itr);
-            }
-            else
-                m_activeNonPlayers.erase(obj);
+            m_activeNonPlayers.erase(obj);
         }
 
         std::unique_ptr<RespawnListContainer> _respawnTimes;
@@ -770,7 +815,11 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         std::unordered_map<ObjectGuid, Corpse*> _corpsesByPlayer;
         std::unordered_set<Corpse*> _corpseBones;
 
-        std::unordered_set<Object*> _updateObjects;
+        // objects are added once per tick (guarded by Object::m_objectUpdated), removed objects are left as nullptr
+        std::vector<Object*> _updateObjects;
+        // reused by every SendObjectUpdates call to avoid reallocating per player buffers each tick
+        std::unique_ptr<UpdateDataMap> _updateDataMap;
+        std::unique_ptr<WorldPacket> _updatePacket;
 
         MPSCQueue<FarSpellCallback> _farSpellCallbacks;
 #ifdef ELUNA
@@ -24,9 +24,11 @@
 #include "InstanceSaveMgr.h"
 #include "Log.h"
 #include "Map.h"
+#include "Metric.h"
 #include "ObjectMgr.h"
 #include "Player.h"
 #include "ScriptMgr.h"
+#include "ThreadPool.h"
 #include "World.h"
 #include "WorldStateMgr.h"
 #ifdef ELUNA
@@ -53,6 +55,12 @@ void MapManager::Initialize()
     // Start mtmaps if needed.
     if (num_threads > 0)
         m_updater.activate(num_threads);
+
+    if (uint32 regionThreads = sWorld->getIntConfig(CONFIG_MAP_UPDATE_REGION_THREADS))
+        _regionUpdatePool = std::make_unique<Trinity::ThreadPool>(regionThreads);
+
+    if (uint32 prefetchThreads = sWorld->getIntConfig(CONFIG_MAP_GRID_PREFETCH_THREADS))
+        _gridPrefetchPool = std::make_unique<Trinity::ThreadPool>(prefetchThreads);
 }
 
 void MapManager::InitializeVisibilityDistanceInfo()
@@ -361,7 +369,7 @@ void MapManager::Update(uint32 diff)
         if (m_updater.activated())
             m_updater.schedule_update(*iter->second, uint32(i_timer.GetCurrent()));
         else
-            iter->second->Update(uint32(i_timer.GetCurrent()));
+            MapUpdater::update_map(*iter->second, uint32(i_timer.GetCurrent()));
 
         ++iter;
     }
@@ -374,6 +382,32 @@ void MapManager::Update(uint32 diff)
     i_timer.SetCurrent(0);
 }
 
+void MapManager::LogUpdateStatistics()
+{
+    std::shared_lock<std::shared_mutex> lock(_mapsLock);
+    for (auto iter = i_maps.begin(); iter != i_maps.end(); ++iter)
+    {
+        MapUpdateStatistics& stats = iter->second->GetUpdateStatistics();
+        if (!stats.Samples)
+            continue;
+
+        std::string mapId = std::to_string(iter->first.first);
+        std::string instanceId = std::to_string(iter->first.second);
+
+        TC_METRIC_VALUE("map_update_time_max", stats.MaxDuration, TC_METRIC_TAG("map_id", mapId), TC_METRIC_TAG("instance_id", instanceId));
+        TC_METRIC_VALUE("map_update_time_avg", uint32(stats.TotalDuration / stats.Samples), TC_METRIC_TAG("map_id", mapId), TC_METRIC_TAG("instance_id", instanceId));
+        TC_METRIC_VALUE("map_update_cells_visited", uint32(stats.TotalCellsVisited / stats.Samples), TC_METRIC_TAG("map_id", mapId), TC_METRIC_TAG("instance_id", instanceId));
+
+        for (std::size_t i = 0; i < stats.Buckets.size(); ++i)
+        {
+            std::string bound = i < MapUpdateStatistics::BucketBounds.size() ? std::to_string(MapUpdateStatistics::BucketBounds[i]) : "inf";
+            TC_METRIC_VALUE("map_update_time_histogram", stats.Buckets[i], TC_METRIC_TAG("map_id", mapId), TC_METRIC_TAG("instance_id", instanceId), TC_METRIC_TAG("le", bound));
+        }
+
+        stats.ResetHistogram();
+    }
+}
+
 bool MapManager::DestroyMap(Map* map)
 {
     map->RemoveAllPlayers();
@@ -411,6 +445,18 @@ void MapManager::UnloadAll()
     if (m_updater.activated())
         m_updater.deactivate();
 
+    if (_regionUpdatePool)
+    {
+        _regionUpdatePool->Join();
+        _regionUpdatePool.reset();
+    }
+
+    if (_gridPrefetchPool)
+    {
+        _gridPrefetchPool->Join();
+        _gridPrefetchPool.reset();
+    }
+
     Map::DeleteStateMachine();
 }
 
@@ -35,6 +35,11 @@ class Map;
 class Player;
 enum Difficulty : uint8;
 
+namespace Trinity
+{
+    class ThreadPool;
+}
+
 class TC_GAME_API MapManager
 {
         MapManager();
@@ -113,6 +118,11 @@ class TC_GAME_API MapManager
         void FreeInstanceId(uint32 instanceId);
 
         MapUpdater * GetMapUpdater() { return &m_updater; }
+        Trinity::ThreadPool* GetRegionUpdatePool() const { return _regionUpdatePool.get(); }
+        Trinity::ThreadPool* GetGridPrefetchPool() const { return _gridPrefetchPool.get(); }
+
+        // sends the per map update duration histograms to sMetric and starts new ones
+        void LogUpdateStatistics();
 
         template<typename Worker>
         void DoForAllMaps(Worker&& worker);
@@ -148,6 +158,8 @@ class TC_GAME_API MapManager
         std::unique_ptr<InstanceIds> _freeInstanceIds;
         uint32 _nextInstanceId;
         MapUpdater m_updater;
+        std::unique_ptr<Trinity::ThreadPool> _regionUpdatePool;
+        std::unique_ptr<Trinity::ThreadPool> _gridPrefetchPool;
 
         // atomic op counter for active scripts amount
         std::atomic<std::size_t> _scheduledScripts;
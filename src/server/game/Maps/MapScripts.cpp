@@ -32,6 +32,8 @@
 /// Put scripts in the execution queue
 void Map::ScriptsStart(std::map<uint32, std::multimap<uint32, ScriptInfo>> const& scripts, uint32 id, Object* source, Object* target)
 {
+    auto regionLock = LockForRegionUpdate();
+
     ///- Find the script map
     ScriptMapMap::const_iterator s = scripts.find(id);
     if (s == scripts.end())
@@ -60,7 +62,8 @@ void Map::ScriptsStart(std::map<uint32, std::multimap<uint32, ScriptInfo>> const
         sMapMgr->IncreaseScheduledScriptsCount();
     }
     ///- If one of the effects should be immediate, launch the script execution
-    if (/*start &&*/ immedScript && !i_scriptLock)
+    ///- (scripts started during a region update run in the serial part of Map::Update instead)
+    if (/*start &&*/ immedScript && !i_scriptLock && !_regionUpdateActive)
     {
         i_scriptLock = true;
         ScriptsProcess();
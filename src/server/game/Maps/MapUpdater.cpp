@@ -17,71 +17,111 @@
 
 #include "MapUpdater.h"
 #include "Map.h"
+#include <algorithm>
+#include <chrono>
 
-#include <mutex>
-
-
-class MapUpdateRequest
+void MapUpdateStatistics::AddSample(uint32 duration)
 {
-    private:
-
-        Map& m_map;
-        MapUpdater& m_updater;
-        uint32 m_diff;
-
-    public:
-
-        MapUpdateRequest(Map& m, MapUpdater& u, uint32 d)
-            : m_map(m), m_updater(u), m_diff(d)
-        {
-        }
+    LastDuration = duration;
+    MaxDuration = std::max(MaxDuration, duration);
+    TotalDuration += duration;
+    TotalCellsVisited += CellsVisited;
+    ++Samples;
+
+    auto bucket = std::lower_bound(BucketBounds.begin(), BucketBounds.end(), duration);
+    ++Buckets[std::distance(BucketBounds.begin(), bucket)];
+}
 
-        void call()
-        {
-            m_map.Update (m_diff);
-            m_updater.update_finished();
-        }
-};
+void MapUpdateStatistics::ResetHistogram()
+{
+    MaxDuration = 0;
+    TotalDuration = 0;
+    TotalCellsVisited = 0;
+    Samples = 0;
+    Buckets.fill(0);
+}
 
 void MapUpdater::activate(size_t num_threads)
 {
+    for (size_t i = 0; i < num_threads; ++i)
+        _queues.push_back(std::make_unique<WorkerQueue>());
+
     for (size_t i = 0; i < num_threads; ++i)
     {
-        _workerThreads.push_back(std::thread(&MapUpdater::WorkerThread, this));
+        _workerThreads.push_back(std::thread(&MapUpdater::WorkerThread, this, i));
     }
 }
 
 void MapUpdater::deactivate()
 {
-    _cancelationToken = true;
-
     wait();
 
-    _queue.Cancel();
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _cancelationToken = true;
+    }
+
+    _workCondition.notify_all();
 
     for (auto& thread : _workerThreads)
     {
         thread.join();
     }
+
+    _workerThreads.clear();
+    _queues.clear();
 }
 
 void MapUpdater::wait()
 {
-    std::unique_lock<std::mutex> lock(_lock);
+    if (_scheduled.empty())
+        return;
+
+    // Longest processing time first: hand out the most expensive maps (by their previous update)
+    // first, each to the worker with the least estimated work so far
+    std::stable_sort(_scheduled.begin(), _scheduled.end(), [](MapUpdateRequest const& left, MapUpdateRequest const& right)
+    {
+        return left.cost > right.cost;
+    });
+
+    _pendingRequests = _scheduled.size();
+
+    for (std::unique_ptr<WorkerQueue>& queue : _queues)
+        queue->load = 0;
+
+    for (MapUpdateRequest const& request : _scheduled)
+    {
+        WorkerQueue& queue = **std::min_element(_queues.begin(), _queues.end(), [](std::unique_ptr<WorkerQueue> const& left, std::unique_ptr<WorkerQueue> const& right)
+        {
+            return left->load < right->load;
+        });
+
+        // count every map at least once so that maps without history are spread too
+        queue.load += std::max<uint32>(request.cost, 1);
+
+        std::lock_guard<std::mutex> lock(queue.lock);
+        if (queue.head == queue.tail)
+        {
+            queue.requests.clear();
+            queue.head = queue.tail = 0;
+        }
+
+        queue.requests.push_back(request);
+        ++queue.tail;
+    }
+
+    _scheduled.clear();
 
-    while (pending_requests > 0)
-        _condition.wait(lock);
+    std::unique_lock<std::mutex> lock(_lock);
+    ++_generation;
+    _workCondition.notify_all();
 
-    lock.unlock();
+    _finishedCondition.wait(lock, [this] { return _pendingRequests == 0; });
 }
 
 void MapUpdater::schedule_update(Map& map, uint32 diff)
 {
-    std::lock_guard<std::mutex> lock(_lock);
-
-    ++pending_requests;
-
-    _queue.Push(new MapUpdateRequest(map, *this, diff));
+    _scheduled.push_back({ &map, diff, map.GetUpdateStatistics().LastDuration });
 }
 
 bool MapUpdater::activated()
@@ -89,28 +129,74 @@ bool MapUpdater::activated()
     return _workerThreads.size() > 0;
 }
 
-void MapUpdater::update_finished()
+void MapUpdater::update_map(Map& map, uint32 diff)
 {
-    std::lock_guard<std::mutex> lock(_lock);
+    using namespace std::chrono;
 
-    --pending_requests;
+    steady_clock::time_point start = steady_clock::now();
 
-    _condition.notify_all();
+    map.Update(diff);
+
+    map.GetUpdateStatistics().AddSample(uint32(duration_cast<microseconds>(steady_clock::now() - start).count()));
 }
 
-void MapUpdater::WorkerThread()
+bool MapUpdater::pop_request(size_t worker, MapUpdateRequest& request)
 {
-    while (1)
+    WorkerQueue& queue = *_queues[worker];
+    std::lock_guard<std::mutex> lock(queue.lock);
+    if (queue.head == queue.tail)
+        return false;
+
+    request = queue.requests[queue.head++];
+    return true;
+}
+
+bool MapUpdater::steal_request(size_t worker, MapUpdateRequest& request)
+{
+    for (size_t i = 1; i < _queues.size(); ++i)
     {
-        MapUpdateRequest* request = nullptr;
+        WorkerQueue& queue = *_queues[(worker + i) % _queues.size()];
+        std::lock_guard<std::mutex> lock(queue.lock);
+        if (queue.head == queue.tail)
+            continue;
+
+        request = queue.requests[--queue.tail];
+        return true;
+    }
 
-        _queue.WaitAndPop(request);
+    return false;
+}
+
+void MapUpdater::update_finished()
+{
+    if (--_pendingRequests > 0)
+        return;
+
+    std::lock_guard<std::mutex> lock(_lock);
+    _finishedCondition.notify_all();
+}
+
+void MapUpdater::WorkerThread(size_t worker)
+{
+    uint32 generation = 0;
+
+    while (1)
+    {
+        {
+            std::unique_lock<std::mutex> lock(_lock);
+            _workCondition.wait(lock, [&] { return _cancelationToken || _generation != generation; });
 
-        if (_cancelationToken)
-            return;
+            if (_cancelationToken)
+                return;
 
-        request->call();
+            generation = _generation;
+        }
 
-        delete request;
+        MapUpdateRequest request;
+        while (pop_request(worker, request) || steal_request(worker, request))
+        {
+            update_map(*request.map, request.diff);
+            update_finished();
+        }
     }
 }
@@ -19,23 +19,42 @@
 #define _MAP_UPDATER_H_INCLUDED
 
 #include "Define.h"
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
 #include <mutex>
 #include <thread>
-#include <condition_variable>
-#include "ProducerConsumerQueue.h"
+#include <vector>
 
-class MapUpdateRequest;
 class Map;
 
+// Update duration samples of a single map, written by whichever thread updated the map
+// and read by the world thread once all updates of the tick have finished
+struct TC_GAME_API MapUpdateStatistics
+{
+    // upper bounds (in microseconds) of the histogram buckets, the last bucket is unbounded
+    static constexpr std::array<uint32, 10> BucketBounds = { 250, 500, 1000, 2000, 4000, 8000, 16000, 32000, 64000, 128000 };
+
+    void AddSample(uint32 duration);
+    void ResetHistogram();
+
+    uint32 LastDuration = 0;
+    uint32 MaxDuration = 0;
+    uint64 TotalDuration = 0;
+    uint32 Samples = 0;
+    uint32 CellsVisited = 0;                        // cells whose objects were updated during the last update
+    uint64 TotalCellsVisited = 0;
+    std::array<uint32, BucketBounds.size() + 1> Buckets = { };
+};
+
 class TC_GAME_API MapUpdater
 {
     public:
 
-        MapUpdater() : _cancelationToken(false), pending_requests(0) {}
+        MapUpdater() : _cancelationToken(false), _generation(0), _pendingRequests(0) {}
         ~MapUpdater() { };
 
-        friend class MapUpdateRequest;
-
         void schedule_update(Map& map, uint32 diff);
 
         void wait();
@@ -46,20 +65,47 @@ class TC_GAME_API MapUpdater
 
         bool activated();
 
+        static void update_map(Map& map, uint32 diff);
+
     private:
 
-        ProducerConsumerQueue<MapUpdateRequest*> _queue;
+        struct MapUpdateRequest
+        {
+            Map* map;
+            uint32 diff;
+            uint32 cost;
+        };
+
+        // Requests assigned to a single worker. The owner pops from the front (most expensive
+        // maps first) while idle workers steal from the back (cheapest maps first).
+        struct WorkerQueue
+        {
+            std::mutex lock;
+            std::vector<MapUpdateRequest> requests;
+            size_t head = 0;
+            size_t tail = 0;
+            uint64 load = 0;
+        };
+
+        bool pop_request(size_t worker, MapUpdateRequest& request);
+        bool steal_request(size_t worker, MapUpdateRequest& request);
+
+        void update_finished();
+
+        void WorkerThread(size_t worker);
+
+        // requests of the current tick, reused between ticks to avoid reallocations
+        std::vector<MapUpdateRequest> _scheduled;
+        std::vector<std::unique_ptr<WorkerQueue>> _queues;
 
         std::vector<std::thread> _workerThreads;
         std::atomic<bool> _cancelationToken;
 
         std::mutex _lock;
-        std::condition_variable _condition;
-        size_t pending_requests;
-
-        void update_finished();
-
-        void WorkerThread();
+        std::condition_variable _workCondition;
+        std::condition_variable _finishedCondition;
+        uint32 _generation;
+        std::atomic<size_t> _pendingRequests;
 };
 
 #endif //_MAP_UPDATER_H_INCLUDED
@@ -38,6 +38,7 @@ TerrainInfo::TerrainInfo(uint32 mapId) : _mapId(mapId), _parentTerrain(nullptr),
 
 TerrainInfo::~TerrainInfo()
 {
+    ReleasePrefetchedGrids(true);
     VMAP::VMapFactory::createOrGetVMapManager()->unloadMap(GetId());
     MMAP::MMapFactory::createOrGetMMapManager()->unloadMap(GetId());
 }
@@ -171,12 +172,137 @@ void TerrainInfo::LoadMMapInstance(uint32 mapId, uint32 instanceId)
         childTerrain->LoadMMapInstanceImpl(mapId, instanceId);
 }
 
+bool TerrainInfo::RequestGridPrefetch(int32 gx, int32 gy)
+{
+    if (_referenceCountFromMap[gx][gy] || _loadedGrids[GetBitsetIndex(gx, gy)])
+        return false;
+
+    std::lock_guard<std::mutex> lock(_prefetchMutex);
+    return _prefetchedGrids.try_emplace(GetBitsetIndex(gx, gy)).second;
+}
+
+void TerrainInfo::PrefetchGrid(int32 gx, int32 gy)
+{
+    PrefetchGridImpl(gx, gy);
+
+    for (std::shared_ptr<TerrainInfo> const& childTerrain : _childTerrain)
+    {
+        {
+            std::lock_guard<std::mutex> lock(childTerrain->_prefetchMutex);
+            if (!childTerrain->_prefetchedGrids.try_emplace(GetBitsetIndex(gx, gy)).second)
+                continue;
+        }
+
+        childTerrain->PrefetchGridImpl(gx, gy);
+    }
+}
+
+static void ReadAhead(std::string const& fileName)
+{
+    // only pulls the file into the os page cache, parsing it stays with the loader
+    if (auto file = Trinity::make_unique_ptr_with_deleter(fopen(fileName.c_str(), "rb"), &::fclose))
+    {
+        char buffer[64 * 1024];
+        while (fread(buffer, 1, sizeof(buffer), file.get()) == sizeof(buffer)) { }
+    }
+}
+
+void TerrainInfo::PrefetchGridImpl(int32 gx, int32 gy)
+{
+    {
+        std::lock_guard<std::mutex> lock(_prefetchMutex);
+        auto itr = _prefetchedGrids.find(GetBitsetIndex(gx, gy));
+        if (itr == _prefetchedGrids.end() || itr->second.Ready)
+            return;
+    }
+
+    std::unique_ptr<GridMap> gridMap;
+    if (_gridFileExists[GetBitsetIndex(gx, gy)])
+    {
+        std::string fileName = Trinity::StringFormat("%smaps/%03u%02u%02u.map", sWorld->GetDataPath().c_str(), GetId(), gx, gy);
+        gridMap = std::make_unique<GridMap>();
+        if (gridMap->loadData(fileName.c_str()) != GridMap::LoadResult::Ok)
+            gridMap = nullptr;
+    }
+
+    VMAP::VMapManager2* vmgr = VMAP::VMapFactory::createOrGetVMapManager();
+    std::vector<std::string> models = vmgr->acquireMapTileModels((sWorld->GetDataPath() + "vmaps").c_str(), GetId(), gx, gy);
+
+    if (DisableMgr::IsPathfindingEnabled(GetId()))
+        ReadAhead(Trinity::StringFormat("%smmaps/%03i%02i%02i.mmtile", sWorld->GetDataPath().c_str(), GetId(), gx, gy));
+
+    {
+        std::lock_guard<std::mutex> lock(_prefetchMutex);
+        auto itr = _prefetchedGrids.find(GetBitsetIndex(gx, gy));
+        if (itr != _prefetchedGrids.end())
+        {
+            itr->second.Map = std::move(gridMap);
+            itr->second.VMapModels = std::move(models);
+            itr->second.Ready = true;
+            return;
+        }
+    }
+
+    // the grid was loaded while we were reading it
+    for (std::string const& model : models)
+        vmgr->releaseModelInstance(model);
+}
+
+void TerrainInfo::ReleasePrefetchedGrids(bool all)
+{
+    std::vector<std::string> models;
+    {
+        std::lock_guard<std::mutex> lock(_prefetchMutex);
+        for (auto itr = _prefetchedGrids.begin(); itr != _prefetchedGrids.end();)
+        {
+            PrefetchedGrid& prefetched = itr->second;
+            if (all || (prefetched.Ready && prefetched.Expiring))
+            {
+                std::move(prefetched.VMapModels.begin(), prefetched.VMapModels.end(), std::back_inserter(models));
+                itr = _prefetchedGrids.erase(itr);
+                continue;
+            }
+
+            // nobody entered the grid since the last cleanup, drop it on the next one
+            if (prefetched.Ready)
+                prefetched.Expiring = true;
+            ++itr;
+        }
+    }
+
+    VMAP::VMapManager2* vmgr = VMAP::VMapFactory::createOrGetVMapManager();
+    for (std::string const& model : models)
+        vmgr->releaseModelInstance(model);
+
+    // PrefetchGrid reserves the grid in the child terrains too
+    for (std::shared_ptr<TerrainInfo> const& childTerrain : _childTerrain)
+        childTerrain->ReleasePrefetchedGrids(all);
+}
+
 void TerrainInfo::LoadMapAndVMapImpl(int32 gx, int32 gy)
 {
-    LoadMap(gx, gy);
+    PrefetchedGrid prefetched;
+    {
+        std::lock_guard<std::mutex> lock(_prefetchMutex);
+        auto itr = _prefetchedGrids.find(GetBitsetIndex(gx, gy));
+        if (itr != _prefetchedGrids.end())
+        {
+            // a prefetch still being read is discarded by the worker
+            if (itr->second.Ready)
+                prefetched = std::move(itr->second);
+            _prefetchedGrids.erase(itr);
+        }
+    }
+
+    LoadMap(gx, gy, std::move(prefetched.Map));
     LoadVMap(gx, gy);
     LoadMMap(gx, gy);
 
+    // the vmap tile holds its own model references now
+    VMAP::VMapManager2* vmgr = VMAP::VMapFactory::createOrGetVMapManager();
+    for (std::string const& model : prefetched.VMapModels)
+        vmgr->releaseModelInstance(model);
+
     for (std::shared_ptr<TerrainInfo> const& childTerrain : _childTerrain)
         childTerrain->LoadMapAndVMapImpl(gx, gy);
 
@@ -188,7 +314,7 @@ void TerrainInfo::LoadMMapInstanceImpl(uint32 mapId, uint32 instanceId)
     MMAP::MMapFactory::createOrGetMMapManager()->loadMapInstance(sWorld->GetDataPath(), _mapId, mapId, instanceId);
 }
 
-void TerrainInfo::LoadMap(int32 gx, int32 gy)
+void TerrainInfo::LoadMap(int32 gx, int32 gy, std::unique_ptr<GridMap> prefetched /*= nullptr*/)
 {
     if (_gridMap[gx][gy])
         return;
@@ -196,6 +322,13 @@ void TerrainInfo::LoadMap(int32 gx, int32 gy)
     if (!_gridFileExists[GetBitsetIndex(gx, gy)])
         return;
 
+    if (prefetched)
+    {
+        TC_LOG_DEBUG("maps", "Using prefetched map %03u%02u%02u.map", GetId(), gx, gy);
+        _gridMap[gx][gy] = std::move(prefetched);
+        return;
+    }
+
     // map file name
     std::string fileName = Trinity::StringFormat("%smaps/%03u%02u%02u.map", sWorld->GetDataPath().c_str(), GetId(), gx, gy);
     TC_LOG_DEBUG("maps", "Loading map %s", fileName.c_str());
@@ -317,6 +450,8 @@ void TerrainInfo::CleanUpGrids(uint32 diff)
             if (_loadedGrids[GetBitsetIndex(x, y)] && !_referenceCountFromMap[x][y])
                 UnloadMapImpl(x, y);
 
+    ReleasePrefetchedGrids(false);
+
     _cleanupTimer.Reset(CleanupInterval.count());
 }
 
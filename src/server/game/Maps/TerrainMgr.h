@@ -28,6 +28,7 @@
 #include <bitset>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -59,10 +60,17 @@ public:
     void LoadMapAndVMap(int32 gx, int32 gy);
     void LoadMMapInstance(uint32 mapId, uint32 instanceId);
 
+    // Reserves a prefetch of the grid files, returns false if the grid is loaded or already queued
+    bool RequestGridPrefetch(int32 gx, int32 gy);
+    // Reads the grid files of a reserved prefetch, called from a worker thread
+    void PrefetchGrid(int32 gx, int32 gy);
+
 private:
     void LoadMapAndVMapImpl(int32 gx, int32 gy);
     void LoadMMapInstanceImpl(uint32 mapId, uint32 instanceId);
-    void LoadMap(int32 gx, int32 gy);
+    void PrefetchGridImpl(int32 gx, int32 gy);
+    void ReleasePrefetchedGrids(bool all);
+    void LoadMap(int32 gx, int32 gy, std::unique_ptr<GridMap> prefetched = nullptr);
     void LoadVMap(int32 gx, int32 gy);
     void LoadMMap(int32 gx, int32 gy);
 
@@ -115,6 +123,17 @@ private:
     std::bitset<MAX_NUMBER_OF_GRIDS* MAX_NUMBER_OF_GRIDS> _loadedGrids;
     std::bitset<MAX_NUMBER_OF_GRIDS* MAX_NUMBER_OF_GRIDS> _gridFileExists; // cache what grids are available for this map (not including parent/child maps)
 
+    struct PrefetchedGrid
+    {
+        std::unique_ptr<GridMap> Map;
+        std::vector<std::string> VMapModels;    // model references held until the vmap tile takes its own
+        bool Ready = false;
+        bool Expiring = false;
+    };
+
+    std::mutex _prefetchMutex;
+    std::unordered_map<uint32, PrefetchedGrid> _prefetchedGrids;
+
     static constexpr Milliseconds CleanupInterval = 1min;
 
     // global garbage collection timer
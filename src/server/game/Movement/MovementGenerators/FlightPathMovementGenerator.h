@@ -24,6 +24,8 @@
 
 class Player;
 
+#define PLAYER_FLIGHT_SPEED 32.0f
+
 /**
 * FlightPathMovementGenerator generates movement of the player for the paths
 * and hence generates ground and activities for the player.
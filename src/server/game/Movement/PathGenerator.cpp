@@ -34,8 +34,8 @@
 PathGenerator::PathGenerator(WorldObject const* owner) :
     _polyLength(0), _type(PATHFIND_BLANK), _useStraightPath(false),
     _forceDestination(false), _pointPathLimit(MAX_POINT_PATH_LENGTH), _useRaycast(false),
-    _endPosition(G3D::Vector3::zero()), _source(owner), _navMesh(nullptr),
-    _navMeshQuery(nullptr)
+    _endPosition(G3D::Vector3::zero()), _source(owner), _navMeshMapId(0),
+    _navMesh(nullptr), _navMeshQuery(nullptr)
 {
     memset(_pathPolyRefs, 0, sizeof(_pathPolyRefs));
 
@@ -44,9 +44,8 @@ PathGenerator::PathGenerator(WorldObject const* owner) :
     uint32 mapId = PhasingHandler::GetTerrainMapId(_source->GetPhaseShift(), _source->GetMapId(), _source->GetMap()->GetTerrain(), _source->GetPositionX(), _source->GetPositionY());
     if (DisableMgr::IsPathfindingEnabled(mapId))
     {
-        MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
-        _navMeshQuery = mmap->GetNavMeshQuery(mapId, _source->GetMapId(), _source->GetInstanceId());
-        _navMesh = _navMeshQuery ? _navMeshQuery->getAttachedNavMesh() : mmap->GetNavMesh(mapId);
+        _navMeshMapId = mapId;
+        _navMesh = MMAP::MMapFactory::createOrGetMMapManager()->GetNavMesh(mapId);
     }
 
     CreateFilter();
@@ -86,6 +85,13 @@ bool PathGenerator::CalculatePath(G3D::Vector3 const& startPoint, G3D::Vector3 c
 
     TC_LOG_DEBUG("maps.mmaps", "++ PathGenerator::CalculatePath() for %u", _source->GetGUID().GetCounter());
 
+    // queries are per thread and the generator may be reused by another map update thread
+    if (_navMesh)
+    {
+        LockNavMesh();
+        _navMeshQuery = MMAP::MMapFactory::createOrGetMMapManager()->GetNavMeshQuery(_navMeshMapId, _source->GetMapId(), _source->GetInstanceId());
+    }
+
     // make sure navMesh works - we can run on map w/o mmap
     // check if the start and end point have a .mmtile loaded (can we pass via not loaded tile on the way?)
     const Unit* _sourceUnit = _source->ToUnit();
@@ -97,9 +103,11 @@ bool PathGenerator::CalculatePath(G3D::Vector3 const& startPoint, G3D::Vector3 c
         return true;
     }
 
+    UnlockNavMesh();
     UpdateFilter();
 
     BuildPolyPath(startPoint, endPoint);
+    UnlockNavMesh();
     return true;
 }
 
@@ -177,6 +185,7 @@ void PathGenerator::BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
     float startPoint[VERTEX_SIZE] = {startPos.y, startPos.z, startPos.x};
     float endPoint[VERTEX_SIZE] = {endPos.y, endPos.z, endPos.x};
 
+    LockNavMesh();
     dtPolyRef startPoly = GetPolyByLocation(startPoint, &distToStartPoly);
     dtPolyRef endPoly = GetPolyByLocation(endPoint, &distToEndPoly);
 
@@ -236,6 +245,7 @@ void PathGenerator::BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
         bool buildShotrcut = false;
 
         G3D::Vector3 const& p = (distToStartPoly > 7.0f) ? startPos : endPos;
+        UnlockNavMesh();
         if (_source->GetMap()->IsUnderWater(_source->GetPhaseShift(), p.x, p.y, p.z))
         {
             TC_LOG_DEBUG("maps.mmaps", "++ BuildPolyPath :: underWater case");
@@ -269,6 +279,7 @@ void PathGenerator::BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
         {
             float closestPoint[VERTEX_SIZE];
             // we may want to use closestPointOnPolyBoundary instead
+            LockNavMesh();
             if (dtStatusSucceed(_navMeshQuery->closestPointOnPoly(endPoly, endPoint, closestPoint, nullptr)))
             {
                 dtVcopy(endPoint, closestPoint);
@@ -282,6 +293,7 @@ void PathGenerator::BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
     }
 
     // *** poly path generating logic ***
+    LockNavMesh();
 
     // start and end are on same polygon
     // handle this case as if they were 2 different polygons, building a line path split in some few points
@@ -640,10 +652,24 @@ void PathGenerator::BuildPointPath(const float *startPoint, const float *endPoin
 
 void PathGenerator::NormalizePath()
 {
+    UnlockNavMesh();
     for (uint32 i = 0; i < _pathPoints.size(); ++i)
         _source->UpdateAllowedPositionZ(_pathPoints[i].x, _pathPoints[i].y, _pathPoints[i].z);
 }
 
+void PathGenerator::LockNavMesh()
+{
+    if (!_navMeshLock.owns_lock())
+        _navMeshLock = MMAP::MMapFactory::createOrGetMMapManager()->LockNavMesh(_navMeshMapId);
+}
+
+void PathGenerator::UnlockNavMesh()
+{
+    // terrain lookups can load the grid and its nav mesh tile, which needs the nav mesh exclusively
+    if (_navMeshLock.owns_lock())
+        _navMeshLock.unlock();
+}
+
 void PathGenerator::BuildShortcut()
 {
     TC_LOG_DEBUG("maps.mmaps", "++ BuildShortcut :: making shortcut");
@@ -23,6 +23,7 @@
 #include "MMapDefines.h"
 #include "MoveSplineInitArgs.h"
 #include <G3D/Vector3.h>
+#include <shared_mutex>
 
 class Unit;
 class WorldObject;
@@ -109,8 +110,10 @@ class TC_GAME_API PathGenerator
         G3D::Vector3 _actualEndPosition;    // {x, y, z} of the closest possible point to given destination
 
         WorldObject const* const _source;       // the object that is moving
+        uint32 _navMeshMapId;                   // map id of the nav mesh
         dtNavMesh const* _navMesh;              // the nav mesh
-        dtNavMeshQuery const* _navMeshQuery;    // the nav mesh query used to find the path
+        dtNavMeshQuery const* _navMeshQuery;    // the nav mesh query of the thread calculating the path
+        std::shared_lock<std::shared_mutex> _navMeshLock;   // held only around detour calls, terrain lookups may load tiles of the nav mesh
 
         dtQueryFilter _filter;  // use single filter for all movements, update it when needed
 
@@ -118,6 +121,8 @@ class TC_GAME_API PathGenerator
         void SetEndPosition(G3D::Vector3 const& point) { _actualEndPosition = point; _endPosition = point; }
         void SetActualEndPosition(G3D::Vector3 const& point) { _actualEndPosition = point; }
         void NormalizePath();
+        void LockNavMesh();
+        void UnlockNavMesh();
 
         void Clear()
         {
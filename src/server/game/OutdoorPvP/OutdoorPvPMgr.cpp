@@ -126,6 +126,11 @@ void OutdoorPvPMgr::DestroyOutdoorPvPForMap(Map* map)
     m_OutdoorPvPByMap.erase(map);
 }
 
+bool OutdoorPvPMgr::HasOutdoorPvPForMap(Map* map) const
+{
+    return m_OutdoorPvPByMap.contains(map);
+}
+
 void OutdoorPvPMgr::AddZone(uint32 zoneid, OutdoorPvP* handle)
 {
     m_OutdoorPvPMap[{ handle->GetMap(), zoneid }] = handle;
@@ -54,6 +54,8 @@ class TC_GAME_API OutdoorPvPMgr
 
         void DestroyOutdoorPvPForMap(Map* map);
 
+        bool HasOutdoorPvPForMap(Map* map) const;
+
         // called when a player enters an outdoor pvp area
         void HandlePlayerEnterZone(Player* player, uint32 areaflag);
 
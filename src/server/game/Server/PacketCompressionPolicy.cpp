@@ -0,0 +1,183 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "PacketCompressionPolicy.h"
+#include "Config.h"
+#include "Log.h"
+#include "Metric.h"
+#include "Opcodes.h"
+#include "StringConvert.h"
+#include "Util.h"
+#include <unordered_map>
+
+PacketCompressionPolicy::PacketCompressionPolicy() : _infoIndex(), _infoCount(0), _defaultThreshold(0x400), _defaultLevel(1), _maxRatio(90)
+{
+}
+
+PacketCompressionPolicy::~PacketCompressionPolicy() = default;
+
+PacketCompressionPolicy* PacketCompressionPolicy::instance()
+{
+    static PacketCompressionPolicy instance;
+    return &instance;
+}
+
+void PacketCompressionPolicy::LoadFromConfig()
+{
+    std::unordered_map<std::string, uint16> opcodesByName;
+
+    // index is built only once, network threads may already read it when config is reloaded
+    if (!_info)
+    {
+        for (uint16 opcode = 0; opcode < NUM_OPCODE_HANDLERS; ++opcode)
+            if (opcodeTable[static_cast<OpcodeServer>(opcode)])
+                _infoIndex[opcode] = ++_infoCount;
+
+        _info = std::make_unique<OpcodeCompressionInfo[]>(_infoCount);
+        _infoOpcodes = std::make_unique<uint16[]>(_infoCount);
+        for (uint16 opcode = 0; opcode < NUM_OPCODE_HANDLERS; ++opcode)
+            if (_infoIndex[opcode])
+                _infoOpcodes[_infoIndex[opcode] - 1] = opcode;
+    }
+
+    int32 level = sConfigMgr->GetIntDefault("Compression", 1);
+    if (level < 1 || level > 9)
+        level = 1;  // already reported by World::LoadConfigSettings
+
+    uint32 threshold = sConfigMgr->GetIntDefault("Compression.Threshold", 0x400);
+    uint32 maxRatio = sConfigMgr->GetIntDefault("Compression.MaxRatio", 90);
+    if (maxRatio > 100)
+    {
+        TC_LOG_ERROR("server.loading", "Compression.MaxRatio (%u) must be in range 0..100. Using 100.", maxRatio);
+        maxRatio = 100;
+    }
+
+    _defaultThreshold.store(threshold, std::memory_order_relaxed);
+    _defaultLevel.store(level, std::memory_order_relaxed);
+    _maxRatio.store(maxRatio, std::memory_order_relaxed);
+
+    for (uint32 i = 0; i < _infoCount; ++i)
+    {
+        OpcodeCompressionInfo& info = _info[i];
+        info.Threshold.store(threshold, std::memory_order_relaxed);
+        info.Level.store(level, std::memory_order_relaxed);
+        info.Skipped.store(false, std::memory_order_relaxed);
+        info.SampleCount.store(0, std::memory_order_relaxed);
+        info.SampleBytesIn.store(0, std::memory_order_relaxed);
+        info.SampleBytesOut.store(0, std::memory_order_relaxed);
+        opcodesByName[opcodeTable[static_cast<OpcodeServer>(_infoOpcodes[i])]->Name] = _infoOpcodes[i];
+    }
+
+    // OPCODE_NAME:threshold:level entries, level 0 disables compression of the opcode
+    std::string opcodeSettings = sConfigMgr->GetStringDefault("Compression.Opcodes", "");
+    for (std::string_view entry : Trinity::Tokenize(opcodeSettings, ' ', false))
+    {
+        std::vector<std::string_view> tokens = Trinity::Tokenize(entry, ':', true);
+        auto itr = tokens.size() == 3 ? opcodesByName.find(std::string(tokens[0])) : opcodesByName.end();
+        Optional<uint32> opcodeThreshold = tokens.size() == 3 ? Trinity::StringTo<uint32>(tokens[1]) : Optional<uint32>();
+        Optional<int32> opcodeLevel = tokens.size() == 3 ? Trinity::StringTo<int32>(tokens[2]) : Optional<int32>();
+        if (itr == opcodesByName.end() || !opcodeThreshold || !opcodeLevel || *opcodeLevel < 0 || *opcodeLevel > 9)
+        {
+            TC_LOG_ERROR("server.loading", "Compression.Opcodes: invalid entry '%s', expected OPCODE_NAME:threshold:level with level in range 0..9. Skipped.", std::string(entry).c_str());
+            continue;
+        }
+
+        OpcodeCompressionInfo* info = GetInfo(itr->second);
+        info->Threshold.store(*opcodeThreshold, std::memory_order_relaxed);
+        info->Level.store(*opcodeLevel, std::memory_order_relaxed);
+    }
+}
+
+PacketCompressionPolicy::OpcodeCompressionInfo* PacketCompressionPolicy::GetInfo(uint16 opcode) const
+{
+    if (!_info || opcode >= _infoIndex.size() || !_infoIndex[opcode])
+        return nullptr;
+
+    return &_info[_infoIndex[opcode] - 1];
+}
+
+int32 PacketCompressionPolicy::GetCompressionLevel(uint16 opcode, std::size_t size)
+{
+    OpcodeCompressionInfo* info = GetInfo(opcode);
+    if (!info)
+        return size > _defaultThreshold.load(std::memory_order_relaxed) ? _defaultLevel.load(std::memory_order_relaxed) : 0;
+
+    if (size <= info->Threshold.load(std::memory_order_relaxed))
+        return 0;
+
+    int32 level = info->Level.load(std::memory_order_relaxed);
+    if (level && info->Skipped.load(std::memory_order_relaxed))
+    {
+        // compress a sample now and then, content of the opcode may have changed
+        if (info->SkippedSinceSample.fetch_add(1, std::memory_order_relaxed) + 1 < SampleInterval)
+        {
+            info->SkippedPackets.fetch_add(1, std::memory_order_relaxed);
+            return 0;
+        }
+
+        info->SkippedSinceSample.store(0, std::memory_order_relaxed);
+    }
+
+    return level;
+}
+
+void PacketCompressionPolicy::RecordCompression(uint16 opcode, std::size_t sizeIn, std::size_t sizeOut, std::chrono::microseconds cpuTime)
+{
+    OpcodeCompressionInfo* info = GetInfo(opcode);
+    if (!info)
+        return;
+
+    info->BytesIn.fetch_add(sizeIn, std::memory_order_relaxed);
+    info->BytesOut.fetch_add(sizeOut, std::memory_order_relaxed);
+    info->CpuTime.fetch_add(cpuTime.count(), std::memory_order_relaxed);
+    info->Packets.fetch_add(1, std::memory_order_relaxed);
+
+    uint64 sampleIn = info->SampleBytesIn.fetch_add(sizeIn, std::memory_order_relaxed) + sizeIn;
+    uint64 sampleOut = info->SampleBytesOut.fetch_add(sizeOut, std::memory_order_relaxed) + sizeOut;
+    if (info->SampleCount.fetch_add(1, std::memory_order_relaxed) + 1 != SampleSize)
+        return;
+
+    // concurrent samples may land in either window, decision does not need to be exact
+    info->SampleCount.store(0, std::memory_order_relaxed);
+    info->SampleBytesIn.store(0, std::memory_order_relaxed);
+    info->SampleBytesOut.store(0, std::memory_order_relaxed);
+
+    bool skip = sampleOut * 100 > sampleIn * _maxRatio.load(std::memory_order_relaxed);
+    if (info->Skipped.exchange(skip, std::memory_order_relaxed) != skip)
+        TC_LOG_DEBUG("network", "PacketCompressionPolicy: %s compressed to %u%% of its size, compression %s",
+            GetOpcodeNameForLogging(static_cast<OpcodeServer>(opcode)).c_str(), uint32(sampleIn ? sampleOut * 100 / sampleIn : 0), skip ? "skipped" : "resumed");
+}
+
+void PacketCompressionPolicy::LogStatistics()
+{
+    for (uint32 i = 0; i < _infoCount; ++i)
+    {
+        OpcodeCompressionInfo& info = _info[i];
+        uint32 packets = info.Packets.exchange(0, std::memory_order_relaxed);
+        uint32 skippedPackets = info.SkippedPackets.exchange(0, std::memory_order_relaxed);
+        if (!packets && !skippedPackets)
+            continue;
+
+        std::string opcodeName = opcodeTable[static_cast<OpcodeServer>(_infoOpcodes[i])]->Name;
+        TC_METRIC_VALUE("packet_compression_packets", packets, TC_METRIC_TAG("opcode", opcodeName));
+        TC_METRIC_VALUE("packet_compression_skipped", skippedPackets, TC_METRIC_TAG("opcode", opcodeName));
+        TC_METRIC_VALUE("packet_compression_bytes_in", info.BytesIn.exchange(0, std::memory_order_relaxed), TC_METRIC_TAG("opcode", opcodeName));
+        TC_METRIC_VALUE("packet_compression_bytes_out", info.BytesOut.exchange(0, std::memory_order_relaxed), TC_METRIC_TAG("opcode", opcodeName));
+        TC_METRIC_VALUE("packet_compression_time", info.CpuTime.exchange(0, std::memory_order_relaxed), TC_METRIC_TAG("opcode", opcodeName));
+    }
+}
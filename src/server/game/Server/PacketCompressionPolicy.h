@@ -0,0 +1,88 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PacketCompressionPolicy_h__
+#define PacketCompressionPolicy_h__
+
+#include "Define.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+/// Decides which server packets are compressed and at which zlib level
+/// Thresholds and levels are configured per opcode, opcodes whose packets do not shrink enough when compressed
+/// are skipped automatically and only sampled from time to time to detect when they start compressing well again
+class TC_GAME_API PacketCompressionPolicy
+{
+public:
+    static PacketCompressionPolicy* instance();
+
+    /// Reads Compression.* settings, requires the opcode table to be initialized
+    void LoadFromConfig();
+
+    /// zlib level to compress a packet with, 0 if it should be sent uncompressed
+    int32 GetCompressionLevel(uint16 opcode, std::size_t size);
+
+    void RecordCompression(uint16 opcode, std::size_t sizeIn, std::size_t sizeOut, std::chrono::microseconds cpuTime);
+
+    /// Sends per opcode compression statistics gathered since last call to sMetric
+    void LogStatistics();
+
+private:
+    PacketCompressionPolicy();
+    ~PacketCompressionPolicy();
+
+    struct OpcodeCompressionInfo
+    {
+        std::atomic<uint32> Threshold;
+        std::atomic<int32> Level;
+        std::atomic<bool> Skipped;
+        std::atomic<uint32> SkippedSinceSample;
+
+        // window of samples the skip decision is made on
+        std::atomic<uint32> SampleCount;
+        std::atomic<uint64> SampleBytesIn;
+        std::atomic<uint64> SampleBytesOut;
+
+        // statistics since last LogStatistics call
+        std::atomic<uint64> BytesIn;
+        std::atomic<uint64> BytesOut;
+        std::atomic<uint64> CpuTime;
+        std::atomic<uint32> Packets;
+        std::atomic<uint32> SkippedPackets;
+    };
+
+    OpcodeCompressionInfo* GetInfo(uint16 opcode) const;
+
+    std::array<uint16, 0x8000> _infoIndex;     // opcode -> index in _info + 1, 0 for opcodes without a server handler
+    std::unique_ptr<OpcodeCompressionInfo[]> _info;
+    std::unique_ptr<uint16[]> _infoOpcodes;
+    uint32 _infoCount;
+
+    std::atomic<uint32> _defaultThreshold;
+    std::atomic<int32> _defaultLevel;
+    std::atomic<uint32> _maxRatio;          // in percent of uncompressed size, opcodes compressing worse are skipped
+
+    static constexpr uint32 SampleSize = 64;        // compressed packets per skip decision
+    static constexpr uint32 SampleInterval = 256;   // one of this many packets of a skipped opcode is still compressed
+};
+
+#define sPacketCompressionPolicy PacketCompressionPolicy::instance()
+
+#endif // PacketCompressionPolicy_h__
@@ -22,6 +22,7 @@
 #include "Opcodes.h"
 #include "ByteBuffer.h"
 #include <chrono>
+#include <memory>
 
 struct z_stream_s;
 
@@ -103,4 +104,17 @@ class WorldPacket : public ByteBuffer
         std::chrono::steady_clock::time_point m_receivedTime; // only set for a specific set of opcodes, for performance reasons.
 };
 
+/// Shared copy of a packet that is only made once the first receiver is found, see WorldSession::MakeSharedPacket
+class TC_GAME_API LazySharedPacket
+{
+    public:
+        explicit LazySharedPacket(WorldPacket const* packet) : _packet(packet) { }
+
+        std::shared_ptr<WorldPacket const> const& Get();
+
+    private:
+        WorldPacket const* _packet;
+        std::shared_ptr<WorldPacket const> _sharedPacket;
+};
+
 #endif
@@ -0,0 +1,97 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "WorldPacketPool.h"
+
+struct WorldPacketPoolThreadHolder
+{
+    WorldPacketPoolThreadHolder() : Pool(new WorldPacketPool()) { }
+    ~WorldPacketPoolThreadHolder() { Pool->ReleaseOwner(); }
+
+    WorldPacketPool* Pool;
+};
+
+namespace
+{
+    thread_local WorldPacketPoolThreadHolder ThreadPool;
+}
+
+WorldPacketPool::~WorldPacketPool()
+{
+    for (QueuedWorldPacket* packet : _free)
+        delete packet;
+
+    // _released deletes its remaining packets on destruction
+}
+
+QueuedWorldPacket* WorldPacketPool::Acquire(WorldPacket&& packet)
+{
+    QueuedWorldPacket* queued = ThreadPool.Pool->Get();
+    queued->SetReceiveTime(packet.GetReceivedTime());
+    static_cast<WorldPacket&>(*queued) = std::move(packet);
+    return queued;
+}
+
+void WorldPacketPool::Release(QueuedWorldPacket* packet)
+{
+    packet->_pool->Put(packet);
+}
+
+void WorldPacketPool::ReleaseOwner()
+{
+    RemoveReference();
+}
+
+QueuedWorldPacket* WorldPacketPool::Get()
+{
+    if (_free.empty())
+    {
+        QueuedWorldPacket* released;
+        while (_released.Dequeue(released))
+        {
+            if (_free.size() < MaxCachedPackets)
+                _free.push_back(released);
+            else
+                delete released;
+        }
+    }
+
+    _references.fetch_add(1, std::memory_order_relaxed);
+
+    if (_free.empty())
+        return new QueuedWorldPacket(this);
+
+    QueuedWorldPacket* packet = _free.back();
+    _free.pop_back();
+    return packet;
+}
+
+void WorldPacketPool::Put(QueuedWorldPacket* packet)
+{
+    // drop packet content now, pooled packets only keep the allocation of the packet itself
+    static_cast<WorldPacket&>(*packet) = WorldPacket();
+
+    _released.Enqueue(packet);
+    RemoveReference();
+}
+
+void WorldPacketPool::RemoveReference()
+{
+    if (_references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        delete this;
+}
@@ -0,0 +1,78 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef WorldPacketPool_h__
+#define WorldPacketPool_h__
+
+#include "WorldPacket.h"
+#include "MPSCQueue.h"
+#include <atomic>
+#include <vector>
+
+class WorldPacketPool;
+
+/// Client packet waiting in a WorldSession receive queue, allocated from the pool of the network thread that read it
+class TC_GAME_API QueuedWorldPacket : public WorldPacket
+{
+    friend class WorldPacketPool;
+
+public:
+    std::atomic<QueuedWorldPacket*> QueueLink;
+
+private:
+    explicit QueuedWorldPacket(WorldPacketPool* pool) : _pool(pool) { }
+
+    WorldPacketPool* _pool;
+};
+
+/// Recycles queued client packets of a single network thread
+/// Packets are acquired by the owning thread only and can be released from any thread, released packets
+/// go through a lock free queue and are reused by the owning thread on its next acquire
+class TC_GAME_API WorldPacketPool
+{
+public:
+    /// Takes a packet from the calling thread's pool and moves the content of packet into it
+    static QueuedWorldPacket* Acquire(WorldPacket&& packet);
+
+    /// Returns packet to the pool it was acquired from
+    static void Release(QueuedWorldPacket* packet);
+
+    /// Releases the owning thread reference, pool is destroyed once all of its packets are released too
+    void ReleaseOwner();
+
+private:
+    WorldPacketPool() : _references(1) { }
+    ~WorldPacketPool();
+
+    WorldPacketPool(WorldPacketPool const&) = delete;
+    WorldPacketPool& operator=(WorldPacketPool const&) = delete;
+
+    QueuedWorldPacket* Get();
+    void Put(QueuedWorldPacket* packet);
+    void RemoveReference();
+
+    static constexpr std::size_t MaxCachedPackets = 1024;
+
+    friend struct WorldPacketPoolThreadHolder;
+
+    std::vector<QueuedWorldPacket*> _free;
+    MPSCQueue<QueuedWorldPacket, &QueuedWorldPacket::QueueLink> _released;
+    std::atomic<uint32> _references;    // owning thread + packets currently outside of the pool
+};
+
+#endif // WorldPacketPool_h__
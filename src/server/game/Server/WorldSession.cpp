@@ -185,9 +185,12 @@ WorldSession::~WorldSession()
     delete _gameClient;
 
     ///- empty incoming packet queue
-    WorldPacket* packet = nullptr;
-    while (_recvQueue.next(packet))
-        delete packet;
+    for (QueuedWorldPacket* packet : _recvPending)
+        WorldPacketPool::Release(packet);
+
+    QueuedWorldPacket* packet = nullptr;
+    while (_recvQueue.Dequeue(packet))
+        WorldPacketPool::Release(packet);
 
     LoginDatabase.PExecute("UPDATE account SET online = 0 WHERE id = %u;", GetAccountId());     // One-time query
 }
@@ -226,16 +229,45 @@ ObjectGuid::LowType WorldSession::GetGUIDLow() const
 
 /// Send a packet to the client
 void WorldSession::SendPacket(WorldPacket const* packet, bool forced /*= false*/)
+{
+    ConnectionType conIdx;
+    if (PrepareSendPacket(packet, forced, conIdx))
+        m_Socket[conIdx]->SendPacket(*packet);
+}
+
+/// Send a packet to the client, packet is not copied and can be sent to any number of sessions as long as it is not modified
+void WorldSession::SendPacket(std::shared_ptr<WorldPacket const> const& packet, bool forced /*= false*/)
+{
+    ConnectionType conIdx;
+    if (PrepareSendPacket(packet.get(), forced, conIdx))
+        m_Socket[conIdx]->SendPacket(packet);
+}
+
+std::shared_ptr<WorldPacket const> WorldSession::MakeSharedPacket(WorldPacket const* packet)
+{
+    WorldSocket::PayloadBytesCopied.fetch_add(packet->size(), std::memory_order_relaxed);
+    return std::make_shared<WorldPacket>(*packet);
+}
+
+std::shared_ptr<WorldPacket const> const& LazySharedPacket::Get()
+{
+    if (!_sharedPacket)
+        _sharedPacket = WorldSession::MakeSharedPacket(_packet);
+
+    return _sharedPacket;
+}
+
+bool WorldSession::PrepareSendPacket(WorldPacket const* packet, bool forced, ConnectionType& conIdx)
 {
     if (packet->GetOpcode() == NULL_OPCODE)
     {
         TC_LOG_ERROR("network.opcode", "Prevented sending of NULL_OPCODE to %s", GetPlayerInfo().c_str());
-        return;
+        return false;
     }
     else if (packet->GetOpcode() == UNKNOWN_OPCODE)
     {
         TC_LOG_ERROR("network.opcode", "Prevented sending of UNKNOWN_OPCODE to %s", GetPlayerInfo().c_str());
-        return;
+        return false;
     }
 
     ServerOpcodeHandler const* handler = opcodeTable[static_cast<OpcodeServer>(packet->GetOpcode())];
@@ -243,11 +275,11 @@ void WorldSession::SendPacket(WorldPacket const* packet, bool forced /*= false*/
     if (!handler)
     {
         TC_LOG_ERROR("network.opcode", "Prevented sending of opcode %u with non existing handler to %s", packet->GetOpcode(), GetPlayerInfo().c_str());
-        return;
+        return false;
     }
 
     // Default connection index defined in Opcodes.cpp table
-    ConnectionType conIdx = handler->ConnectionIndex;
+    conIdx = handler->ConnectionIndex;
 
     // Override connection index
     if (packet->GetConnection() != CONNECTION_TYPE_DEFAULT)
@@ -255,7 +287,7 @@ void WorldSession::SendPacket(WorldPacket const* packet, bool forced /*= false*/
         if (packet->GetConnection() != CONNECTION_TYPE_INSTANCE && IsInstanceOnlyOpcode(packet->GetOpcode()))
         {
             TC_LOG_ERROR("network.opcode", "Prevented sending of instance only opcode %u with connection type %u to %s", packet->GetOpcode(), uint32(packet->GetConnection()), GetPlayerInfo().c_str());
-            return;
+            return false;
         }
 
         conIdx = packet->GetConnection();
@@ -264,7 +296,7 @@ void WorldSession::SendPacket(WorldPacket const* packet, bool forced /*= false*/
     if (!m_Socket[conIdx])
     {
         TC_LOG_ERROR("network.opcode", "Prevented sending of %s to non existent socket %u to %s", GetOpcodeNameForLogging(static_cast<OpcodeServer>(packet->GetOpcode())).c_str(), uint32(conIdx), GetPlayerInfo().c_str());
-        return;
+        return false;
     }
 
     if (!forced)
@@ -273,7 +305,7 @@ void WorldSession::SendPacket(WorldPacket const* packet, bool forced /*= false*/
         if (!handler || handler->Status == STATUS_UNHANDLED)
         {
             TC_LOG_ERROR("network.opcode", "Prevented sending disabled opcode %s to %s", GetOpcodeNameForLogging(static_cast<OpcodeServer>(packet->GetOpcode())).c_str(), GetPlayerInfo().c_str());
-            return;
+            return false;
         }
     }
 
@@ -320,19 +352,43 @@ void WorldSession::SendPacket(WorldPacket const* packet, bool forced /*= false*/
         if (Eluna* e = plr->GetEluna())
         {
             if (!e->OnPacketSend(this, *packet))
-                return;
+                return false;
         }
     }
 #endif
 
     TC_LOG_TRACE("network.opcode", "S->C: %s %s", GetPlayerInfo().c_str(), GetOpcodeNameForLogging(static_cast<OpcodeServer>(packet->GetOpcode())).c_str());
-    m_Socket[conIdx]->SendPacket(*packet);
+    return true;
 }
 
 /// Add an incoming packet to the queue
-void WorldSession::QueuePacket(WorldPacket* new_packet)
+void WorldSession::QueuePacket(QueuedWorldPacket* new_packet)
 {
-    _recvQueue.add(new_packet);
+    _recvQueue.Enqueue(new_packet);
+}
+
+bool WorldSession::GetNextReceivedPacket(QueuedWorldPacket*& packet, PacketFilter& filter)
+{
+    if (_recvPending.empty())
+    {
+        if (!_recvQueue.Dequeue(packet))
+            return false;
+
+        if (!filter.Process(packet))
+        {
+            _recvPending.push_front(packet);
+            return false;
+        }
+
+        return true;
+    }
+
+    packet = _recvPending.front();
+    if (!filter.Process(packet))
+        return false;
+
+    _recvPending.pop_front();
+    return true;
 }
 
 /// Logging helper for unexpected opcodes
@@ -366,16 +422,16 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
 
     ///- Retrieve packets from the receive queue and call the appropriate handlers
     /// not process packets if socket already closed
-    WorldPacket* packet = nullptr;
+    QueuedWorldPacket* packet = nullptr;
     //! Delete packet after processing by default
     bool deletePacket = true;
-    std::vector<WorldPacket*> requeuePackets;
+    std::vector<QueuedWorldPacket*> requeuePackets;
     uint32 processedPackets = 0;
     time_t currentTime = GameTime::GetGameTime();
 
     constexpr uint32 MAX_PROCESSED_PACKETS_IN_SAME_WORLDSESSION_UPDATE = 100;
 
-    while (m_Socket[CONNECTION_TYPE_REALM] && _recvQueue.next(packet, updater))
+    while (m_Socket[CONNECTION_TYPE_REALM] && GetNextReceivedPacket(packet, updater))
     {
         ClientOpcodeHandler const* opHandle = opcodeTable[static_cast<OpcodeClient>(packet->GetOpcode())];
         try
@@ -503,7 +559,7 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
         }
 
         if (deletePacket)
-            delete packet;
+            WorldPacketPool::Release(packet);
 
         deletePacket = true;
 
@@ -517,7 +573,7 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
 
     TC_METRIC_VALUE("processed_packets", processedPackets);
 
-    _recvQueue.readd(requeuePackets.begin(), requeuePackets.end());
+    _recvPending.insert(_recvPending.begin(), requeuePackets.begin(), requeuePackets.end());
 
     if (m_Socket[0] && m_Socket[0]->IsOpen() && _warden)
         _warden->Update();
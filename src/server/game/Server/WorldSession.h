@@ -23,6 +23,7 @@
 #define __WORLDSESSION_H
 
 #include <boost/circular_buffer_fwd.hpp>
+#include <deque>
 #include <map>
 #include <unordered_map>
 
@@ -30,10 +31,10 @@
 #include "AuthDefines.h"
 #include "Common.h"
 #include "DatabaseEnvFwd.h"
-#include "LockedQueue.h"
 #include "ObjectGuid.h"
 #include "Packet.h"
 #include "SharedDefines.h"
+#include "WorldPacketPool.h"
 
 class BigNumber;
 class Creature;
@@ -494,6 +495,9 @@ class TC_GAME_API WorldSession
         void SendAddonsInfo();
         bool IsAddonRegistered(const std::string& prefix) const;
         void SendPacket(WorldPacket const* packet, bool forced = false);
+        void SendPacket(std::shared_ptr<WorldPacket const> const& packet, bool forced = false);
+        /// copies packet once into an immutable payload that can be sent to any number of sessions
+        static std::shared_ptr<WorldPacket const> MakeSharedPacket(WorldPacket const* packet);
         void AddInstanceConnection(std::shared_ptr<WorldSocket> sock) { m_Socket[1] = sock; }
 
         void SendNotification(const char *format, ...) ATTR_PRINTF(2, 3);
@@ -553,7 +557,7 @@ class TC_GAME_API WorldSession
         void LogoutPlayer(bool save);
         void KickPlayer();
 
-        void QueuePacket(WorldPacket* new_packet);
+        void QueuePacket(QueuedWorldPacket* new_packet);
         bool Update(uint32 diff, PacketFilter& updater);
 
         /// Handle the authentication waiting queue (to be completed)
@@ -1299,6 +1303,10 @@ class TC_GAME_API WorldSession
 
     private:
         void ProcessQueryCallbacks();
+        /// validates packet for this session and picks its connection, false if it must not be sent
+        bool PrepareSendPacket(WorldPacket const* packet, bool forced, ConnectionType& conIdx);
+        /// next received packet accepted by filter, packets rejected by it stay first in line
+        bool GetNextReceivedPacket(QueuedWorldPacket*& packet, PacketFilter& filter);
 
         QueryCallbackProcessor _queryProcessor;
         AsyncCallbackProcessor<TransactionCallback> _transactionCallbacks;
@@ -1408,7 +1416,8 @@ class TC_GAME_API WorldSession
         bool _filterAddonMessages;
         uint32 recruiterId;
         bool isRecruiter;
-        LockedQueue<WorldPacket*> _recvQueue;
+        MPSCQueue<QueuedWorldPacket, &QueuedWorldPacket::QueueLink> _recvQueue;
+        std::deque<QueuedWorldPacket*> _recvPending;    // only touched by the thread updating the session, kept ahead of _recvQueue
         rbac::RBACData* _RBACData;
         uint32 expireTime;
         bool forceExit;
@@ -27,6 +27,7 @@
 #include "GameTime.h"
 #include "IPLocation.h"
 #include "Opcodes.h"
+#include "PacketCompressionPolicy.h"
 #include "PacketLog.h"
 #include "QueryCallback.h"
 #include "Random.h"
@@ -45,7 +46,7 @@ std::string const WorldSocket::ClientConnectionInitialize("WORLD OF WARCRAFT CON
 
 WorldSocket::WorldSocket(tcp::socket&& socket) : Socket(std::move(socket)),
     _type(CONNECTION_TYPE_REALM), _OverSpeedPings(0), _worldSession(nullptr),
-    _authed(false), _compressionStream(nullptr), _sendBufferSize(4096)
+    _authed(false), _compressionStream(nullptr), _compressionLevel(0), _sendBufferSize(4096)
 {
     Trinity::Crypto::GetRandomBytes(_authSeed);
     _headerBuffer.Resize(2);
@@ -171,7 +172,8 @@ void WorldSocket::InitializeHandler(boost::system::error_code error, std::size_t
         _compressionStream->opaque = (voidpf)nullptr;
         _compressionStream->avail_in = 0;
         _compressionStream->next_in = nullptr;
-        int32 z_res = deflateInit(_compressionStream, sWorld->getIntConfig(CONFIG_COMPRESSION));
+        _compressionLevel = sWorld->getIntConfig(CONFIG_COMPRESSION);
+        int32 z_res = deflateInit(_compressionStream, _compressionLevel);
         if (z_res != Z_OK)
         {
             TC_LOG_ERROR("network", "Can't initialize packet compression (zlib: deflateInit) Error code: %i (%s)", z_res, zError(z_res));
@@ -190,46 +192,67 @@ void WorldSocket::InitializeHandler(boost::system::error_code error, std::size_t
     AsyncReadWithCallback(&WorldSocket::InitializeHandler);
 }
 
+std::atomic<uint64> WorldSocket::PayloadBytesCopied(0);
+std::atomic<uint64> WorldSocket::PayloadBytesShared(0);
+
 bool WorldSocket::Update()
 {
+    // all ranges of the previous send buffer were written, start over instead of allocating a new one
+    if (_sendBuffer && _sendBuffer.use_count() == 1)
+        _sendBuffer->Reset();
+
     EncryptablePacket* queued;
-    MessageBuffer buffer(_sendBufferSize);
+    uint64 bytesCopied = 0;
+    uint64 bytesShared = 0;
     while (_bufferQueue.Dequeue(queued))
     {
-        if (queued->size() > 0x400 && !queued->IsCompressed())
-            queued->Compress(_compressionStream);
+        WorldPacket const* packet = &queued->GetPacket();
+        std::shared_ptr<WorldPacket> compressed;
+        if (!packet->IsCompressed())
+        {
+            // compression stream is per connection, shared payloads are compressed into a copy owned by this socket
+            if (int32 level = sPacketCompressionPolicy->GetCompressionLevel(packet->GetOpcode(), packet->size()))
+                if ((compressed = CompressPacket(*packet, level)))
+                    packet = compressed.get();
+        }
 
-        ServerPktHeader header(queued->size() + 2, queued->GetOpcode());
+        ServerPktHeader header(packet->size() + 2, packet->GetOpcode());
         if (queued->NeedsEncryption())
             _authCrypt.EncryptSend(header.header, header.getHeaderLength());
 
-        if (buffer.GetRemainingSpace() < queued->size() + header.getHeaderLength())
+        // only the header is written to the send buffer, larger payloads are written from the packet itself
+        bool copyPayload = packet->size() < MinReferencedPayloadSize;
+        std::size_t bufferedSize = header.getHeaderLength() + (copyPayload ? packet->size() : 0);
+        if (!_sendBuffer || _sendBuffer->GetRemainingSpace() < bufferedSize)
         {
-            QueuePacket(std::move(buffer));
-            buffer.Resize(_sendBufferSize);
+            QueueSendBuffer();
+            _sendBuffer = std::make_shared<MessageBuffer>(std::max(_sendBufferSize, bufferedSize));
         }
 
-        if (buffer.GetRemainingSpace() >= queued->size() + header.getHeaderLength())
-        {
-            buffer.Write(header.header, header.getHeaderLength());
-            if (!queued->empty())
-                buffer.Write(queued->contents(), queued->size());
-        }
-        else    // single packet larger than 4096 bytes
+        _sendBuffer->Write(header.header, header.getHeaderLength());
+        if (copyPayload)
         {
-            MessageBuffer packetBuffer(queued->size() + header.getHeaderLength());
-            packetBuffer.Write(header.header, header.getHeaderLength());
-            if (!queued->empty())
-                packetBuffer.Write(queued->contents(), queued->size());
+            if (!packet->empty())
+                _sendBuffer->Write(packet->contents(), packet->size());
 
-            QueuePacket(std::move(packetBuffer));
+            bytesCopied += packet->size();
+            delete queued;
+            continue;
         }
 
+        bytesShared += packet->size();
+        std::shared_ptr<WorldPacket const> payload = compressed ? std::move(compressed) : queued->SharePacket();
         delete queued;
+
+        QueueSendBuffer(boost::asio::buffer(payload->contents(), payload->size()), std::move(payload));
     }
 
-    if (buffer.GetActiveSize() > 0)
-        QueuePacket(std::move(buffer));
+    QueueSendBuffer();
+
+    if (bytesCopied)
+        PayloadBytesCopied.fetch_add(bytesCopied, std::memory_order_relaxed);
+    if (bytesShared)
+        PayloadBytesShared.fetch_add(bytesShared, std::memory_order_relaxed);
 
     if (!BaseSocket::Update())
         return false;
@@ -239,6 +262,16 @@ bool WorldSocket::Update()
     return true;
 }
 
+void WorldSocket::QueueSendBuffer(boost::asio::const_buffer payload /*= boost::asio::const_buffer()*/, std::shared_ptr<void const> payloadOwner /*= nullptr*/)
+{
+    if (!_sendBuffer || !_sendBuffer->GetActiveSize())
+        return;
+
+    boost::asio::const_buffer data = boost::asio::buffer(_sendBuffer->GetReadPointer(), _sendBuffer->GetActiveSize());
+    _sendBuffer->ReadCompleted(_sendBuffer->GetActiveSize());
+    QueuePacket(data, _sendBuffer, payload, std::move(payloadOwner));
+}
+
 void WorldSocket::HandleSendAuthSession()
 {
     _encryptSeed.SetRand(16 * 8);
@@ -250,7 +283,7 @@ void WorldSocket::HandleSendAuthSession()
     memcpy(&challenge.DosChallenge[4], _decryptSeed.ToByteArray<16>().data(), 16);
     challenge.DosZeroBits = 1;
 
-    SendPacketAndLogOpcode(*challenge.Write());
+    SendPacketAndLogOpcode(challenge);
 }
 
 void WorldSocket::OnClose()
@@ -532,8 +565,9 @@ WorldSocket::ReadDataHandlerResult WorldSocket::ReadDataHandler()
             // Our Idle timer will reset on any non PING opcodes on login screen, allowing us to catch people idling.
             _worldSession->ResetTimeOutTime(false);
 
-            // Copy the packet to the heap before enqueuing
-            _worldSession->QueuePacket(new WorldPacket(std::move(packet)));
+            // Move the packet into a pooled one before enqueuing
+            QueuedWorldPacket* queued = WorldPacketPool::Acquire(std::move(packet));
+            _worldSession->QueuePacket(queued);
             break;
         }
     }
@@ -554,10 +588,43 @@ void WorldSocket::LogOpcodeText(OpcodeClient opcode, std::unique_lock<std::mutex
     }
 }
 
-void WorldSocket::SendPacketAndLogOpcode(WorldPacket const& packet)
+void WorldSocket::SendPacketAndLogOpcode(WorldPackets::ServerPacket& packet)
+{
+    TC_LOG_TRACE("network.opcode", "S->C: %s %s", GetRemoteIpAddress().to_string().c_str(), GetOpcodeNameForLogging(packet.GetOpcode()).c_str());
+    packet.Write();
+    SendPacket(packet.Move());
+}
+
+std::shared_ptr<WorldPacket> WorldSocket::CompressPacket(WorldPacket const& source, int32 level)
 {
-    TC_LOG_TRACE("network.opcode", "S->C: %s %s", GetRemoteIpAddress().to_string().c_str(), GetOpcodeNameForLogging(static_cast<OpcodeServer>(packet.GetOpcode())).c_str());
-    SendPacket(packet);
+    if (level != _compressionLevel)
+    {
+        // every packet is sync flushed so there is no pending output, deflateParams only needs a valid output buffer
+        uint8 unused[16];
+        _compressionStream->next_in = nullptr;
+        _compressionStream->avail_in = 0;
+        _compressionStream->next_out = unused;
+        _compressionStream->avail_out = sizeof(unused);
+        int32 z_res = deflateParams(_compressionStream, level, Z_DEFAULT_STRATEGY);
+        if (z_res != Z_OK)
+        {
+            TC_LOG_ERROR("network", "Can't change packet compression level to %d (zlib: deflateParams) Error code: %i (%s)", level, z_res, zError(z_res));
+            return nullptr;
+        }
+
+        _compressionLevel = level;
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    std::shared_ptr<WorldPacket> compressed = std::make_shared<WorldPacket>(source.GetOpcode(), 0, source.GetConnection());
+    compressed->Compress(_compressionStream, &source);
+    if (!compressed->IsCompressed())
+        return nullptr;
+
+    sPacketCompressionPolicy->RecordCompression(source.GetOpcode(), source.size(), compressed->size(),
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start));
+    return compressed;
 }
 
 void WorldSocket::SendPacket(WorldPacket const& packet)
@@ -568,9 +635,32 @@ void WorldSocket::SendPacket(WorldPacket const& packet)
     if (sPacketLog->CanLogPacket())
         sPacketLog->LogPacket(packet, SERVER_TO_CLIENT, GetRemoteIpAddress(), GetRemotePort());
 
+    PayloadBytesCopied.fetch_add(packet.size(), std::memory_order_relaxed);
     _bufferQueue.Enqueue(new EncryptablePacket(packet, _authCrypt.IsInitialized()));
 }
 
+void WorldSocket::SendPacket(WorldPacket&& packet)
+{
+    if (!IsOpen())
+        return;
+
+    if (sPacketLog->CanLogPacket())
+        sPacketLog->LogPacket(packet, SERVER_TO_CLIENT, GetRemoteIpAddress(), GetRemotePort());
+
+    _bufferQueue.Enqueue(new EncryptablePacket(std::move(packet), _authCrypt.IsInitialized()));
+}
+
+void WorldSocket::SendPacket(std::shared_ptr<WorldPacket const> packet)
+{
+    if (!IsOpen())
+        return;
+
+    if (sPacketLog->CanLogPacket())
+        sPacketLog->LogPacket(*packet, SERVER_TO_CLIENT, GetRemoteIpAddress(), GetRemotePort());
+
+    _bufferQueue.Enqueue(new EncryptablePacket(std::move(packet), _authCrypt.IsInitialized()));
+}
+
 void WorldSocket::HandleAuthSession(std::shared_ptr<WorldPackets::Auth::AuthSession> authSession)
 {
     // Get the account information from the auth database
@@ -843,7 +933,8 @@ void WorldSocket::HandleConnectToFailed(WorldPackets::Auth::ConnectToFailed& con
         //else
         //{
         //    transfer_aborted when/if we get map node redirection
-        //    SendPacketAndLogOpcode(*WorldPackets::Auth::ResumeComms().Write());
+        //    WorldPackets::Auth::ResumeComms resumeComms;
+        //    SendPacketAndLogOpcode(resumeComms);
         //}
     }
 }
@@ -852,7 +943,7 @@ void WorldSocket::SendAuthResponseError(uint8 code)
 {
     WorldPackets::Auth::AuthResponse response;
     response.Result = code;
-    SendPacketAndLogOpcode(*response.Write());
+    SendPacketAndLogOpcode(response);
 }
 
 bool WorldSocket::HandlePing(WorldPackets::Auth::Ping& ping)
@@ -906,6 +997,7 @@ bool WorldSocket::HandlePing(WorldPackets::Auth::Ping& ping)
         }
     }
 
-    SendPacketAndLogOpcode(*WorldPackets::Auth::Pong(ping.Serial).Write());
+    WorldPackets::Auth::Pong pong(ping.Serial);
+    SendPacketAndLogOpcode(pong);
     return true;
 }
@@ -28,23 +28,47 @@
 #include "WorldPacket.h"
 #include "WorldSession.h"
 #include "MPSCQueue.h"
+#include <atomic>
 #include <chrono>
 #include <boost/asio/ip/tcp.hpp>
 
 using boost::asio::ip::tcp;
-class EncryptablePacket : public WorldPacket
+class EncryptablePacket
 {
 public:
-    EncryptablePacket(WorldPacket const& packet, bool encrypt) : WorldPacket(packet), _encrypt(encrypt)
+    EncryptablePacket(WorldPacket const& packet, bool encrypt) : _ownedPacket(packet), _encrypt(encrypt)
     {
         SocketQueueLink.store(nullptr, std::memory_order_relaxed);
     }
 
+    EncryptablePacket(WorldPacket&& packet, bool encrypt) : _ownedPacket(std::move(packet)), _encrypt(encrypt)
+    {
+        SocketQueueLink.store(nullptr, std::memory_order_relaxed);
+    }
+
+    EncryptablePacket(std::shared_ptr<WorldPacket const> packet, bool encrypt) : _sharedPacket(std::move(packet)), _encrypt(encrypt)
+    {
+        SocketQueueLink.store(nullptr, std::memory_order_relaxed);
+    }
+
+    /// Payload, may be shared with other sockets and must not be modified
+    WorldPacket const& GetPacket() const { return _sharedPacket ? *_sharedPacket : _ownedPacket; }
+    /// Shared ownership of the payload, a packet owned by this entry is moved into a new shared packet
+    std::shared_ptr<WorldPacket const> SharePacket()
+    {
+        if (!_sharedPacket)
+            _sharedPacket = std::make_shared<WorldPacket>(std::move(_ownedPacket));
+
+        return _sharedPacket;
+    }
+
     bool NeedsEncryption() const { return _encrypt; }
 
     std::atomic<EncryptablePacket*> SocketQueueLink;
 
 private:
+    WorldPacket _ownedPacket;
+    std::shared_ptr<WorldPacket const> _sharedPacket;
     bool _encrypt;
 };
 
@@ -82,6 +106,9 @@ class TC_GAME_API WorldSocket : public Socket<WorldSocket>
     static std::string const ServerConnectionInitialize;
     static std::string const ClientConnectionInitialize;
 
+    /// Smaller payloads are copied into the send buffer, cheaper than writing them as a separate buffer
+    static constexpr std::size_t MinReferencedPayloadSize = 128;
+
     typedef Socket<WorldSocket> BaseSocket;
 
 public:
@@ -95,10 +122,16 @@ public:
     bool Update() override;
 
     void SendPacket(WorldPacket const& packet);
+    void SendPacket(WorldPacket&& packet);
+    void SendPacket(std::shared_ptr<WorldPacket const> packet);
     void SetSendBufferSize(std::size_t sendBufferSize) { _sendBufferSize = sendBufferSize; }
 
     ConnectionType GetConnectionType() const { return _type; }
 
+    /// Payload bytes copied (into packet copies or send buffers) and written from shared packets, reset by World::Update
+    static std::atomic<uint64> PayloadBytesCopied;
+    static std::atomic<uint64> PayloadBytesShared;
+
     void SendAuthResponseError(uint8 code);
     void SetWorldSession(WorldSession* session);
 
@@ -123,8 +156,12 @@ private:
     /// writes network.opcode log
     /// accessing WorldSession is not threadsafe, only do it when holding _worldSessionLock
     void LogOpcodeText(OpcodeClient opcode, std::unique_lock<std::mutex> const& guard) const;
-    /// sends and logs network.opcode without accessing WorldSession
-    void SendPacketAndLogOpcode(WorldPacket const& packet);
+    /// writes, sends and logs network.opcode without accessing WorldSession, the written packet is moved to the send queue
+    void SendPacketAndLogOpcode(WorldPackets::ServerPacket& packet);
+    /// queues the not yet queued part of the send buffer, followed by payload
+    void QueueSendBuffer(boost::asio::const_buffer payload = boost::asio::const_buffer(), std::shared_ptr<void const> payloadOwner = nullptr);
+    /// compresses source with this connection's stream into a new packet, nullptr on failure
+    std::shared_ptr<WorldPacket> CompressPacket(WorldPacket const& source, int32 level);
     void HandleSendAuthSession();
     void HandleAuthSession(std::shared_ptr<WorldPackets::Auth::AuthSession> authSession);
     void HandleAuthSessionCallback(std::shared_ptr<WorldPackets::Auth::AuthSession> authSession, PreparedQueryResult result);
@@ -152,8 +189,10 @@ private:
     MessageBuffer _packetBuffer;
 
     z_stream_s* _compressionStream;
+    int32 _compressionLevel;
 
     MPSCQueue<EncryptablePacket, &EncryptablePacket::SocketQueueLink> _bufferQueue;
+    std::shared_ptr<MessageBuffer> _sendBuffer;     // queued packets reference ranges of it, the read position marks the end of the queued part
     std::size_t _sendBufferSize;
 
     QueryCallbackProcessor _queryProcessor;
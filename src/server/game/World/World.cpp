@@ -67,6 +67,7 @@
 #include "ObjectAccessor.h"
 #include "ObjectMgr.h"
 #include "OutdoorPvPMgr.h"
+#include "PacketCompressionPolicy.h"
 #include "PetitionMgr.h"
 #include "Player.h"
 #include "PlayerDump.h"
@@ -85,12 +86,14 @@
 #include "TransportMgr.h"
 #include "Unit.h"
 #include "UpdateTime.h"
+#include "Util.h"
 #include "VMapFactory.h"
 #include "VMapManager2.h"
 #include "WardenCheckMgr.h"
 #include "WaypointManager.h"
 #include "WeatherMgr.h"
 #include "WhoListStorage.h"
+#include "WorldLoadGraph.h"
 #include "WorldSession.h"
 #include "WorldStateMgr.h"
 #include "WorldSocket.h"
@@ -721,6 +724,8 @@ void World::LoadConfigSettings(bool reload)
         TC_LOG_ERROR("server.loading", "Compression level (%i) must be in range 1..9. Using default compression level (1).", m_int_configs[CONFIG_COMPRESSION]);
         m_int_configs[CONFIG_COMPRESSION] = 1;
     }
+    if (reload)
+        sPacketCompressionPolicy->LoadFromConfig();
     m_bool_configs[CONFIG_ADDON_CHANNEL] = sConfigMgr->GetBoolDefault("AddonChannel", true);
     m_bool_configs[CONFIG_CLEAN_CHARACTER_DB] = sConfigMgr->GetBoolDefault("CleanCharacterDB", false);
     m_int_configs[CONFIG_PERSISTENT_CHARACTER_CLEAN_FLAGS] = sConfigMgr->GetIntDefault("PersistentCharacterCleanFlags", 0);
@@ -1490,6 +1495,7 @@ void World::LoadConfigSettings(bool reload)
 
     VMAP::VMapFactory::createOrGetVMapManager()->setEnableLineOfSightCalc(enableLOS);
     VMAP::VMapFactory::createOrGetVMapManager()->setEnableHeightCalc(enableHeight);
+    VMAP::VMapFactory::createOrGetVMapManager()->setEnableCompactModelLayout(sConfigMgr->GetBoolDefault("vmap.enableCompactModels", false));
     TC_LOG_INFO("server.loading", "VMap support included. LineOfSight: %i, getHeight: %i, indoorCheck: %i", enableLOS, enableHeight, enableIndoor);
     TC_LOG_INFO("server.loading", "VMap data directory is: %svmaps", m_dataPath.c_str());
 
@@ -1513,6 +1519,10 @@ void World::LoadConfigSettings(bool reload)
     m_bool_configs[CONFIG_SHOW_MUTE_IN_WORLD] = sConfigMgr->GetBoolDefault("ShowMuteInWorld", false);
     m_bool_configs[CONFIG_SHOW_BAN_IN_WORLD] = sConfigMgr->GetBoolDefault("ShowBanInWorld", false);
     m_int_configs[CONFIG_NUMTHREADS] = sConfigMgr->GetIntDefault("MapUpdate.Threads", 1);
+    m_int_configs[CONFIG_MAP_UPDATE_REGION_THREADS] = sConfigMgr->GetIntDefault("MapUpdate.GridRegions.Threads", 0);
+    m_int_configs[CONFIG_MAP_GRID_PREFETCH_THREADS] = sConfigMgr->GetIntDefault("MapUpdate.GridPrefetch.Threads", 0);
+    m_int_configs[CONFIG_MAP_GRID_PREFETCH_LOOKAHEAD] = sConfigMgr->GetIntDefault("MapUpdate.GridPrefetch.Lookahead", 10);
+    m_int_configs[CONFIG_STARTUP_LOAD_THREADS] = sConfigMgr->GetIntDefault("Startup.LoadThreads", 0);
     m_int_configs[CONFIG_MAX_RESULTS_LOOKUP_COMMANDS] = sConfigMgr->GetIntDefault("Command.LookupMaxResults", 0);
 
     // Warden
@@ -1657,6 +1667,14 @@ void World::LoadConfigSettings(bool reload)
         sScriptMgr->OnConfigLoad(reload);
 }
 
+/// Resident memory report used to compare startup with and without streamed world database queries
+static void LogStartupMemoryUsage(char const* stage)
+{
+    Trinity::ProcessMemoryUsage usage = Trinity::GetProcessMemoryUsage();
+    TC_LOG_INFO("server.loading", "Memory usage %s: " UI64FMTD " MB resident, " UI64FMTD " MB peak (WorldDatabase.StreamQueries %s)",
+        stage, usage.Current / (1024 * 1024), usage.Peak / (1024 * 1024), WorldDatabase.IsStreamQueriesEnabled() ? "enabled" : "disabled");
+}
+
 /// Initialize the World
 void World::SetInitialWorldSettings()
 {
@@ -1960,6 +1978,8 @@ void World::SetInitialWorldSettings()
     TC_LOG_INFO("server.loading", "Loading Gameobject Data...");
     sObjectMgr->LoadGameObjects();
 
+    LogStartupMemoryUsage("after loading spawns");
+
     TC_LOG_INFO("server.loading", "Loading Spawn Group Data...");
     sObjectMgr->LoadSpawnGroups();
 
@@ -2085,173 +2105,339 @@ void World::SetInitialWorldSettings()
     TC_LOG_INFO("server.loading", "Loading Player level dependent mail rewards...");
     sObjectMgr->LoadMailLevelRewards();
 
-    // Loot tables
-    LoadLootTables();
+    ///- The remaining tables are loaded by a dependency graph, steps in different lanes run concurrently when Startup.LoadThreads is set
+    WorldLoadGraph loadGraph;
+
+    // Loot tables, reference loot is checked against all other stores
+    WorldLoadGraph::StepId lootLoaded = loadGraph.AddStep("Reference loot templates", &LoadLootTemplates_Reference,
+    {
+        loadGraph.AddStep("Creature loot templates", &LoadLootTemplates_Creature),
+        loadGraph.AddStep("Fishing loot templates", &LoadLootTemplates_Fishing),
+        loadGraph.AddStep("Gameobject loot templates", &LoadLootTemplates_Gameobject),
+        loadGraph.AddStep("Item loot templates", &LoadLootTemplates_Item),
+        loadGraph.AddStep("Mail loot templates", &LoadLootTemplates_Mail),
+        loadGraph.AddStep("Milling loot templates", &LoadLootTemplates_Milling),
+        loadGraph.AddStep("Pickpocketing loot templates", &LoadLootTemplates_Pickpocketing),
+        loadGraph.AddStep("Skinning loot templates", &LoadLootTemplates_Skinning),
+        loadGraph.AddStep("Disenchanting loot templates", &LoadLootTemplates_Disenchant),
+        loadGraph.AddStep("Prospecting loot templates", &LoadLootTemplates_Prospecting),
+        loadGraph.AddStep("Spell loot templates", &LoadLootTemplates_Spell)
+    });
+
+    WorldLoadGraph::StepId skillsLoaded = loadGraph.AddStep("Skill Discovery Table", []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Skill Discovery Table...");
+        LoadSkillDiscoveryTable();
+    });
+
+    skillsLoaded = loadGraph.AddStep("Skill Extra Item Table", []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Skill Extra Item Table...");
+        LoadSkillExtraItemTable();
+    }, { skillsLoaded });
+
+    skillsLoaded = loadGraph.AddStep("Skill Perfection Data Table", []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Skill Perfection Data Table...");
+        LoadSkillPerfectItemTable();
+    }, { skillsLoaded });
+
+    loadGraph.AddStep("Skill Fishing base level requirements", []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Skill Fishing base level requirements...");
+        sObjectMgr->LoadFishingBaseSkillLevel();
+    }, { skillsLoaded });
 
-    TC_LOG_INFO("server.loading", "Loading Skill Discovery Table...");
-    LoadSkillDiscoveryTable();
+    loadGraph.AddStep("Archaeology store", []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Archaeology store...");
+        sArchaeologyMgr->LoadData();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Skill Extra Item Table...");
-    LoadSkillExtraItemTable();
+    WorldLoadGraph::StepId achievementsLoaded = loadGraph.AddStep("Achievements", []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Achievements...");
+        sAchievementMgr->LoadAchievementReferenceList();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Skill Perfection Data Table...");
-    LoadSkillPerfectItemTable();
+    achievementsLoaded = loadGraph.AddStep("Achievement Criteria Lists", []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Achievement Criteria Lists...");
+        sAchievementMgr->LoadAchievementCriteriaList();
+    }, { achievementsLoaded });
 
-    TC_LOG_INFO("server.loading", "Loading Skill Fishing base level requirements...");
-    sObjectMgr->LoadFishingBaseSkillLevel();
+    achievementsLoaded = loadGraph.AddStep("Achievement Criteria Data", []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Achievement Criteria Data...");
+        sAchievementMgr->LoadAchievementCriteriaData();
+    }, { achievementsLoaded });
 
-    TC_LOG_INFO("server.loading", "Loading Archaeology store...");
-    sArchaeologyMgr->LoadData();
+    achievementsLoaded = loadGraph.AddStep("Achievement Rewards", []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Achievement Rewards...");
+        sAchievementMgr->LoadRewards();
+    }, { achievementsLoaded });
 
-    TC_LOG_INFO("server.loading", "Loading Achievements...");
-    sAchievementMgr->LoadAchievementReferenceList();
-    TC_LOG_INFO("server.loading", "Loading Achievement Criteria Lists...");
-    sAchievementMgr->LoadAchievementCriteriaList();
-    TC_LOG_INFO("server.loading", "Loading Achievement Criteria Data...");
-    sAchievementMgr->LoadAchievementCriteriaData();
-    TC_LOG_INFO("server.loading", "Loading Achievement Rewards...");
-    sAchievementMgr->LoadRewards();
-    TC_LOG_INFO("server.loading", "Loading Achievement Reward Locales...");
-    sAchievementMgr->LoadRewardLocales();
-    TC_LOG_INFO("server.loading", "Loading Completed Achievements...");
-    sAchievementMgr->LoadCompletedAchievements();
+    achievementsLoaded = loadGraph.AddStep("Achievement Reward Locales", []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Achievement Reward Locales...");
+        sAchievementMgr->LoadRewardLocales();
+    }, { achievementsLoaded });
 
-    ///- Load dynamic data tables from the database
-    TC_LOG_INFO("server.loading", "Loading Item Auctions...");
-    sAuctionMgr->LoadAuctionItems();
+    achievementsLoaded = loadGraph.AddStep("Completed Achievements", []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Completed Achievements...");
+        sAchievementMgr->LoadCompletedAchievements();
+    }, { achievementsLoaded });
 
-    TC_LOG_INFO("server.loading", "Loading Auctions...");
-    sAuctionMgr->LoadAuctions();
+    ///- Load dynamic data tables from the database, these update the character cache and keep their order
+    WorldLoadGraph::StepId charactersLoaded = loadGraph.AddStep("Item Auctions", []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Item Auctions...");
+        sAuctionMgr->LoadAuctionItems();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Guild XP for level...");
-    sGuildMgr->LoadGuildXpForLevel();
+    charactersLoaded = loadGraph.AddStep("Auctions", []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Auctions...");
+        sAuctionMgr->LoadAuctions();
+    }, { charactersLoaded });
 
-    TC_LOG_INFO("server.loading", "Loading Guild rewards...");
-    sGuildMgr->LoadGuildRewards();
+    charactersLoaded = loadGraph.AddStep("Guild XP for level", []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Guild XP for level...");
+        sGuildMgr->LoadGuildXpForLevel();
+    }, { charactersLoaded });
 
-    TC_LOG_INFO("server.loading", "Initializing Guild Profession Data Store...");
-    sGuildMgr->LoadGuildProfessionData();
+    charactersLoaded = loadGraph.AddStep("Guild rewards", []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Guild rewards...");
+        sGuildMgr->LoadGuildRewards();
+    }, { charactersLoaded });
 
-    TC_LOG_INFO("server.loading", "Loading Guild Challenges...");
-    sGuildMgr->LoadGuildChallenges();
+    charactersLoaded = loadGraph.AddStep("Guild Profession Data Store", []()
+    {
+        TC_LOG_INFO("server.loading", "Initializing Guild Profession Data Store...");
+        sGuildMgr->LoadGuildProfessionData();
+    }, { charactersLoaded });
 
-    TC_LOG_INFO("server.loading", "Loading Guilds...");
-    sGuildMgr->LoadGuilds();
+    charactersLoaded = loadGraph.AddStep("Guild Challenges", []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Guild Challenges...");
+        sGuildMgr->LoadGuildChallenges();
+    }, { charactersLoaded });
 
-    sGuildFinderMgr->LoadFromDB();
+    charactersLoaded = loadGraph.AddStep("Guilds", []()                                 // must be after achievements
+    {
+        TC_LOG_INFO("server.loading", "Loading Guilds...");
+        sGuildMgr->LoadGuilds();
+        sGuildFinderMgr->LoadFromDB();
+    }, { charactersLoaded, achievementsLoaded });
 
-    TC_LOG_INFO("server.loading", "Loading ArenaTeams...");
-    sArenaTeamMgr->LoadArenaTeams();
+    charactersLoaded = loadGraph.AddStep("ArenaTeams", []()
+    {
+        TC_LOG_INFO("server.loading", "Loading ArenaTeams...");
+        sArenaTeamMgr->LoadArenaTeams();
+    }, { charactersLoaded });
 
-    TC_LOG_INFO("server.loading", "Loading Groups...");
-    sGroupMgr->LoadGroups();
+    charactersLoaded = loadGraph.AddStep("Groups", []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Groups...");
+        sGroupMgr->LoadGroups();
+    }, { charactersLoaded });
 
-    TC_LOG_INFO("server.loading", "Loading ReservedNames...");
-    sObjectMgr->LoadReservedPlayersNames();
+    loadGraph.AddStep("ReservedNames", []()
+    {
+        TC_LOG_INFO("server.loading", "Loading ReservedNames...");
+        sObjectMgr->LoadReservedPlayersNames();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading GameObjects for quests...");
-    sObjectMgr->LoadGameObjectForQuests();
+    loadGraph.AddStep("GameObjects for quests", []()                                    // must be after loot templates
+    {
+        TC_LOG_INFO("server.loading", "Loading GameObjects for quests...");
+        sObjectMgr->LoadGameObjectForQuests();
+    }, { lootLoaded });
 
-    TC_LOG_INFO("server.loading", "Loading BattleMasters...");
-    sBattlegroundMgr->LoadBattleMastersEntry();                 // must be after load CreatureTemplate
+    loadGraph.AddStep("GameTeleports", []()
+    {
+        TC_LOG_INFO("server.loading", "Loading GameTeleports...");
+        sObjectMgr->LoadGameTele();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading GameTeleports...");
-    sObjectMgr->LoadGameTele();
+    // BattleMasters remove npcflags from creature templates, keep them ahead of everything reading npcflags
+    WorldLoadGraph::StepId gossipLoaded = loadGraph.AddStep("BattleMasters", []()
+    {
+        TC_LOG_INFO("server.loading", "Loading BattleMasters...");
+        sBattlegroundMgr->LoadBattleMastersEntry();                 // must be after load CreatureTemplate
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Trainers...");       // must be after LoadCreatureTemplates
-    sObjectMgr->LoadTrainers();
+    gossipLoaded = loadGraph.AddStep("Trainers", []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Trainers...");       // must be after LoadCreatureTemplates
+        sObjectMgr->LoadTrainers();
+    }, { gossipLoaded });
 
-    TC_LOG_INFO("server.loading", "Loading Gossip menu...");
-    sObjectMgr->LoadGossipMenu();
+    gossipLoaded = loadGraph.AddStep("Gossip menu", []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Gossip menu...");
+        sObjectMgr->LoadGossipMenu();
+    }, { gossipLoaded });
 
-    TC_LOG_INFO("server.loading", "Loading Gossip menu options...");
-    sObjectMgr->LoadGossipMenuItems();
+    gossipLoaded = loadGraph.AddStep("Gossip menu options", []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Gossip menu options...");
+        sObjectMgr->LoadGossipMenuItems();
+    }, { gossipLoaded });
 
-    TC_LOG_INFO("server.loading", "Loading Creature trainers...");
-    sObjectMgr->LoadCreatureTrainers();                         // must be after LoadGossipMenuItems
+    gossipLoaded = loadGraph.AddStep("Creature trainers", []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Creature trainers...");
+        sObjectMgr->LoadCreatureTrainers();                         // must be after LoadGossipMenuItems
+    }, { gossipLoaded });
 
-    TC_LOG_INFO("server.loading", "Loading Vendors...");
-    sObjectMgr->LoadVendors();                                   // must be after load CreatureTemplate and ItemTemplate
+    gossipLoaded = loadGraph.AddStep("Vendors", []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Vendors...");
+        sObjectMgr->LoadVendors();                                   // must be after load CreatureTemplate and ItemTemplate
+    }, { gossipLoaded });
 
-    TC_LOG_INFO("server.loading", "Loading Waypoints...");
-    sWaypointMgr->Load();
+    WorldLoadGraph::StepId waypointsLoaded = loadGraph.AddStep("Waypoints", []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Waypoints...");
+        sWaypointMgr->Load();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Waypoint Addons...");
-    sWaypointMgr->LoadWaypointAddons();
+    waypointsLoaded = loadGraph.AddStep("Waypoint Addons", []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Waypoint Addons...");
+        sWaypointMgr->LoadWaypointAddons();
+    }, { waypointsLoaded });
 
-    TC_LOG_INFO("server.loading", "Loading SmartAI Waypoints...");
-    sSmartWaypointMgr->LoadFromDB();
+    waypointsLoaded = loadGraph.AddStep("SmartAI Waypoints", []()
+    {
+        TC_LOG_INFO("server.loading", "Loading SmartAI Waypoints...");
+        sSmartWaypointMgr->LoadFromDB();
+    }, { waypointsLoaded });
 
-    TC_LOG_INFO("server.loading", "Loading Creature Formations...");
-    sFormationMgr->LoadCreatureFormations();
+    waypointsLoaded = loadGraph.AddStep("Creature Formations", []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Creature Formations...");
+        sFormationMgr->LoadCreatureFormations();
+    }, { waypointsLoaded });
 
-    TC_LOG_INFO("server.loading", "Loading World State templates...");
-    sWorldStateMgr->LoadFromDB();                               // must be loaded before battleground, outdoor PvP and conditions
+    WorldLoadGraph::StepId worldStatesLoaded = loadGraph.AddStep("World State templates", [this]()
+    {
+        TC_LOG_INFO("server.loading", "Loading World State templates...");
+        sWorldStateMgr->LoadFromDB();                               // must be loaded before battleground, outdoor PvP and conditions
 
-    TC_LOG_INFO("server.loading", "Loading Persistend World Variables...");
-    LoadPersistentWorldVariables();
+        TC_LOG_INFO("server.loading", "Loading Persistend World Variables...");
+        LoadPersistentWorldVariables();
 
-    sWorldStateMgr->SetValue(WS_CURRENT_PVP_SEASON_ID, getBoolConfig(CONFIG_ARENA_SEASON_IN_PROGRESS) ? getIntConfig(CONFIG_ARENA_SEASON_ID) : 0, false, nullptr);
-    sWorldStateMgr->SetValue(WS_PREVIOUS_PVP_SEASON_ID, getIntConfig(CONFIG_ARENA_SEASON_ID) - getBoolConfig(CONFIG_ARENA_SEASON_IN_PROGRESS), false, nullptr);
+        sWorldStateMgr->SetValue(WS_CURRENT_PVP_SEASON_ID, getBoolConfig(CONFIG_ARENA_SEASON_IN_PROGRESS) ? getIntConfig(CONFIG_ARENA_SEASON_ID) : 0, false, nullptr);
+        sWorldStateMgr->SetValue(WS_PREVIOUS_PVP_SEASON_ID, getIntConfig(CONFIG_ARENA_SEASON_ID) - getBoolConfig(CONFIG_ARENA_SEASON_IN_PROGRESS), false, nullptr);
+    });
 
-    sObjectMgr->LoadPhases();
+    loadGraph.AddStep("Phases", []()
+    {
+        sObjectMgr->LoadPhases();
+    }, { worldStatesLoaded });
 
-    TC_LOG_INFO("server.loading", "Loading Conditions...");
-    sConditionMgr->LoadConditions();
+    // Conditions are attached to loot, gossip, vendors and spells loaded above
+    WorldLoadGraph::StepId conditionsLoaded = loadGraph.AddBarrierStep("Conditions", []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Conditions...");
+        sConditionMgr->LoadConditions();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading faction change achievement pairs...");
-    sObjectMgr->LoadFactionChangeAchievements();
+    loadGraph.AddStep("Faction change pairs", []()
+    {
+        TC_LOG_INFO("server.loading", "Loading faction change achievement pairs...");
+        sObjectMgr->LoadFactionChangeAchievements();
 
-    TC_LOG_INFO("server.loading", "Loading faction change spell pairs...");
-    sObjectMgr->LoadFactionChangeSpells();
+        TC_LOG_INFO("server.loading", "Loading faction change spell pairs...");
+        sObjectMgr->LoadFactionChangeSpells();
 
-    TC_LOG_INFO("server.loading", "Loading faction change quest pairs...");
-    sObjectMgr->LoadFactionChangeQuests();
+        TC_LOG_INFO("server.loading", "Loading faction change quest pairs...");
+        sObjectMgr->LoadFactionChangeQuests();
 
-    TC_LOG_INFO("server.loading", "Loading faction change item pairs...");
-    sObjectMgr->LoadFactionChangeItems();
+        TC_LOG_INFO("server.loading", "Loading faction change item pairs...");
+        sObjectMgr->LoadFactionChangeItems();
 
-    TC_LOG_INFO("server.loading", "Loading faction change reputation pairs...");
-    sObjectMgr->LoadFactionChangeReputations();
+        TC_LOG_INFO("server.loading", "Loading faction change reputation pairs...");
+        sObjectMgr->LoadFactionChangeReputations();
 
-    TC_LOG_INFO("server.loading", "Loading faction change title pairs...");
-    sObjectMgr->LoadFactionChangeTitles();
+        TC_LOG_INFO("server.loading", "Loading faction change title pairs...");
+        sObjectMgr->LoadFactionChangeTitles();
+    }, { conditionsLoaded });
 
-    TC_LOG_INFO("server.loading", "Loading GM tickets...");
-    sTicketMgr->LoadTickets();
+    loadGraph.AddStep("GM tickets and surveys", []()
+    {
+        TC_LOG_INFO("server.loading", "Loading GM tickets...");
+        sTicketMgr->LoadTickets();
 
-    TC_LOG_INFO("server.loading", "Loading GM surveys...");
-    sTicketMgr->LoadSurveys();
+        TC_LOG_INFO("server.loading", "Loading GM surveys...");
+        sTicketMgr->LoadSurveys();
+    }, { conditionsLoaded });
 
-    TC_LOG_INFO("server.loading", "Loading client addons...");
-    AddonMgr::LoadFromDB();
+    loadGraph.AddStep("Client addons", []()
+    {
+        TC_LOG_INFO("server.loading", "Loading client addons...");
+        AddonMgr::LoadFromDB();
+    }, { conditionsLoaded });
 
     ///- Handle outdated emails (delete/return)
-    TC_LOG_INFO("server.loading", "Returning old mails...");
-    sObjectMgr->ReturnOrDeleteOldMails(false);
+    loadGraph.AddStep("Old mails", []()
+    {
+        TC_LOG_INFO("server.loading", "Returning old mails...");
+        sObjectMgr->ReturnOrDeleteOldMails(false);
+    }, { conditionsLoaded });
 
-    TC_LOG_INFO("server.loading", "Loading Autobroadcasts...");
-    LoadAutobroadcasts();
+    loadGraph.AddStep("Autobroadcasts", [this]()
+    {
+        TC_LOG_INFO("server.loading", "Loading Autobroadcasts...");
+        LoadAutobroadcasts();
+    }, { conditionsLoaded });
 
     ///- Load and initialize scripts
-    sObjectMgr->LoadSpellScripts();                              // must be after load Creature/Gameobject(Template/Data)
-    sObjectMgr->LoadEventScripts();                              // must be after load Creature/Gameobject(Template/Data)
-    sObjectMgr->LoadWaypointScripts();
+    loadGraph.AddStep("Scripts", []()
+    {
+        sObjectMgr->LoadSpellScripts();                              // must be after load Creature/Gameobject(Template/Data)
+        sObjectMgr->LoadEventScripts();                              // must be after load Creature/Gameobject(Template/Data)
+        sObjectMgr->LoadWaypointScripts();
+
+        TC_LOG_INFO("server.loading", "Loading spell script names...");
+        sObjectMgr->LoadSpellScriptNames();
+    }, { conditionsLoaded });
 
-    TC_LOG_INFO("server.loading", "Loading spell script names...");
-    sObjectMgr->LoadSpellScriptNames();
+    loadGraph.AddStep("Creature Texts", []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Creature Texts...");
+        sCreatureTextMgr->LoadCreatureTexts();
+
+        TC_LOG_INFO("server.loading", "Loading Creature Text Locales...");
+        sCreatureTextMgr->LoadCreatureTextLocales();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Creature Texts...");
-    sCreatureTextMgr->LoadCreatureTexts();
+    loadGraph.AddStep("Creature StaticFlags overrides", []()
+    {
+        TC_LOG_INFO("server.loading", "Loading creature StaticFlags overrides...");
+        sObjectMgr->LoadCreatureStaticFlagsOverride(); // must be after LoadCreatures
+    });
 
-    TC_LOG_INFO("server.loading", "Loading Creature Text Locales...");
-    sCreatureTextMgr->LoadCreatureTextLocales();
+    loadGraph.AddStep("Taxi node level definitions", []()
+    {
+        TC_LOG_INFO("server.loading", "Loading Taxi node level definitions...");
+        sObjectMgr->LoadTaxiNodeLevelData();
+    });
 
-    TC_LOG_INFO("server.loading", "Loading creature StaticFlags overrides...");
-    sObjectMgr->LoadCreatureStaticFlagsOverride(); // must be after LoadCreatures
+    // every step running concurrently needs a synchronous connection of its own or it spins waiting for one
+    uint32 loadThreads = getIntConfig(CONFIG_STARTUP_LOAD_THREADS);
+    if (loadThreads > WorldDatabase.GetSynchThreadCount() || loadThreads > CharacterDatabase.GetSynchThreadCount())
+        TC_LOG_WARN("server.loading", "Startup.LoadThreads (%u) is higher than WorldDatabase.SynchThreads (%u) or CharacterDatabase.SynchThreads (%u), load steps will wait for free connections.",
+            loadThreads, uint32(WorldDatabase.GetSynchThreadCount()), uint32(CharacterDatabase.GetSynchThreadCount()));
 
-    TC_LOG_INFO("server.loading", "Loading Taxi node level definitions...");
-    sObjectMgr->LoadTaxiNodeLevelData();
+    loadGraph.Run(loadThreads);
+    loadGraph.LogReport();
 
 #ifdef ELUNA
     if (sElunaConfig->IsElunaEnabled())
@@ -2353,6 +2539,7 @@ void World::SetInitialWorldSettings()
 
     TC_LOG_INFO("server.loading", "Initializing Opcodes...");
     opcodeTable.Initialize();
+    sPacketCompressionPolicy->LoadFromConfig();
 
     TC_LOG_INFO("server.loading", "Starting Arena Season...");
     sGameEventMgr->StartArenaSeason();
@@ -2399,9 +2586,13 @@ void World::SetInitialWorldSettings()
         GetEluna()->OnConfigLoad(false); // Must be done after Eluna is initialized and scripts have run.
 #endif
 
+    ///- Everything static is loaded, store queries missing from the world database snapshot
+    WorldDatabase.CloseSnapshot();
+
     uint32 startupDuration = GetMSTimeDiffToNow(startupBegin);
 
     TC_LOG_INFO("server.worldserver", "World initialized in %u minutes %u seconds", (startupDuration / 60000), ((startupDuration % 60000) / 1000));
+    LogStartupMemoryUsage("after startup");
 
     TC_METRIC_EVENT("events", "World initialized", "World initialized in " + std::to_string(startupDuration / 60000) + " minutes " + std::to_string((startupDuration % 60000) / 1000) + " seconds");
 
@@ -2655,6 +2846,8 @@ void World::Update(uint32 diff)
     // Stats logger update
     sMetric->Update();
     TC_METRIC_VALUE("update_time_diff", diff);
+    TC_METRIC_VALUE("packet_bytes_copied", WorldSocket::PayloadBytesCopied.exchange(0));
+    TC_METRIC_VALUE("packet_bytes_shared", WorldSocket::PayloadBytesShared.exchange(0));
 }
 
 void World::ForceGameEventUpdate()
@@ -2668,6 +2861,9 @@ void World::ForceGameEventUpdate()
 /// Send a packet to all players (except self if mentioned)
 void World::SendGlobalMessage(WorldPacket const* packet, WorldSession* self, uint32 team)
 {
+    // every session shares a single copy of the packet
+    std::shared_ptr<WorldPacket const> sharedPacket = WorldSession::MakeSharedPacket(packet);
+
     SessionMap::const_iterator itr;
     for (itr = m_sessions.begin(); itr != m_sessions.end(); ++itr)
     {
@@ -2677,7 +2873,7 @@ void World::SendGlobalMessage(WorldPacket const* packet, WorldSession* self, uin
             itr->second != self &&
             (team == 0 || itr->second->GetPlayer()->GetTeam() == team))
         {
-            itr->second->SendPacket(packet);
+            itr->second->SendPacket(sharedPacket);
         }
     }
 }
@@ -2685,6 +2881,9 @@ void World::SendGlobalMessage(WorldPacket const* packet, WorldSession* self, uin
 /// Send a packet to all GMs (except self if mentioned)
 void World::SendGlobalGMMessage(WorldPacket const* packet, WorldSession* self, uint32 team)
 {
+    // every session shares a single copy of the packet
+    std::shared_ptr<WorldPacket const> sharedPacket = WorldSession::MakeSharedPacket(packet);
+
     for (SessionMap::const_iterator itr = m_sessions.begin(); itr != m_sessions.end(); ++itr)
     {
         // check if session and can receive global GM Messages and its not self
@@ -2699,7 +2898,7 @@ void World::SendGlobalGMMessage(WorldPacket const* packet, WorldSession* self, u
 
         // Send only to same team, if team is given
         if (!team || player->GetTeam() == team)
-            session->SendPacket(packet);
+            session->SendPacket(sharedPacket);
     }
 }
 
@@ -2813,6 +3012,9 @@ void World::SendGlobalText(char const* text, WorldSession* self)
 /// Send a packet to all players (or players selected team) in the zone (except self if mentioned)
 bool World::SendZoneMessage(uint32 zone, WorldPacket const* packet, WorldSession* self, uint32 team)
 {
+    // every session shares a single copy of the packet
+    std::shared_ptr<WorldPacket const> sharedPacket = WorldSession::MakeSharedPacket(packet);
+
     bool foundPlayerToSend = false;
     SessionMap::const_iterator itr;
 
@@ -2825,7 +3027,7 @@ bool World::SendZoneMessage(uint32 zone, WorldPacket const* packet, WorldSession
             itr->second != self &&
             (team == 0 || itr->second->GetPlayer()->GetTeam() == team))
         {
-            itr->second->SendPacket(packet);
+            itr->second->SendPacket(sharedPacket);
             foundPlayerToSend = true;
         }
     }
@@ -347,6 +347,10 @@ enum WorldIntConfigs : uint8
     CONFIG_ENABLE_SINFO_LOGIN,
     CONFIG_PLAYER_ALLOW_COMMANDS,
     CONFIG_NUMTHREADS,
+    CONFIG_MAP_UPDATE_REGION_THREADS,
+    CONFIG_MAP_GRID_PREFETCH_THREADS,
+    CONFIG_MAP_GRID_PREFETCH_LOOKAHEAD,
+    CONFIG_STARTUP_LOAD_THREADS,
     CONFIG_LOGDB_CLEARINTERVAL,
     CONFIG_LOGDB_CLEARTIME,
     CONFIG_CLIENTCACHE_VERSION,
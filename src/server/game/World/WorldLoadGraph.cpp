@@ -0,0 +1,170 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "WorldLoadGraph.h"
+#include "Errors.h"
+#include "Log.h"
+#include "ThreadPool.h"
+#include "Timer.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+
+WorldLoadGraph::WorldLoadGraph() : _runTime(0), _threadCount(0)
+{
+}
+
+WorldLoadGraph::~WorldLoadGraph() = default;
+
+WorldLoadGraph::StepId WorldLoadGraph::AddStep(std::string name, std::function<void()> load, std::vector<StepId> dependencies)
+{
+    StepId id = StepId(_steps.size());
+
+    std::sort(dependencies.begin(), dependencies.end());
+    dependencies.erase(std::unique(dependencies.begin(), dependencies.end()), dependencies.end());
+
+    for (StepId dependency : dependencies)
+    {
+        ASSERT(dependency < id, "Load step %s depends on a step added after it", name.c_str());
+        _steps[dependency].Dependents.push_back(id);
+    }
+
+    Step& step = _steps.emplace_back();
+    step.Name = std::move(name);
+    step.Load = std::move(load);
+    step.Dependencies = std::move(dependencies);
+    step.Duration = 0;
+    return id;
+}
+
+WorldLoadGraph::StepId WorldLoadGraph::AddBarrierStep(std::string name, std::function<void()> load)
+{
+    std::vector<StepId> dependencies(_steps.size());
+    for (StepId id = 0; id < dependencies.size(); ++id)
+        dependencies[id] = id;
+
+    return AddStep(std::move(name), std::move(load), std::move(dependencies));
+}
+
+void WorldLoadGraph::RunStep(Step& step)
+{
+    uint32 oldMSTime = getMSTime();
+    step.Load();
+    step.Duration = GetMSTimeDiffToNow(oldMSTime);
+}
+
+void WorldLoadGraph::Run(uint32 threadCount)
+{
+    uint32 oldMSTime = getMSTime();
+    _threadCount = threadCount;
+
+    if (!threadCount)
+    {
+        for (Step& step : _steps)
+            RunStep(step);
+
+        _runTime = GetMSTimeDiffToNow(oldMSTime);
+        return;
+    }
+
+    // a step is posted to the pool by whichever step completes its last dependency
+    std::vector<std::atomic<uint32>> pendingDependencies(_steps.size());
+    for (StepId id = 0; id < _steps.size(); ++id)
+        pendingDependencies[id] = uint32(_steps[id].Dependencies.size());
+
+    // a step that throws does not start its dependents, the first exception is rethrown once the running steps are done
+    std::mutex failureLock;
+    std::exception_ptr failure;
+
+    Trinity::ThreadPool pool(threadCount);
+    std::function<void(StepId)> schedule = [&](StepId id)
+    {
+        pool.PostWork([&, id]()
+        {
+            try
+            {
+                RunStep(_steps[id]);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(failureLock);
+                if (!failure)
+                    failure = std::current_exception();
+                return;
+            }
+
+            for (StepId dependent : _steps[id].Dependents)
+                if (--pendingDependencies[dependent] == 0)
+                    schedule(dependent);
+        });
+    };
+
+    for (StepId id = 0; id < _steps.size(); ++id)
+        if (_steps[id].Dependencies.empty())
+            schedule(id);
+
+    pool.Join();
+
+    _runTime = GetMSTimeDiffToNow(oldMSTime);
+
+    if (failure)
+        std::rethrow_exception(failure);
+}
+
+void WorldLoadGraph::LogReport() const
+{
+    if (_steps.empty())
+        return;
+
+    // longest chain of dependencies ending at each step, steps are stored in a valid topological order
+    std::vector<uint32> pathTime(_steps.size(), 0);
+    std::vector<StepId> pathPrevious(_steps.size(), StepId(_steps.size()));
+    uint32 totalTime = 0;
+    StepId criticalEnd = 0;
+    for (StepId id = 0; id < _steps.size(); ++id)
+    {
+        for (StepId dependency : _steps[id].Dependencies)
+        {
+            if (pathPrevious[id] == _steps.size() || pathTime[dependency] > pathTime[id])
+            {
+                pathTime[id] = pathTime[dependency];
+                pathPrevious[id] = dependency;
+            }
+        }
+
+        pathTime[id] += _steps[id].Duration;
+        totalTime += _steps[id].Duration;
+        if (pathTime[id] > pathTime[criticalEnd])
+            criticalEnd = id;
+    }
+
+    std::vector<StepId> criticalPath;
+    for (StepId id = criticalEnd; id < _steps.size(); id = pathPrevious[id])
+        criticalPath.push_back(id);
+
+    if (_threadCount)
+        TC_LOG_INFO("server.loading", ">> Ran %u load steps on %u threads in %u ms, %u ms of work, critical path %u ms:",
+            uint32(_steps.size()), _threadCount, _runTime, totalTime, pathTime[criticalEnd]);
+    else
+        TC_LOG_INFO("server.loading", ">> Ran %u load steps sequentially in %u ms, critical path %u ms:",
+            uint32(_steps.size()), _runTime, pathTime[criticalEnd]);
+
+    for (auto itr = criticalPath.rbegin(); itr != criticalPath.rend(); ++itr)
+        TC_LOG_INFO("server.loading", "    %6u ms  %s", _steps[*itr].Duration, _steps[*itr].Name.c_str());
+}
@@ -0,0 +1,67 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef WorldLoadGraph_h__
+#define WorldLoadGraph_h__
+
+#include "Define.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+/// Runs startup load steps ordered by the dependencies they declare
+/// Steps without a path between them in the graph run concurrently on a thread pool, every step
+/// may only depend on steps added before it so insertion order is always a valid sequential order
+class TC_GAME_API WorldLoadGraph
+{
+public:
+    typedef uint32 StepId;
+
+    WorldLoadGraph();
+    ~WorldLoadGraph();
+
+    StepId AddStep(std::string name, std::function<void()> load, std::vector<StepId> dependencies = {});
+
+    /// Adds a step depending on every step added before it
+    StepId AddBarrierStep(std::string name, std::function<void()> load);
+
+    /// Runs all steps, on the calling thread in insertion order if threadCount is 0
+    /// A step that throws does not start its dependents, the exception is rethrown once the running steps are done
+    void Run(uint32 threadCount);
+
+    /// Logs wall time, summed step time and the slowest dependency chain of the last Run
+    void LogReport() const;
+
+private:
+    struct Step
+    {
+        std::string Name;
+        std::function<void()> Load;
+        std::vector<StepId> Dependencies;
+        std::vector<StepId> Dependents;
+        uint32 Duration;                                    // ms
+    };
+
+    void RunStep(Step& step);
+
+    std::vector<Step> _steps;
+    uint32 _runTime;                                        // ms
+    uint32 _threadCount;
+};
+
+#endif // WorldLoadGraph_h__
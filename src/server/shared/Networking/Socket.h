@@ -20,16 +20,21 @@
 
 #include "MessageBuffer.h"
 #include "Log.h"
+#include <algorithm>
+#include <array>
 #include <atomic>
-#include <queue>
+#include <deque>
 #include <memory>
 #include <functional>
 #include <type_traits>
+#include <vector>
+#include <boost/asio/buffer.hpp>
 #include <boost/asio/ip/tcp.hpp>
 
 using boost::asio::ip::tcp;
 
 #define READ_BLOCK_SIZE 4096
+#define MAX_WRITE_BUFFERS 64
 #ifdef BOOST_ASIO_HAS_IOCP
 #define TC_SOCKET_USE_IOCP
 #endif
@@ -103,7 +108,18 @@ public:
 
     void QueuePacket(MessageBuffer&& buffer)
     {
-        _writeQueue.push(std::move(buffer));
+        std::shared_ptr<MessageBuffer> owner = std::make_shared<MessageBuffer>(std::move(buffer));
+        boost::asio::const_buffer data = boost::asio::buffer(owner->GetReadPointer(), owner->GetActiveSize());
+        QueuePacket(data, std::move(owner));
+    }
+
+    /// Queues data followed by payload, both are written straight from the memory kept alive by their owners
+    /// so a send buffer can be shared by many queued packets and the same immutable payload can be queued
+    /// to any number of sockets without being copied
+    void QueuePacket(boost::asio::const_buffer data, std::shared_ptr<void const> dataOwner,
+        boost::asio::const_buffer payload = boost::asio::const_buffer(), std::shared_ptr<void const> payloadOwner = nullptr)
+    {
+        _writeQueue.emplace_back(data, std::move(dataOwner), payload, std::move(payloadOwner));
 
 #ifdef TC_SOCKET_USE_IOCP
         AsyncProcessQueue();
@@ -156,8 +172,9 @@ protected:
         _isWritingAsync = true;
 
 #ifdef TC_SOCKET_USE_IOCP
-        MessageBuffer& buffer = _writeQueue.front();
-        _socket.async_write_some(boost::asio::buffer(buffer.GetReadPointer(), buffer.GetActiveSize()), std::bind(&Socket<T>::WriteHandler,
+        WriteQueueEntry& entry = _writeQueue.front();
+        std::array<boost::asio::const_buffer, 2> buffers = { entry.Data, entry.Payload };
+        _socket.async_write_some(buffers, std::bind(&Socket<T>::WriteHandler,
             this->shared_from_this(), std::placeholders::_1, std::placeholders::_2));
 #else
         _socket.async_write_some(boost::asio::null_buffers(), std::bind(&Socket<T>::WriteHandlerWrapper,
@@ -177,6 +194,27 @@ protected:
     }
 
 private:
+    struct WriteQueueEntry
+    {
+        WriteQueueEntry(boost::asio::const_buffer data, std::shared_ptr<void const> dataOwner,
+            boost::asio::const_buffer payload, std::shared_ptr<void const> payloadOwner)
+            : Data(data), DataOwner(std::move(dataOwner)), Payload(payload), PayloadOwner(std::move(payloadOwner)) { }
+
+        std::size_t GetActiveSize() const { return Data.size() + Payload.size(); }
+
+        void ReadCompleted(std::size_t bytes)
+        {
+            std::size_t dataBytes = std::min(bytes, Data.size());
+            Data += dataBytes;
+            Payload += bytes - dataBytes;
+        }
+
+        boost::asio::const_buffer Data;
+        std::shared_ptr<void const> DataOwner;
+        boost::asio::const_buffer Payload;
+        std::shared_ptr<void const> PayloadOwner;
+    };
+
     void ReadHandlerInternal(boost::system::error_code error, size_t transferredBytes)
     {
         if (error)
@@ -198,7 +236,7 @@ private:
             _isWritingAsync = false;
             _writeQueue.front().ReadCompleted(transferedBytes);
             if (!_writeQueue.front().GetActiveSize())
-                _writeQueue.pop();
+                _writeQueue.pop_front();
 
             if (!_writeQueue.empty())
                 AsyncProcessQueue();
@@ -222,37 +260,59 @@ private:
         if (_writeQueue.empty())
             return false;
 
-        MessageBuffer& queuedMessage = _writeQueue.front();
+        // gather as many queued buffers as possible into a single vectored write
+        std::size_t bytesToSend = 0;
+        _writeBuffers.clear();
+        for (WriteQueueEntry& queuedMessage : _writeQueue)
+        {
+            if (_writeBuffers.size() + 2 > MAX_WRITE_BUFFERS)
+                break;
+
+            if (queuedMessage.Data.size())
+                _writeBuffers.push_back(queuedMessage.Data);
 
-        std::size_t bytesToSend = queuedMessage.GetActiveSize();
+            if (queuedMessage.Payload.size())
+                _writeBuffers.push_back(queuedMessage.Payload);
+
+            bytesToSend += queuedMessage.GetActiveSize();
+        }
 
         boost::system::error_code error;
-        std::size_t bytesSent = _socket.write_some(boost::asio::buffer(queuedMessage.GetReadPointer(), bytesToSend), error);
+        std::size_t bytesSent = _socket.write_some(_writeBuffers, error);
 
         if (error)
         {
             if (error == boost::asio::error::would_block || error == boost::asio::error::try_again)
                 return AsyncProcessQueue();
 
-            _writeQueue.pop();
+            _writeQueue.pop_front();
             if (_closing && _writeQueue.empty())
                 CloseSocket();
             return false;
         }
         else if (bytesSent == 0)
         {
-            _writeQueue.pop();
+            _writeQueue.pop_front();
             if (_closing && _writeQueue.empty())
                 CloseSocket();
             return false;
         }
-        else if (bytesSent < bytesToSend) // now n > 0
+
+        for (std::size_t bytesLeft = bytesSent; !_writeQueue.empty();)
         {
-            queuedMessage.ReadCompleted(bytesSent);
-            return AsyncProcessQueue();
+            WriteQueueEntry& queuedMessage = _writeQueue.front();
+            std::size_t completed = std::min(bytesLeft, queuedMessage.GetActiveSize());
+            queuedMessage.ReadCompleted(completed);
+            bytesLeft -= completed;
+            if (queuedMessage.GetActiveSize())
+                break;
+
+            _writeQueue.pop_front();
         }
 
-        _writeQueue.pop();
+        if (bytesSent < bytesToSend) // now n > 0
+            return AsyncProcessQueue();
+
         if (_closing && _writeQueue.empty())
             CloseSocket();
         return !_writeQueue.empty();
@@ -266,7 +326,10 @@ private:
     uint16 _remotePort;
 
     MessageBuffer _readBuffer;
-    std::queue<MessageBuffer> _writeQueue;
+    std::deque<WriteQueueEntry> _writeQueue;
+#ifndef TC_SOCKET_USE_IOCP
+    std::vector<boost::asio::const_buffer> _writeBuffers;
+#endif
 
     std::atomic<bool> _closed;
     std::atomic<bool> _closing;
@@ -39,6 +39,8 @@
 #include "ObjectAccessor.h"
 #include "OpenSSLCrypto.h"
 #include "OutdoorPvP/OutdoorPvPMgr.h"
+#include "PacketCompressionPolicy.h"
+#include "Player.h"
 #include "ProcessPriority.h"
 #include "RASession.h"
 #include "Realm.h"
@@ -283,6 +285,17 @@ extern int main(int argc, char** argv)
         TC_METRIC_VALUE("db_queue_character", CharacterDatabase.QueueSize());
         TC_METRIC_VALUE("db_queue_world", WorldDatabase.QueueSize());
         TC_METRIC_VALUE("db_queue_hotfix", HotfixDatabase.QueueSize());
+        LoginDatabase.LogGroupCommitStatistics();
+        CharacterDatabase.LogGroupCommitStatistics();
+        WorldDatabase.LogGroupCommitStatistics();
+        HotfixDatabase.LogGroupCommitStatistics();
+        LoginDatabase.LogQueueStatistics();
+        CharacterDatabase.LogQueueStatistics();
+        WorldDatabase.LogQueueStatistics();
+        HotfixDatabase.LogQueueStatistics();
+        sMapMgr->LogUpdateStatistics();
+        sPacketCompressionPolicy->LogStatistics();
+        Player::LogSaveStatistics();
     });
 
     TC_METRIC_EVENT("events", "Worldserver started", "");
@@ -702,7 +702,7 @@ bool ConvertADT(std::string const& inputPath, std::string const& outputPath, int
         }
     }
 
-    map.areaMapOffset = sizeof(map);
+    map.areaMapOffset = AlignMapSection(sizeof(map));
     map.areaMapSize = sizeof(map_areaHeader);
 
     map_areaHeader areaHeader;
@@ -761,7 +761,7 @@ bool ConvertADT(std::string const& inputPath, std::string const& outputPath, int
             maxHeight = CONF_use_minHeight;
     }
 
-    map.heightMapOffset = map.areaMapOffset + map.areaMapSize;
+    map.heightMapOffset = AlignMapSection(map.areaMapOffset + map.areaMapSize);
     map.heightMapSize = sizeof(map_heightHeader);
 
     map_heightHeader heightHeader;
@@ -883,7 +883,7 @@ bool ConvertADT(std::string const& inputPath, std::string const& outputPath, int
                 }
             }
         }
-        map.liquidMapOffset = map.heightMapOffset + map.heightMapSize;
+        map.liquidMapOffset = AlignMapSection(map.heightMapOffset + map.heightMapSize);
         map.liquidMapSize = sizeof(map_liquidHeader);
         liquidHeader.liquidMagic = MapLiquidMagic;
         liquidHeader.flags = map_liquidHeaderFlags::None;
@@ -919,9 +919,9 @@ bool ConvertADT(std::string const& inputPath, std::string const& outputPath, int
     if (hasHoles)
     {
         if (map.liquidMapOffset)
-            map.holesOffset = map.liquidMapOffset + map.liquidMapSize;
+            map.holesOffset = AlignMapSection(map.liquidMapOffset + map.liquidMapSize);
         else
-            map.holesOffset = map.heightMapOffset + map.heightMapSize;
+            map.holesOffset = AlignMapSection(map.heightMapOffset + map.heightMapSize);
 
         map.holesSize = sizeof(holes);
     }
@@ -939,13 +939,22 @@ bool ConvertADT(std::string const& inputPath, std::string const& outputPath, int
         return false;
     }
 
+    // zero fill up to the aligned start of the next section
+    auto padTo = [&outFile](uint32 offset)
+    {
+        static char const padding[MapSectionAlignment] = { };
+        outFile.write(padding, offset - uint32(outFile.tellp()));
+    };
+
     outFile.write(reinterpret_cast<const char*>(&map), sizeof(map));
     // Store area data
+    padTo(map.areaMapOffset);
     outFile.write(reinterpret_cast<const char*>(&areaHeader), sizeof(areaHeader));
     if (!areaHeader.flags.HasFlag(map_areaHeaderFlags::NoArea))
         outFile.write(reinterpret_cast<const char*>(area_ids), sizeof(area_ids));
 
     // Store height data
+    padTo(map.heightMapOffset);
     outFile.write(reinterpret_cast<const char*>(&heightHeader), sizeof(heightHeader));
     if (!heightHeader.flags.HasFlag(map_heightHeaderFlags::NoHeight))
     {
@@ -975,6 +984,7 @@ bool ConvertADT(std::string const& inputPath, std::string const& outputPath, int
     // Store liquid data if need
     if (map.liquidMapOffset)
     {
+        padTo(map.liquidMapOffset);
         outFile.write(reinterpret_cast<const char*>(&liquidHeader), sizeof(liquidHeader));
         if (!liquidHeader.flags.HasFlag(map_liquidHeaderFlags::NoType))
         {
@@ -991,7 +1001,10 @@ bool ConvertADT(std::string const& inputPath, std::string const& outputPath, int
 
     // store hole data
     if (hasHoles)
+    {
+        padTo(map.holesOffset);
         outFile.write(reinterpret_cast<const char*>(holes), map.holesSize);
+    }
 
     outFile.close();
 
@@ -0,0 +1,274 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "catch2/catch.hpp"
+#include "BoundingIntervalHierarchy.h"
+#include <random>
+#include <vector>
+
+namespace
+{
+    uint32 const QueryBatchSize = 16;
+
+    // axis aligned boxes scattered over a few tiles worth of space, standing in for model instances
+    std::vector<G3D::AABox> MakeBoxes(uint32 count, uint32 seed)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+        std::uniform_real_distribution<float> height(-50.0f, 50.0f);
+        std::uniform_real_distribution<float> extent(0.5f, 20.0f);
+        std::vector<G3D::AABox> boxes;
+        boxes.reserve(count);
+        for (uint32 i = 0; i < count; ++i)
+        {
+            G3D::Vector3 low(position(rng), position(rng), height(rng));
+            boxes.emplace_back(low, low + G3D::Vector3(extent(rng), extent(rng), extent(rng)));
+        }
+        return boxes;
+    }
+
+    bool IntersectBox(G3D::AABox const& box, G3D::Ray const& ray, float& maxDist)
+    {
+        float tmin = 0.0f;
+        float tmax = maxDist;
+        for (int i = 0; i < 3; ++i)
+        {
+            float invDir = 1.0f / ray.direction()[i];
+            float t1 = (box.low()[i] - ray.origin()[i]) * invDir;
+            float t2 = (box.high()[i] - ray.origin()[i]) * invDir;
+            if (t1 > t2)
+                std::swap(t1, t2);
+            tmin = std::max(tmin, t1);
+            tmax = std::min(tmax, t2);
+            if (tmin > tmax)
+                return false;
+        }
+
+        maxDist = tmin;
+        return true;
+    }
+
+    struct BoxBounds
+    {
+        void operator()(G3D::AABox const& box, G3D::AABox& out) const { out = box; }
+    };
+
+    struct SingleCallback
+    {
+        std::vector<G3D::AABox> const& Boxes;
+        std::vector<uint32>* Visited = nullptr;
+        bool Hit = false;
+
+        bool operator()(G3D::Ray const& ray, uint32 entry, float& maxDist, bool /*stopAtFirst*/)
+        {
+            if (Visited)
+                Visited->push_back(entry);
+            bool hit = IntersectBox(Boxes[entry], ray, maxDist);
+            Hit |= hit;
+            return hit;
+        }
+    };
+
+    struct PacketCallback
+    {
+        std::vector<G3D::AABox> const& Boxes;
+        std::vector<uint32>* Visited = nullptr;
+        bool Hit[BIH::PacketSize] = { };
+
+        bool operator()(uint32 lane, G3D::Ray const& ray, uint32 entry, float& maxDist, bool /*stopAtFirst*/)
+        {
+            if (Visited)
+                Visited[lane].push_back(entry);
+            bool hit = IntersectBox(Boxes[entry], ray, maxDist);
+            Hit[lane] |= hit;
+            return hit;
+        }
+    };
+
+    // deterministic stand-in for a busy map update: every query batch comes from one spot, half of it are height rays
+    // around the spot and the other half line of sight rays to a group of targets, like a creature picking a target
+    std::vector<G3D::Ray> MakeQueryTrace(uint32 count, uint32 seed, std::vector<float>& maxDist)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> position(-520.0f, 520.0f);
+        std::uniform_real_distribution<float> height(-60.0f, 60.0f);
+        std::uniform_real_distribution<float> offset(-40.0f, 40.0f);
+        std::uniform_real_distribution<float> jitter(-5.0f, 5.0f);
+        std::vector<G3D::Ray> rays;
+        rays.reserve(count);
+        maxDist.clear();
+        G3D::Vector3 origin;
+        G3D::Vector3 target;
+        for (uint32 i = 0; i < count; ++i)
+        {
+            if (i % QueryBatchSize == 0)
+            {
+                origin = G3D::Vector3(position(rng), position(rng), height(rng));
+                target = origin + G3D::Vector3(offset(rng), offset(rng), jitter(rng));
+            }
+
+            if (i % QueryBatchSize < QueryBatchSize / 2)
+            {
+                G3D::Vector3 from = origin + G3D::Vector3(jitter(rng), jitter(rng), 0.0f);
+                rays.push_back(G3D::Ray::fromOriginAndDirection(from, G3D::Vector3(0.0f, 0.0f, -1.0f)));
+                maxDist.push_back(50.0f);
+                continue;
+            }
+
+            G3D::Vector3 dir = target + G3D::Vector3(jitter(rng), jitter(rng), jitter(rng) * 0.2f) - origin;
+            float length = dir.magnitude();
+            rays.push_back(G3D::Ray::fromOriginAndDirection(origin, dir / length));
+            maxDist.push_back(length);
+        }
+        return rays;
+    }
+
+    // groups the rays of each query batch with equal direction signs into packets
+    template<class Callback>
+    void TraversePackets(std::vector<G3D::Ray> const& rays, std::vector<float> const& maxDist, Callback&& callback)
+    {
+        G3D::Ray packetRays[BIH::PacketSize];
+        float packetDist[BIH::PacketSize];
+        uint32 packetIndex[BIH::PacketSize];
+        uint32 packetCount = 0;
+        auto flush = [&]()
+        {
+            if (!packetCount)
+                return;
+            callback(packetRays, packetDist, packetIndex, packetCount);
+            packetCount = 0;
+        };
+
+        for (uint32 batch = 0; batch < rays.size(); batch += QueryBatchSize)
+        {
+            uint32 batchEnd = std::min<uint32>(batch + QueryBatchSize, rays.size());
+            for (uint32 signs = 0; signs < 8; ++signs)
+            {
+                for (uint32 i = batch; i < batchEnd; ++i)
+                {
+                    if (BIH::getDirectionSigns(rays[i]) != signs)
+                        continue;
+
+                    packetRays[packetCount] = rays[i];
+                    packetDist[packetCount] = maxDist[i];
+                    packetIndex[packetCount] = i;
+                    if (++packetCount == BIH::PacketSize)
+                        flush();
+                }
+                flush();
+            }
+        }
+    }
+}
+
+TEST_CASE("Ray packets find the same hits as single rays", "[BIH]")
+{
+    std::vector<G3D::AABox> boxes = MakeBoxes(2000, 1);
+    BIH tree;
+    BoxBounds bounds;
+    tree.build(boxes, bounds);
+
+    std::vector<float> maxDist;
+    std::vector<G3D::Ray> rays = MakeQueryTrace(3000, 2, maxDist);
+
+    for (bool stopAtFirst : { false, true })
+    {
+        uint32 mismatches = 0;
+        uint32 hits = 0;
+        TraversePackets(rays, maxDist, [&](G3D::Ray const* packetRays, float* dist, uint32 const* index, uint32 count)
+        {
+            std::vector<uint32> packetVisited[BIH::PacketSize];
+            PacketCallback packet{ boxes, packetVisited };
+            tree.intersectRayPacket(packetRays, count, packet, dist, stopAtFirst);
+            for (uint32 lane = 0; lane < count; ++lane)
+            {
+                std::vector<uint32> singleVisited;
+                SingleCallback single{ boxes, &singleVisited };
+                float singleDist = maxDist[index[lane]];
+                tree.intersectRay(packetRays[lane], single, singleDist, stopAtFirst);
+                if (single.Hit != packet.Hit[lane] || singleDist != dist[lane] || singleVisited != packetVisited[lane])
+                    ++mismatches;
+                if (single.Hit)
+                    ++hits;
+            }
+        });
+
+        CHECK(hits > 0);
+        REQUIRE(mismatches == 0);
+    }
+}
+
+TEST_CASE("Ray packets with fewer rays than lanes", "[BIH]")
+{
+    std::vector<G3D::AABox> boxes = { G3D::AABox(G3D::Vector3(-1.0f, -1.0f, -1.0f), G3D::Vector3(1.0f, 1.0f, 1.0f)) };
+    BIH tree;
+    BoxBounds bounds;
+    tree.build(boxes, bounds);
+
+    G3D::Ray rays[2] = {
+        G3D::Ray::fromOriginAndDirection(G3D::Vector3(0.0f, 0.0f, 10.0f), G3D::Vector3(0.0f, 0.0f, -1.0f)),
+        G3D::Ray::fromOriginAndDirection(G3D::Vector3(5.0f, 5.0f, 10.0f), G3D::Vector3(0.0f, 0.0f, -1.0f))
+    };
+    float dist[2] = { 20.0f, 20.0f };
+    std::vector<uint32> visited[BIH::PacketSize];
+    PacketCallback packet{ boxes, visited };
+    tree.intersectRayPacket(rays, 2, packet, dist, false);
+
+    REQUIRE(packet.Hit[0]);
+    REQUIRE(dist[0] == Approx(9.0f));
+    REQUIRE_FALSE(packet.Hit[1]);
+    REQUIRE(dist[1] == 20.0f);
+    for (uint32 lane = 2; lane < BIH::PacketSize; ++lane)
+        REQUIRE(visited[lane].empty());
+}
+
+TEST_CASE("Query trace replay", "[.][benchmark][BIH]")
+{
+    std::vector<G3D::AABox> boxes = MakeBoxes(20000, 1);
+    BIH tree;
+    BoxBounds bounds;
+    tree.build(boxes, bounds);
+
+    std::vector<float> maxDist;
+    std::vector<G3D::Ray> rays = MakeQueryTrace(4096, 3, maxDist);
+
+    BENCHMARK("single rays")
+    {
+        uint32 hits = 0;
+        for (uint32 i = 0; i < rays.size(); ++i)
+        {
+            SingleCallback callback{ boxes };
+            float dist = maxDist[i];
+            tree.intersectRay(rays[i], callback, dist, true);
+            hits += callback.Hit;
+        }
+        return hits;
+    };
+
+    BENCHMARK("ray packets")
+    {
+        uint32 hits = 0;
+        TraversePackets(rays, maxDist, [&](G3D::Ray const* packetRays, float* packetDist, uint32 const* /*index*/, uint32 count)
+        {
+            PacketCallback callback{ boxes };
+            tree.intersectRayPacket(packetRays, count, callback, packetDist, true);
+            for (uint32 lane = 0; lane < count; ++lane)
+                hits += callback.Hit[lane];
+        });
+        return hits;
+    };
+}
@@ -0,0 +1,211 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "catch2/catch.hpp"
+#include "WorldModel.h"
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace VMAP;
+
+namespace
+{
+    // rolling terrain with crates scattered over it, roughly the shape of a WMO group with clutter
+    GroupModel MakeGroupModel(uint32 seed)
+    {
+        std::mt19937 rng(seed);
+        std::vector<G3D::Vector3> vertices;
+        std::vector<MeshTriangle> triangles;
+
+        uint32 const cells = 96;
+        float const cellSize = 2.0f;
+        std::uniform_real_distribution<float> noise(-0.5f, 0.5f);
+        for (uint32 y = 0; y <= cells; ++y)
+            for (uint32 x = 0; x <= cells; ++x)
+                vertices.emplace_back(x * cellSize, y * cellSize, 4.0f * std::sin(x * 0.15f) * std::cos(y * 0.1f) + noise(rng));
+
+        for (uint32 y = 0; y < cells; ++y)
+        {
+            for (uint32 x = 0; x < cells; ++x)
+            {
+                uint32 corner = y * (cells + 1) + x;
+                triangles.emplace_back(corner, corner + 1, corner + cells + 1);
+                triangles.emplace_back(corner + 1, corner + cells + 2, corner + cells + 1);
+            }
+        }
+
+        std::uniform_real_distribution<float> position(0.0f, cells * cellSize);
+        std::uniform_real_distribution<float> extent(0.5f, 4.0f);
+        for (uint32 crate = 0; crate < 400; ++crate)
+        {
+            G3D::Vector3 lo(position(rng), position(rng), noise(rng));
+            G3D::Vector3 hi = lo + G3D::Vector3(extent(rng), extent(rng), extent(rng));
+            uint32 first = uint32(vertices.size());
+            for (uint32 corner = 0; corner < 8; ++corner)
+                vertices.emplace_back(corner & 1 ? hi.x : lo.x, corner & 2 ? hi.y : lo.y, corner & 4 ? hi.z : lo.z);
+
+            static uint32 const faces[12][3] =
+            {
+                { 0, 1, 3 }, { 0, 3, 2 }, { 4, 6, 7 }, { 4, 7, 5 }, { 0, 4, 5 }, { 0, 5, 1 },
+                { 2, 3, 7 }, { 2, 7, 6 }, { 0, 2, 6 }, { 0, 6, 4 }, { 1, 5, 7 }, { 1, 7, 3 }
+            };
+            for (auto const& face : faces)
+                triangles.emplace_back(first + face[0], first + face[1], first + face[2]);
+        }
+
+        G3D::AABox bound(vertices[0], vertices[0]);
+        for (G3D::Vector3 const& vertex : vertices)
+            bound.merge(vertex);
+
+        GroupModel model(0, 0, bound);
+        model.setMeshData(vertices, triangles);
+        return model;
+    }
+
+    struct RayQuery
+    {
+        G3D::Ray Ray;
+        float MaxDist;
+        bool StopAtFirstHit;
+    };
+
+    // height checks straight down and line of sight checks between points above the ground
+    std::vector<RayQuery> MakeQueries(G3D::AABox const& bound, uint32 count, uint32 seed)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> x(bound.low().x, bound.high().x);
+        std::uniform_real_distribution<float> y(bound.low().y, bound.high().y);
+        std::uniform_real_distribution<float> z(bound.low().z, bound.high().z + 2.0f);
+        std::uniform_real_distribution<float> offset(-30.0f, 30.0f);
+        std::vector<RayQuery> queries;
+        queries.reserve(count);
+        for (uint32 i = 0; i < count; ++i)
+        {
+            G3D::Vector3 from(x(rng), y(rng), z(rng));
+            if (i % 2 == 0)
+            {
+                queries.push_back({ G3D::Ray(from, G3D::Vector3(0.0f, 0.0f, -1.0f)), 50.0f, false });
+                continue;
+            }
+
+            G3D::Vector3 dir(offset(rng), offset(rng), offset(rng) * 0.1f);
+            float length = dir.magnitude();
+            queries.push_back({ G3D::Ray::fromOriginAndDirection(from, dir / length), length, true });
+        }
+        return queries;
+    }
+
+    uint32 CastRays(std::vector<GroupModel> const& models, std::vector<RayQuery> const& queries)
+    {
+        uint32 hits = 0;
+        for (RayQuery const& query : queries)
+        {
+            for (GroupModel const& model : models)
+            {
+                float distance = query.MaxDist;
+                if (model.IntersectRay(query.Ray, distance, query.StopAtFirstHit))
+                {
+                    ++hits;
+                    break;
+                }
+            }
+        }
+        return hits;
+    }
+}
+
+TEST_CASE("Compact layout finds the same hits as the BIH", "[BVH4]")
+{
+    GroupModel model = MakeGroupModel(1);
+    GroupModel compact = model;
+    compact.buildCompactMesh();
+
+    uint32 mismatches = 0;
+    uint32 hits = 0;
+    for (RayQuery const& query : MakeQueries(model.GetBound(), 5000, 2))
+    {
+        float distance = query.MaxDist;
+        float compactDistance = query.MaxDist;
+        bool hit = model.IntersectRay(query.Ray, distance, query.StopAtFirstHit);
+        bool compactHit = compact.IntersectRay(query.Ray, compactDistance, query.StopAtFirstHit);
+
+        // the first hit found differs between the trees, only the closest hit is comparable
+        if (hit != compactHit || (!query.StopAtFirstHit && distance != compactDistance))
+            ++mismatches;
+        hits += hit;
+    }
+
+    CHECK(hits > 0);
+    REQUIRE(mismatches == 0);
+}
+
+TEST_CASE("Compact layout of small and empty meshes", "[BVH4]")
+{
+    std::vector<G3D::Vector3> vertices = { { 0.0f, 0.0f, 0.0f }, { 4.0f, 0.0f, 0.0f }, { 0.0f, 4.0f, 0.0f } };
+    std::vector<MeshTriangle> triangles = { MeshTriangle(0, 1, 2) };
+    GroupModel model(0, 0, G3D::AABox(vertices[0], G3D::Vector3(4.0f, 4.0f, 0.0f)));
+    model.setMeshData(vertices, triangles);
+    model.buildCompactMesh();
+
+    float distance = 10.0f;
+    REQUIRE(model.IntersectRay(G3D::Ray(G3D::Vector3(1.0f, 1.0f, 5.0f), G3D::Vector3(0.0f, 0.0f, -1.0f)), distance, false));
+    REQUIRE(distance == Approx(5.0f));
+
+    distance = 10.0f;
+    REQUIRE_FALSE(model.IntersectRay(G3D::Ray(G3D::Vector3(3.0f, 3.0f, 5.0f), G3D::Vector3(0.0f, 0.0f, -1.0f)), distance, false));
+
+    GroupModel empty;
+    empty.buildCompactMesh();
+    distance = 10.0f;
+    REQUIRE_FALSE(empty.IntersectRay(G3D::Ray(G3D::Vector3(0.0f, 0.0f, 5.0f), G3D::Vector3(0.0f, 0.0f, -1.0f)), distance, false));
+}
+
+// Set VMAP_BENCHMARK_MODEL to the path of an extracted .vmo file to benchmark a real model instead of the synthetic one
+TEST_CASE("Model ray cast throughput", "[.][benchmark][BVH4]")
+{
+    std::vector<GroupModel> models;
+    if (char const* path = std::getenv("VMAP_BENCHMARK_MODEL"))
+    {
+        WorldModel worldModel;
+        REQUIRE(worldModel.readFile(path));
+        worldModel.getGroupModels(models);
+    }
+    else
+        models.push_back(MakeGroupModel(1));
+
+    G3D::AABox bound = models[0].GetBound();
+    for (GroupModel const& model : models)
+        bound.merge(model.GetBound());
+
+    std::vector<GroupModel> compactModels = models;
+    for (GroupModel& model : compactModels)
+        model.buildCompactMesh();
+
+    std::vector<RayQuery> queries = MakeQueries(bound, 4096, 3);
+
+    BENCHMARK("bounding interval hierarchy")
+    {
+        return CastRays(models, queries);
+    };
+
+    BENCHMARK("compact 4-wide tree")
+    {
+        return CastRays(compactModels, queries);
+    };
+}
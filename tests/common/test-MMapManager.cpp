@@ -0,0 +1,185 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "catch2/catch.hpp"
+#include "MMapManager.h"
+#include "DetourAlloc.h"
+#include "DetourNavMeshBuilder.h"
+#include "MMapDefines.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <thread>
+
+namespace
+{
+    constexpr uint32 TestMeshMapId = 999;
+
+    // writes a navmesh header without tiles, enough for loadMapData to create the dtNavMesh
+    std::string CreateTestMeshDirectory()
+    {
+        std::filesystem::path basePath = std::filesystem::temp_directory_path() / "tc-test-mmaps";
+        std::filesystem::create_directories(basePath / "mmaps");
+
+        dtNavMeshParams params = { };
+        params.tileWidth = 533.33333f;
+        params.tileHeight = 533.33333f;
+        params.maxTiles = 64;
+        params.maxPolys = 1024;
+
+        std::string fileName = (basePath / "mmaps" / "999.mmap").string();
+        FILE* file = fopen(fileName.c_str(), "wb");
+        REQUIRE(file);
+        REQUIRE(fwrite(&params, sizeof(params), 1, file) == 1);
+        fclose(file);
+
+        return basePath.string() + "/";
+    }
+
+    // writes tile [0, 0] of the test navmesh, a single flat square polygon
+    void CreateTestTile(std::string const& basePath)
+    {
+        unsigned short const verts[] = { 0, 0, 0,  0, 0, 500,  500, 0, 500,  500, 0, 0 };
+        unsigned short polys[2 * DT_VERTS_PER_POLYGON];
+        std::fill(std::begin(polys), std::end(polys), 0xFFFF);
+        for (unsigned short i = 0; i < 4; ++i)
+            polys[i] = i;
+        unsigned short const polyFlags[] = { NAV_GROUND };
+        unsigned char const polyAreas[] = { NAV_AREA_GROUND };
+
+        dtNavMeshCreateParams params = { };
+        params.verts = verts;
+        params.vertCount = 4;
+        params.polys = polys;
+        params.polyFlags = polyFlags;
+        params.polyAreas = polyAreas;
+        params.polyCount = 1;
+        params.nvp = DT_VERTS_PER_POLYGON;
+        params.bmax[0] = 533.33333f;
+        params.bmax[1] = 10.0f;
+        params.bmax[2] = 533.33333f;
+        params.walkableHeight = 2.0f;
+        params.walkableRadius = 0.5f;
+        params.walkableClimb = 1.0f;
+        params.cs = 1.0f;
+        params.ch = 1.0f;
+        params.buildBvTree = true;
+
+        unsigned char* data = nullptr;
+        int dataSize = 0;
+        REQUIRE(dtCreateNavMeshData(&params, &data, &dataSize));
+
+        MmapTileHeader header;
+        header.size = uint32(dataSize);
+
+        std::string fileName = basePath + "mmaps/9990000.mmtile";
+        FILE* file = fopen(fileName.c_str(), "wb");
+        REQUIRE(file);
+        REQUIRE(fwrite(&header, sizeof(header), 1, file) == 1);
+        REQUIRE(fwrite(data, dataSize, 1, file) == 1);
+        fclose(file);
+        dtFree(data);
+    }
+}
+
+TEST_CASE("Navmesh queries are per thread and shared by instances", "[MMapManager]")
+{
+    std::string basePath = CreateTestMeshDirectory();
+    MMAP::MMapManager manager;
+
+    REQUIRE(manager.GetNavMeshQuery(TestMeshMapId, TestMeshMapId, 1) == nullptr);
+
+    REQUIRE(manager.loadMapInstance(basePath, TestMeshMapId, TestMeshMapId, 1));
+    REQUIRE(manager.loadMapInstance(basePath, TestMeshMapId, TestMeshMapId, 2));
+
+    dtNavMeshQuery const* query = manager.GetNavMeshQuery(TestMeshMapId, TestMeshMapId, 1);
+    REQUIRE(query != nullptr);
+    REQUIRE(query->getAttachedNavMesh() == manager.GetNavMesh(TestMeshMapId));
+    REQUIRE(manager.GetNavMeshQuery(TestMeshMapId, TestMeshMapId, 1) == query);
+    REQUIRE(manager.GetNavMeshQuery(TestMeshMapId, TestMeshMapId, 2) == query);
+
+    dtNavMeshQuery const* otherThreadQuery = nullptr;
+    std::thread([&] { otherThreadQuery = manager.GetNavMeshQuery(TestMeshMapId, TestMeshMapId, 2); }).join();
+    REQUIRE(otherThreadQuery != nullptr);
+    REQUIRE(otherThreadQuery != query);
+    REQUIRE(otherThreadQuery->getAttachedNavMesh() == manager.GetNavMesh(TestMeshMapId));
+
+    REQUIRE(manager.unloadMapInstance(TestMeshMapId, TestMeshMapId, 1));
+    REQUIRE_FALSE(manager.unloadMapInstance(TestMeshMapId, TestMeshMapId, 1));
+    REQUIRE(manager.GetNavMeshQuery(TestMeshMapId, TestMeshMapId, 1) == nullptr);
+    REQUIRE(manager.GetNavMeshQuery(TestMeshMapId, TestMeshMapId, 2) == query);
+
+    REQUIRE(manager.unloadMapInstance(TestMeshMapId, TestMeshMapId, 2));
+    REQUIRE(manager.unloadMap(TestMeshMapId));
+    REQUIRE(manager.GetNavMesh(TestMeshMapId) == nullptr);
+
+    // the query this thread remembers belongs to the unloaded navmesh
+    REQUIRE(manager.loadMapInstance(basePath, TestMeshMapId, TestMeshMapId, 1));
+    std::shared_lock<std::shared_mutex> navMeshLock = manager.LockNavMesh(TestMeshMapId);
+    REQUIRE(navMeshLock.owns_lock());
+    query = manager.GetNavMeshQuery(TestMeshMapId, TestMeshMapId, 1);
+    REQUIRE(query != nullptr);
+    REQUIRE(query->getAttachedNavMesh() == manager.GetNavMesh(TestMeshMapId));
+    navMeshLock.unlock();
+
+    REQUIRE(manager.unloadMapInstance(TestMeshMapId, TestMeshMapId, 1));
+    REQUIRE(manager.unloadMap(TestMeshMapId));
+}
+
+TEST_CASE("Navmesh tiles are not changed while a path query holds the navmesh", "[MMapManager]")
+{
+    std::string basePath = CreateTestMeshDirectory();
+    CreateTestTile(basePath);
+    MMAP::MMapManager manager;
+
+    REQUIRE(manager.loadMapInstance(basePath, TestMeshMapId, TestMeshMapId, 1));
+
+    std::shared_lock<std::shared_mutex> navMeshLock = manager.LockNavMesh(TestMeshMapId);
+    REQUIRE(navMeshLock.owns_lock());
+    REQUIRE(manager.GetNavMeshQuery(TestMeshMapId, TestMeshMapId, 1) != nullptr);
+
+    // the grid of another instance is loaded on another thread, it has to wait for the query
+    std::atomic<bool> loaded = false;
+    std::thread loader([&] { loaded = manager.loadMap(basePath, TestMeshMapId, 0, 0); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    REQUIRE_FALSE(loaded);
+
+    navMeshLock.unlock();
+    loader.join();
+    REQUIRE(loaded);
+    REQUIRE(manager.getLoadedTilesCount() == 1);
+
+    navMeshLock = manager.LockNavMesh(TestMeshMapId);
+    dtNavMeshQuery const* query = manager.GetNavMeshQuery(TestMeshMapId, TestMeshMapId, 1);
+    dtQueryFilter filter;
+    float const center[3] = { 250.0f, 0.0f, 250.0f };
+    float const extents[3] = { 3.0f, 5.0f, 3.0f };
+    dtPolyRef polyRef = 0;
+    REQUIRE(dtStatusSucceed(query->findNearestPoly(center, extents, &filter, &polyRef, nullptr)));
+    REQUIRE(polyRef != 0);
+
+    // a path calculation releases the navmesh before looking up terrain, which may load or unload the grid on the same thread
+    navMeshLock.unlock();
+    REQUIRE(manager.unloadMap(TestMeshMapId, 0, 0));
+    REQUIRE(manager.getLoadedTilesCount() == 0);
+
+    REQUIRE(manager.unloadMapInstance(TestMeshMapId, TestMeshMapId, 1));
+    REQUIRE(manager.unloadMap(TestMeshMapId));
+}
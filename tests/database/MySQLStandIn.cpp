@@ -0,0 +1,669 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MySQLStandIn.h"
+#include "MySQLHacks.h"
+#include <mysqld_error.h>
+#include <atomic>
+#include <cctype>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+// mysql 8 returns uint64_t where older versions and mariadb return my_ulonglong
+using MySQLRowCount = decltype(mysql_affected_rows(nullptr));
+
+namespace
+{
+    std::atomic<uint32> Latency{ 0 };           // microseconds
+    std::atomic<uint32> RowsPerSelect{ 1 };
+    std::atomic<uint32> DeadlockEvery{ 0 };
+    std::atomic<uint32> Transactions{ 0 };
+
+    std::atomic<uint64> Queries{ 0 };
+    std::atomic<uint64> Statements{ 0 };
+    std::atomic<uint64> Commits{ 0 };
+    std::atomic<uint64> Rollbacks{ 0 };
+    std::atomic<uint64> Deadlocks{ 0 };
+
+    char const StandInName[] = "stand-in";
+
+    enum class StatementKind
+    {
+        Select,
+        Write,
+        StartTransaction,
+        Commit,
+        Rollback
+    };
+
+    struct Connection
+    {
+        MYSQL Handle;
+        uint32 Errno;
+        std::string Error;
+        bool FailNextStatement;
+        MySQLRowCount AffectedRows;
+        unsigned int FieldCount;
+        MYSQL_RES* PendingResult;
+    };
+
+    struct Result
+    {
+        MYSQL_RES Handle;
+        std::vector<MYSQL_FIELD> Fields;
+        uint64 RowCount;
+        uint64 NextRow;
+        std::vector<std::string> Values;
+        std::vector<char*> Row;
+        std::vector<unsigned long> Lengths;
+    };
+
+    struct Statement
+    {
+        MYSQL_STMT Handle;
+        StatementKind Kind;
+        unsigned long ParamCount;
+        unsigned int FieldCount;
+        uint64 RowCount;
+        uint64 NextRow;
+        std::string Error;
+    };
+
+    // the mysql handles are the first members, so the pointers handed out convert back
+    Connection* ToConnection(MYSQL* mysql) { return reinterpret_cast<Connection*>(mysql); }
+    Result* ToResult(MYSQL_RES* result) { return reinterpret_cast<Result*>(result); }
+    Statement* ToStatement(MYSQL_STMT* stmt) { return reinterpret_cast<Statement*>(stmt); }
+
+    void RoundTrip()
+    {
+        if (uint32 latency = Latency.load(std::memory_order_relaxed))
+            std::this_thread::sleep_for(std::chrono::microseconds(latency));
+    }
+
+    bool StartsWithKeyword(char const* sql, char const* keyword)
+    {
+        while (*sql && (std::isspace(uint8(*sql)) || *sql == '('))
+            ++sql;
+
+        size_t length = strlen(keyword);
+        for (size_t i = 0; i < length; ++i)
+            if (std::toupper(uint8(sql[i])) != keyword[i])
+                return false;
+
+        return !std::isalnum(uint8(sql[length])) && sql[length] != '_';
+    }
+
+    StatementKind Classify(char const* sql)
+    {
+        if (StartsWithKeyword(sql, "SELECT"))
+            return StatementKind::Select;
+        if (StartsWithKeyword(sql, "START") || StartsWithKeyword(sql, "BEGIN"))
+            return StatementKind::StartTransaction;
+        if (StartsWithKeyword(sql, "COMMIT"))
+            return StatementKind::Commit;
+        if (StartsWithKeyword(sql, "ROLLBACK"))
+            return StatementKind::Rollback;
+        return StatementKind::Write;
+    }
+
+    // calls visitor for every character outside quotes, with the parenthesis depth it is at
+    template<typename Visitor>
+    void VisitUnquoted(char const* sql, Visitor&& visitor)
+    {
+        char quote = 0;
+        uint32 depth = 0;
+        for (char const* itr = sql; *itr; ++itr)
+        {
+            if (quote)
+            {
+                if (*itr == '\\' && itr[1])
+                    ++itr;
+                else if (*itr == quote)
+                    quote = 0;
+                continue;
+            }
+
+            switch (*itr)
+            {
+                case '\'': case '"': case '`':
+                    quote = *itr;
+                    break;
+                case '(':
+                    ++depth;
+                    break;
+                case ')':
+                    if (depth)
+                        --depth;
+                    break;
+                default:
+                    if (!visitor(itr, depth))
+                        return;
+                    break;
+            }
+        }
+    }
+
+    unsigned long CountParameters(char const* sql)
+    {
+        unsigned long count = 0;
+        VisitUnquoted(sql, [&](char const* itr, uint32 /*depth*/)
+        {
+            count += *itr == '?';
+            return true;
+        });
+        return count;
+    }
+
+    // items of the outermost select list
+    unsigned int CountSelectColumns(char const* sql)
+    {
+        unsigned int columns = 1;
+        VisitUnquoted(sql, [&](char const* itr, uint32 depth)
+        {
+            if (depth)
+                return true;
+
+            if (*itr == ',')
+                ++columns;
+            else if (std::isspace(uint8(*itr)) && StartsWithKeyword(itr + 1, "FROM"))
+                return false;
+
+            return true;
+        });
+        return columns;
+    }
+
+    void SetError(Connection* connection, uint32 errorCode, char const* message)
+    {
+        connection->Errno = errorCode;
+        connection->Error = message;
+    }
+
+    void ClearError(Connection* connection)
+    {
+        connection->Errno = 0;
+        connection->Error.clear();
+    }
+
+    MYSQL_RES* CreateResult(MYSQL* mysql, unsigned int fieldCount, uint64 rowCount)
+    {
+        Result* result = new Result();
+        result->Handle.handle = mysql;
+        result->Fields.resize(fieldCount);
+        for (MYSQL_FIELD& field : result->Fields)
+        {
+            field.name = field.org_name = field.table = field.org_table = field.db = const_cast<char*>(StandInName);
+            field.type = MYSQL_TYPE_LONGLONG;
+            field.length = field.max_length = 20;
+        }
+        result->RowCount = rowCount;
+        result->NextRow = 0;
+        result->Values.resize(fieldCount);
+        result->Row.resize(fieldCount);
+        result->Lengths.resize(fieldCount);
+        return &result->Handle;
+    }
+
+    //! Starts, ends or fails the current transaction, returns false when the statement fails
+    bool Execute(Connection* connection, StatementKind kind)
+    {
+        ClearError(connection);
+        RoundTrip();
+
+        switch (kind)
+        {
+            case StatementKind::StartTransaction:
+            {
+                uint32 every = DeadlockEvery.load(std::memory_order_relaxed);
+                connection->FailNextStatement = every && (++Transactions % every) == 0;
+                return true;
+            }
+            case StatementKind::Commit:
+                connection->FailNextStatement = false;
+                ++Commits;
+                return true;
+            case StatementKind::Rollback:
+                connection->FailNextStatement = false;
+                ++Rollbacks;
+                return true;
+            default:
+                break;
+        }
+
+        if (connection->FailNextStatement)
+        {
+            connection->FailNextStatement = false;
+            ++Deadlocks;
+            SetError(connection, ER_LOCK_DEADLOCK, "Deadlock found when trying to get lock; try restarting transaction");
+            return false;
+        }
+
+        if (kind == StatementKind::Select)
+            ++Queries;
+        else
+            ++Statements;
+
+        return true;
+    }
+}
+
+void MySQLStandIn::SetLatency(std::chrono::microseconds latency)
+{
+    Latency = uint32(latency.count());
+}
+
+void MySQLStandIn::SetRowsPerSelect(uint32 rows)
+{
+    RowsPerSelect = rows;
+}
+
+void MySQLStandIn::SetDeadlockEvery(uint32 n)
+{
+    DeadlockEvery = n;
+}
+
+MySQLStandIn::Statistics MySQLStandIn::GetStatistics()
+{
+    Statistics statistics;
+    statistics.Queries = Queries;
+    statistics.Statements = Statements;
+    statistics.Commits = Commits;
+    statistics.Rollbacks = Rollbacks;
+    statistics.Deadlocks = Deadlocks;
+    return statistics;
+}
+
+void MySQLStandIn::Reset()
+{
+    Latency = 0;
+    RowsPerSelect = 1;
+    DeadlockEvery = 0;
+    Transactions = 0;
+    Queries = 0;
+    Statements = 0;
+    Commits = 0;
+    Rollbacks = 0;
+    Deadlocks = 0;
+}
+
+extern "C"
+{
+
+int mysql_library_init(int /*argc*/, char** /*argv*/, char** /*groups*/)
+{
+    return 0;
+}
+
+void mysql_library_end()
+{
+}
+
+unsigned int mysql_thread_safe()
+{
+    return 1;
+}
+
+char const* mysql_get_client_info()
+{
+    return StandInName;
+}
+
+unsigned long mysql_get_client_version()
+{
+#ifdef LIBMARIADB
+    return MARIADB_PACKAGE_VERSION_ID;
+#else
+    return MYSQL_VERSION_ID;
+#endif
+}
+
+MYSQL* mysql_init(MYSQL* mysql)
+{
+    // only allocating the handle is supported, MySQLConnection never passes one
+    if (mysql)
+        return nullptr;
+
+    Connection* connection = new Connection();
+    return &connection->Handle;
+}
+
+int mysql_options(MYSQL* /*mysql*/, enum mysql_option /*option*/, void const* /*arg*/)
+{
+    return 0;
+}
+
+MYSQL* mysql_real_connect(MYSQL* mysql, char const* /*host*/, char const* /*user*/, char const* /*passwd*/, char const* /*db*/,
+    unsigned int /*port*/, char const* /*unix_socket*/, unsigned long /*clientflag*/)
+{
+    return mysql;
+}
+
+void mysql_close(MYSQL* mysql)
+{
+    if (!mysql)
+        return;
+
+    Connection* connection = ToConnection(mysql);
+    if (connection->PendingResult)
+        mysql_free_result(connection->PendingResult);
+
+    delete connection;
+}
+
+char const* mysql_get_server_info(MYSQL* /*mysql*/)
+{
+    return StandInName;
+}
+
+unsigned long mysql_get_server_version(MYSQL* /*mysql*/)
+{
+#ifdef LIBMARIADB
+    return 100500;
+#else
+    return MYSQL_VERSION_ID;
+#endif
+}
+
+MySQLBool mysql_autocommit(MYSQL* /*mysql*/, MySQLBool /*mode*/)
+{
+    return 0;
+}
+
+int mysql_set_character_set(MYSQL* /*mysql*/, char const* /*csname*/)
+{
+    return 0;
+}
+
+int mysql_ping(MYSQL* mysql)
+{
+    ClearError(ToConnection(mysql));
+    RoundTrip();
+    return 0;
+}
+
+unsigned int mysql_errno(MYSQL* mysql)
+{
+    return mysql ? ToConnection(mysql)->Errno : 0;
+}
+
+char const* mysql_error(MYSQL* mysql)
+{
+    return mysql ? ToConnection(mysql)->Error.c_str() : "";
+}
+
+unsigned long mysql_real_escape_string(MYSQL* /*mysql*/, char* to, char const* from, unsigned long length)
+{
+    char* out = to;
+    for (unsigned long i = 0; i < length; ++i)
+    {
+        char escaped = 0;
+        switch (from[i])
+        {
+            case '\0': escaped = '0'; break;
+            case '\n': escaped = 'n'; break;
+            case '\r': escaped = 'r'; break;
+            case '\032': escaped = 'Z'; break;
+            case '\\': case '\'': case '"': escaped = from[i]; break;
+            default: break;
+        }
+
+        if (escaped)
+        {
+            *out++ = '\\';
+            *out++ = escaped;
+        }
+        else
+            *out++ = from[i];
+    }
+
+    *out = '\0';
+    return (unsigned long)(out - to);
+}
+
+int mysql_query(MYSQL* mysql, char const* sql)
+{
+    Connection* connection = ToConnection(mysql);
+    if (connection->PendingResult)
+    {
+        mysql_free_result(connection->PendingResult);
+        connection->PendingResult = nullptr;
+    }
+
+    StatementKind kind = Classify(sql);
+    connection->FieldCount = 0;
+    connection->AffectedRows = 0;
+    if (!Execute(connection, kind))
+        return 1;
+
+    if (kind == StatementKind::Select)
+    {
+        uint32 rows = RowsPerSelect.load(std::memory_order_relaxed);
+        connection->FieldCount = CountSelectColumns(sql);
+        connection->AffectedRows = rows;
+        connection->PendingResult = CreateResult(mysql, connection->FieldCount, rows);
+    }
+    else if (kind == StatementKind::Write)
+        connection->AffectedRows = 1;
+
+    return 0;
+}
+
+int mysql_real_query(MYSQL* mysql, char const* sql, unsigned long length)
+{
+    // multiple statements are executed and counted as one
+    return mysql_query(mysql, std::string(sql, length).c_str());
+}
+
+int mysql_set_server_option(MYSQL* /*mysql*/, enum enum_mysql_set_option /*option*/)
+{
+    return 0;
+}
+
+MYSQL_RES* mysql_store_result(MYSQL* mysql)
+{
+    Connection* connection = ToConnection(mysql);
+    MYSQL_RES* result = connection->PendingResult;
+    connection->PendingResult = nullptr;
+    return result;
+}
+
+MYSQL_RES* mysql_use_result(MYSQL* mysql)
+{
+    return mysql_store_result(mysql);
+}
+
+MySQLRowCount mysql_affected_rows(MYSQL* mysql)
+{
+    return ToConnection(mysql)->AffectedRows;
+}
+
+unsigned int mysql_field_count(MYSQL* mysql)
+{
+    return ToConnection(mysql)->FieldCount;
+}
+
+MySQLBool mysql_more_results(MYSQL* /*mysql*/)
+{
+    return 0;
+}
+
+int mysql_next_result(MYSQL* /*mysql*/)
+{
+    return -1;
+}
+
+MYSQL_FIELD* mysql_fetch_fields(MYSQL_RES* result)
+{
+    return ToResult(result)->Fields.data();
+}
+
+MYSQL_ROW mysql_fetch_row(MYSQL_RES* res)
+{
+    Result* result = ToResult(res);
+    if (result->NextRow >= result->RowCount)
+        return nullptr;
+
+    ++result->NextRow;
+    for (size_t i = 0; i < result->Values.size(); ++i)
+    {
+        result->Values[i] = std::to_string(result->NextRow);
+        result->Row[i] = &result->Values[i][0];
+        result->Lengths[i] = (unsigned long)result->Values[i].length();
+    }
+
+    return result->Row.data();
+}
+
+unsigned long* mysql_fetch_lengths(MYSQL_RES* result)
+{
+    return ToResult(result)->Lengths.data();
+}
+
+void mysql_free_result(MYSQL_RES* result)
+{
+    delete ToResult(result);
+}
+
+MYSQL_STMT* mysql_stmt_init(MYSQL* mysql)
+{
+    Statement* statement = new Statement();
+    statement->Handle.mysql = mysql;
+    return &statement->Handle;
+}
+
+int mysql_stmt_prepare(MYSQL_STMT* stmt, char const* query, unsigned long length)
+{
+    Statement* statement = ToStatement(stmt);
+    std::string sql(query, length);
+    statement->Kind = Classify(sql.c_str());
+    statement->ParamCount = CountParameters(sql.c_str());
+    statement->FieldCount = statement->Kind == StatementKind::Select ? CountSelectColumns(sql.c_str()) : 0;
+    return 0;
+}
+
+MySQLBool mysql_stmt_attr_set(MYSQL_STMT* /*stmt*/, enum enum_stmt_attr_type /*attr_type*/, void const* /*attr*/)
+{
+    return 0;
+}
+
+unsigned long mysql_stmt_param_count(MYSQL_STMT* stmt)
+{
+    return ToStatement(stmt)->ParamCount;
+}
+
+unsigned int mysql_stmt_field_count(MYSQL_STMT* stmt)
+{
+    return ToStatement(stmt)->FieldCount;
+}
+
+MySQLBool mysql_stmt_bind_param(MYSQL_STMT* /*stmt*/, MYSQL_BIND* /*bnd*/)
+{
+    return 0;
+}
+
+int mysql_stmt_execute(MYSQL_STMT* stmt)
+{
+    Statement* statement = ToStatement(stmt);
+    Connection* connection = ToConnection(stmt->mysql);
+    statement->RowCount = 0;
+    statement->NextRow = 0;
+    if (!Execute(connection, statement->Kind))
+    {
+        statement->Error = connection->Error;
+        return 1;
+    }
+
+    statement->Error.clear();
+    if (statement->Kind == StatementKind::Select)
+        statement->RowCount = RowsPerSelect.load(std::memory_order_relaxed);
+
+    return 0;
+}
+
+MYSQL_RES* mysql_stmt_result_metadata(MYSQL_STMT* stmt)
+{
+    Statement* statement = ToStatement(stmt);
+    if (!statement->FieldCount)
+        return nullptr;
+
+    return CreateResult(stmt->mysql, statement->FieldCount, 0);
+}
+
+int mysql_stmt_store_result(MYSQL_STMT* /*stmt*/)
+{
+    return 0;
+}
+
+MySQLRowCount mysql_stmt_num_rows(MYSQL_STMT* stmt)
+{
+    return ToStatement(stmt)->RowCount;
+}
+
+MySQLBool mysql_stmt_bind_result(MYSQL_STMT* stmt, MYSQL_BIND* bnd)
+{
+    // like libmysql the binds are copied into the statement, the length and is_null arrays stay owned by the caller
+    Statement* statement = ToStatement(stmt);
+    if (!stmt->bind)
+        stmt->bind = new MYSQL_BIND[statement->FieldCount];
+
+    memcpy(stmt->bind, bnd, sizeof(MYSQL_BIND) * statement->FieldCount);
+    stmt->bind_result_done = 1;
+    return 0;
+}
+
+int mysql_stmt_fetch(MYSQL_STMT* stmt)
+{
+    Statement* statement = ToStatement(stmt);
+    if (statement->NextRow >= statement->RowCount)
+        return MYSQL_NO_DATA;
+
+    int64 value = int64(++statement->NextRow);
+    for (unsigned int i = 0; i < statement->FieldCount; ++i)
+    {
+        MYSQL_BIND& bind = stmt->bind[i];
+        *bind.is_null = 0;
+        *bind.length = sizeof(value);
+        if (bind.buffer_length >= sizeof(value))
+            memcpy(bind.buffer, &value, sizeof(value));
+    }
+
+    return 0;
+}
+
+MySQLBool mysql_stmt_free_result(MYSQL_STMT* stmt)
+{
+    Statement* statement = ToStatement(stmt);
+    statement->RowCount = 0;
+    statement->NextRow = 0;
+    return 0;
+}
+
+char const* mysql_stmt_error(MYSQL_STMT* stmt)
+{
+    return ToStatement(stmt)->Error.c_str();
+}
+
+MySQLBool mysql_stmt_close(MYSQL_STMT* stmt)
+{
+    delete[] stmt->bind;
+    delete ToStatement(stmt);
+    return 0;
+}
+
+}
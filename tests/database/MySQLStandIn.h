@@ -0,0 +1,57 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MySQLStandIn_h__
+#define MySQLStandIn_h__
+
+#include "Define.h"
+#include <chrono>
+
+//! In-process replacement for the parts of the MySQL client library used by the database library.
+//! Linking MySQLStandIn.cpp into an executable makes every MySQLConnection talk to it instead of a server.
+//! It does not interpret SQL: SELECTs return RowsPerSelect rows of BIGINT columns, one per item of their select list,
+//! every other statement succeeds. Meant for measuring the async pipeline (DatabaseWorkerPool, query holders,
+//! transactions) without a MySQL server.
+namespace MySQLStandIn
+{
+    struct Statistics
+    {
+        uint64 Queries = 0;         // SELECTs, text and prepared
+        uint64 Statements = 0;      // everything else except transaction control
+        uint64 Commits = 0;
+        uint64 Rollbacks = 0;
+        uint64 Deadlocks = 0;
+    };
+
+    //! Settings apply to every connection and must only be changed while no operation is running
+
+    //! Round trip added to every query and statement
+    void SetLatency(std::chrono::microseconds latency);
+
+    void SetRowsPerSelect(uint32 rows);
+
+    //! The first statement of every n-th transaction fails with ER_LOCK_DEADLOCK, 0 disables.
+    //! Retries start a new transaction, 1 would deadlock forever.
+    void SetDeadlockEvery(uint32 n);
+
+    Statistics GetStatistics();
+
+    //! Restores default settings (no latency, 1 row per SELECT, no deadlocks) and clears statistics
+    void Reset();
+}
+
+#endif // MySQLStandIn_h__
@@ -0,0 +1,354 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "catch2/catch.hpp"
+#include "AsyncCallbackProcessor.h"
+#include "CharacterDatabase.h"
+#include "DatabaseWorkerPool.h"
+#include "Field.h"
+#include "LoginDatabase.h"
+#include "MySQLStandIn.h"
+#include "PreparedStatement.h"
+#include "QueryCallback.h"
+#include "QueryHolder.h"
+#include "QueryResult.h"
+#include "Transaction.h"
+#include <filesystem>
+#include <memory>
+#include <thread>
+
+namespace
+{
+    using CharacterPool = DatabaseWorkerPool<CharacterDatabaseConnection>;
+
+    // a fresh pool on the stand-in with default settings
+    template<class T = CharacterDatabaseConnection>
+    std::unique_ptr<DatabaseWorkerPool<T>> OpenPool(uint8 asyncThreads, uint32 groupCommitSize = 0)
+    {
+        MySQLStandIn::Reset();
+
+        std::unique_ptr<DatabaseWorkerPool<T>> pool = std::make_unique<DatabaseWorkerPool<T>>();
+        pool->SetConnectionInfo("127.0.0.1;3306;trinity;trinity;database", asyncThreads, 1);
+        pool->SetGroupCommit(groupCommitSize, 1);
+        REQUIRE(pool->Open() == 0);
+        REQUIRE(pool->PrepareStatements());
+        return pool;
+    }
+
+    // the statements WorldSession loads a character with, minus the optional ones
+    CharacterDatabaseStatements const LoginStatements[] =
+    {
+        CHAR_SEL_CHARACTER,
+        CHAR_SEL_GROUP_MEMBER,
+        CHAR_SEL_CHARACTER_INSTANCE,
+        CHAR_SEL_CHARACTER_AURAS,
+        CHAR_SEL_CHARACTER_SPELL,
+        CHAR_SEL_CHARACTER_QUESTSTATUS,
+        CHAR_SEL_CHARACTER_QUESTSTATUS_DAILY,
+        CHAR_SEL_CHARACTER_QUESTSTATUS_WEEKLY,
+        CHAR_SEL_CHARACTER_QUESTSTATUS_MONTHLY,
+        CHAR_SEL_CHARACTER_QUESTSTATUS_SEASONAL,
+        CHAR_SEL_CHARACTER_REPUTATION,
+        CHAR_SEL_CHARACTER_INVENTORY,
+        CHAR_SEL_CHAR_VOID_STORAGE,
+        CHAR_SEL_CHARACTER_ACTIONS,
+        CHAR_SEL_MAIL,
+        CHAR_SEL_MAILITEMS,
+        CHAR_SEL_CHARACTER_SOCIALLIST,
+        CHAR_SEL_CHARACTER_HOMEBIND,
+        CHAR_SEL_CHARACTER_SPELLCOOLDOWNS,
+        CHAR_SEL_GUILD_MEMBER,
+        CHAR_SEL_CHARACTER_ARENAINFO
+    };
+
+    class LoginQueryHolder : public CharacterDatabaseQueryHolder
+    {
+    public:
+        bool Initialize(CharacterPool& pool, uint32 guid)
+        {
+            SetSize(std::size(LoginStatements));
+
+            bool res = true;
+            for (size_t i = 0; i < std::size(LoginStatements); ++i)
+            {
+                CharacterDatabasePreparedStatement* stmt = pool.GetPreparedStatement(LoginStatements[i]);
+                stmt->setUInt32(0, guid);
+                res &= SetPreparedQuery(i, stmt);
+            }
+
+            return res;
+        }
+    };
+
+    // the kind of transaction Player::SaveToDB commits: a delete and an insert per changed sub-record
+    CharacterDatabaseTransaction BuildSave(CharacterPool& pool, uint32 guid, uint32 records)
+    {
+        CharacterDatabaseTransaction trans = pool.BeginTransaction();
+        for (uint32 i = 0; i < records; ++i)
+        {
+            CharacterDatabasePreparedStatement* stmt = pool.GetPreparedStatement(CHAR_DEL_CHAR_REPUTATION_BY_FACTION);
+            stmt->setUInt32(0, guid);
+            stmt->setUInt16(1, uint16(i));
+            trans->Append(stmt);
+
+            stmt = pool.GetPreparedStatement(CHAR_INS_CHAR_REPUTATION_BY_FACTION);
+            stmt->setUInt32(0, guid);
+            stmt->setUInt16(1, uint16(i));
+            stmt->setInt32(2, 0);
+            stmt->setUInt16(3, 0);
+            trans->Append(stmt);
+        }
+
+        return trans;
+    }
+
+    template<typename Callback>
+    void Drain(AsyncCallbackProcessor<Callback>& processor)
+    {
+        while (!processor.Empty())
+        {
+            processor.ProcessReadyCallbacks();
+            std::this_thread::yield();
+        }
+    }
+
+    // one-way statements have no callback, wait until the stand-in saw all of them
+    void WaitForStatements(uint64 statements)
+    {
+        while (MySQLStandIn::GetStatistics().Statements < statements)
+            std::this_thread::yield();
+    }
+}
+
+TEST_CASE("Login and character statements prepare on the stand-in", "[database]")
+{
+    std::unique_ptr<DatabaseWorkerPool<LoginDatabaseConnection>> login = OpenPool<LoginDatabaseConnection>(1);
+    login->Close();
+
+    std::unique_ptr<CharacterPool> characters = OpenPool(1);
+    characters->Close();
+}
+
+TEST_CASE("Async queries return the stand-in rows", "[database]")
+{
+    std::unique_ptr<CharacterPool> pool = OpenPool(2);
+    MySQLStandIn::SetRowsPerSelect(3);
+
+    QueryCallbackProcessor processor;
+    uint64 preparedRows = 0;
+    uint64 textRows = 0;
+
+    CharacterDatabasePreparedStatement* stmt = pool->GetPreparedStatement(CHAR_SEL_CHARACTER_SPELL);
+    stmt->setUInt32(0, 1);
+    processor.AddCallback(pool->AsyncQuery(stmt).WithPreparedCallback([&](PreparedQueryResult result)
+    {
+        REQUIRE(result);
+        REQUIRE(result->GetFieldCount() == 3);
+        do
+        {
+            ++preparedRows;
+            REQUIRE(result->Fetch()[0].GetUInt64() == preparedRows);
+        } while (result->NextRow());
+    }));
+
+    processor.AddCallback(pool->AsyncQuery("SELECT guid, name FROM characters").WithCallback([&](QueryResult result)
+    {
+        REQUIRE(result);
+        REQUIRE(result->GetFieldCount() == 2);
+        do
+            ++textRows;
+        while (result->NextRow());
+    }));
+
+    Drain(processor);
+    pool->Close();
+
+    REQUIRE(preparedRows == 3);
+    REQUIRE(textRows == 3);
+    REQUIRE(MySQLStandIn::GetStatistics().Queries == 2);
+}
+
+TEST_CASE("Login query holder completes on the stand-in", "[database]")
+{
+    std::unique_ptr<CharacterPool> pool = OpenPool(2);
+
+    std::shared_ptr<LoginQueryHolder> holder = std::make_shared<LoginQueryHolder>();
+    REQUIRE(holder->Initialize(*pool, 1));
+
+    AsyncCallbackProcessor<SQLQueryHolderCallback> processor;
+    size_t loaded = 0;
+    processor.AddCallback(pool->DelayQueryHolder(holder, 1)).AfterComplete([&](SQLQueryHolderBase const& result)
+    {
+        for (size_t i = 0; i < std::size(LoginStatements); ++i)
+            if (result.GetPreparedResult(i))
+                ++loaded;
+    });
+
+    Drain(processor);
+    pool->Close();
+
+    REQUIRE(loaded == std::size(LoginStatements));
+}
+
+TEST_CASE("Deadlocked transactions are retried", "[database]")
+{
+    std::unique_ptr<CharacterPool> pool = OpenPool(2);
+    MySQLStandIn::SetDeadlockEvery(3);
+
+    AsyncCallbackProcessor<TransactionCallback> processor;
+    uint32 committed = 0;
+    for (uint32 guid = 1; guid <= 9; ++guid)
+        processor.AddCallback(pool->AsyncCommitTransaction(BuildSave(*pool, guid, 2))).AfterComplete([&](bool success)
+        {
+            if (success)
+                ++committed;
+        });
+
+    Drain(processor);
+    pool->Close();
+
+    MySQLStandIn::Statistics statistics = MySQLStandIn::GetStatistics();
+    REQUIRE(committed == 9);
+    REQUIRE(statistics.Commits == 9);
+    REQUIRE(statistics.Deadlocks > 0);
+    REQUIRE(statistics.Rollbacks == statistics.Deadlocks);
+}
+
+TEST_CASE("Writes while the query snapshot is open discard it", "[database]")
+{
+    std::string path = (std::filesystem::temp_directory_path() / "tc-test-query-snapshot.bin").string();
+    std::filesystem::remove(path);
+
+    std::unique_ptr<CharacterPool> pool = OpenPool(1);
+    MySQLStandIn::SetRowsPerSelect(3);
+
+    pool->OpenSnapshot(path, "state");
+    REQUIRE(pool->Query("SELECT guid, name FROM characters"));
+    pool->CloseSnapshot();
+    REQUIRE(std::filesystem::exists(path));
+
+    // answered from the file, the write still has to drop it
+    pool->OpenSnapshot(path, "state");
+    REQUIRE(pool->Query("SELECT guid, name FROM characters"));
+    REQUIRE(MySQLStandIn::GetStatistics().Queries == 1);
+    pool->DirectExecute("UPDATE characters SET online = 0");
+
+    // and stop answering queries from it
+    REQUIRE(pool->Query("SELECT guid, name FROM characters"));
+    REQUIRE(MySQLStandIn::GetStatistics().Queries == 2);
+    pool->CloseSnapshot();
+    REQUIRE_FALSE(std::filesystem::exists(path));
+
+    pool->Close();
+}
+
+TEST_CASE("Streamed queries are recorded into the query snapshot", "[database]")
+{
+    std::string path = (std::filesystem::temp_directory_path() / "tc-test-query-snapshot.bin").string();
+    std::filesystem::remove(path);
+
+    std::unique_ptr<CharacterPool> pool = OpenPool(1);
+    pool->SetStreamQueries(true);
+    MySQLStandIn::SetRowsPerSelect(3);
+
+    pool->OpenSnapshot(path, "state");
+    QueryResult result = pool->StreamQuery("SELECT guid, name FROM characters");
+    REQUIRE(result);
+    REQUIRE_FALSE(result->IsStreamed());
+    REQUIRE(result->GetRowCount() == 3);
+    result.reset();
+    pool->CloseSnapshot();
+
+    pool->OpenSnapshot(path, "state");
+    result = pool->StreamQuery("SELECT guid, name FROM characters");
+    REQUIRE(result);
+    REQUIRE(result->GetRowCount() == 3);
+    REQUIRE(MySQLStandIn::GetStatistics().Queries == 1);
+    result.reset();
+    pool->CloseSnapshot();
+
+    std::filesystem::remove(path);
+    pool->Close();
+}
+
+TEST_CASE("Database worker pool benchmarks", "[.][benchmark][database]")
+{
+    SECTION("async queries")
+    {
+        for (uint32 latency : { 0, 100 })
+        {
+            std::unique_ptr<CharacterPool> pool = OpenPool(4);
+            MySQLStandIn::SetLatency(std::chrono::microseconds(latency));
+
+            BENCHMARK("1000 async queries, " + std::to_string(latency) + "us round trip")
+            {
+                QueryCallbackProcessor processor;
+                for (uint32 guid = 1; guid <= 1000; ++guid)
+                {
+                    CharacterDatabasePreparedStatement* stmt = pool->GetPreparedStatement(CHAR_SEL_CHARACTER_SPELL);
+                    stmt->setUInt32(0, guid);
+                    processor.AddCallback(pool->AsyncQuery(stmt).WithPreparedCallback([](PreparedQueryResult /*result*/) { }));
+                }
+
+                Drain(processor);
+            };
+
+            pool->Close();
+        }
+    }
+
+    SECTION("login")
+    {
+        std::unique_ptr<CharacterPool> pool = OpenPool(4);
+        MySQLStandIn::SetLatency(std::chrono::microseconds(100));
+
+        BENCHMARK("100 logins, 100us round trip")
+        {
+            AsyncCallbackProcessor<SQLQueryHolderCallback> processor;
+            for (uint32 guid = 1; guid <= 100; ++guid)
+            {
+                std::shared_ptr<LoginQueryHolder> holder = std::make_shared<LoginQueryHolder>();
+                holder->Initialize(*pool, guid);
+                processor.AddCallback(pool->DelayQueryHolder(holder, guid)).AfterComplete([](SQLQueryHolderBase const& /*holder*/) { });
+            }
+
+            Drain(processor);
+        };
+
+        pool->Close();
+    }
+
+    SECTION("saves")
+    {
+        for (uint32 groupCommitSize : { 0, 64 })
+        {
+            std::unique_ptr<CharacterPool> pool = OpenPool(4, groupCommitSize);
+            MySQLStandIn::SetLatency(std::chrono::microseconds(100));
+
+            BENCHMARK("500 saves, 100us round trip, group commit size " + std::to_string(groupCommitSize))
+            {
+                uint64 statements = MySQLStandIn::GetStatistics().Statements + 500 * 2 * 4;
+                for (uint32 guid = 1; guid <= 500; ++guid)
+                    pool->CommitTransaction(BuildSave(*pool, guid, 4), guid);
+
+                WaitForStatements(statements);
+            };
+
+            pool->Close();
+        }
+    }
+}
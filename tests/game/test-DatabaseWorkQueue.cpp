@@ -0,0 +1,91 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "catch2/catch.hpp"
+#include "DatabaseWorkQueue.h"
+#include "SQLOperation.h"
+#include <vector>
+
+namespace
+{
+    class NumberedOperation : public SQLOperation
+    {
+    public:
+        explicit NumberedOperation(int number) : Number(number) { }
+
+        bool Execute() override { return true; }
+
+        int const Number;
+    };
+
+    // pops everything worker can take right now
+    std::vector<int> PopAll(DatabaseWorkQueue& queue, uint32 worker)
+    {
+        std::vector<int> numbers;
+        SQLOperation* operation = nullptr;
+        while (queue.Pop(worker, operation))
+        {
+            numbers.push_back(static_cast<NumberedOperation*>(operation)->Number);
+            delete operation;
+        }
+
+        return numbers;
+    }
+}
+
+TEST_CASE("Database work queue without lanes keeps queue order", "[DatabaseWorkQueue]")
+{
+    DatabaseWorkQueue queue;
+    queue.Configure(false, 0);
+    uint32 worker = queue.RegisterWorker();
+
+    queue.Push(new NumberedOperation(1), DATABASE_LANE_BULK);
+    queue.Push(new NumberedOperation(2), DATABASE_LANE_INTERACTIVE, 7);
+    queue.Push(new NumberedOperation(3), DATABASE_LANE_BULK);
+
+    REQUIRE(queue.Size() == 3);
+    REQUIRE(PopAll(queue, worker) == std::vector<int>{ 1, 2, 3 });
+}
+
+TEST_CASE("Database work queue priority lanes and key routing", "[DatabaseWorkQueue]")
+{
+    DatabaseWorkQueue queue;
+    queue.Configure(true, 2);
+    uint32 first = queue.RegisterWorker();
+    uint32 second = queue.RegisterWorker();
+
+    queue.Push(new NumberedOperation(1), DATABASE_LANE_BULK);
+    queue.Push(new NumberedOperation(2), DATABASE_LANE_BULK, 4);            // save of character 4
+    queue.Push(new NumberedOperation(3), DATABASE_LANE_INTERACTIVE, 4);     // followed by its login
+    queue.Push(new NumberedOperation(4), DATABASE_LANE_INTERACTIVE);
+    queue.Push(new NumberedOperation(5), DATABASE_LANE_BULK, 3);
+
+    SECTION("interactive operations go first, keyed ones stay with their worker")
+    {
+        REQUIRE(PopAll(queue, second) == std::vector<int>{ 4, 5, 1 });
+        REQUIRE(PopAll(queue, first) == std::vector<int>{ 2, 3 });
+    }
+
+    SECTION("canceling deletes queued operations")
+    {
+        queue.Cancel();
+
+        SQLOperation* operation = nullptr;
+        REQUIRE(queue.Size() == 0);
+        REQUIRE(!queue.WaitAndPop(first, operation));
+    }
+}
@@ -0,0 +1,170 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "catch2/catch.hpp"
+#include "Field.h"
+#include "QueryResult.h"
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // Text protocol rows in the layout read by ResultSet from a QueryResultSnapshot
+    class TextRows
+    {
+    public:
+        explicit TextRows(std::vector<DatabaseFieldTypes> const& types) : _types(types), _rowCount(0) { }
+
+        void AddRow(std::vector<char const*> const& values)
+        {
+            REQUIRE(values.size() == _types.size());
+            for (char const* value : values)
+            {
+                uint32 length = value ? uint32(strlen(value)) : 0xFFFFFFFF;
+                _buffer.append(reinterpret_cast<char const*>(&length), sizeof(length));
+                if (value)
+                    _buffer.append(value, length + 1);
+            }
+            ++_rowCount;
+        }
+
+        std::unique_ptr<ResultSet> Open() const
+        {
+            std::vector<QueryResultFieldMetadata> metadata(_types.size());
+            for (uint32 i = 0; i < _types.size(); ++i)
+            {
+                metadata[i].Index = i;
+                metadata[i].Type = _types[i];
+            }
+
+            auto result = std::make_unique<ResultSet>(std::move(metadata), _buffer.data(), _buffer.data() + _buffer.size(), _rowCount);
+            REQUIRE(result->NextRow());
+            return result;
+        }
+
+    private:
+        std::vector<DatabaseFieldTypes> _types;
+        std::string _buffer;
+        uint64 _rowCount;
+    };
+}
+
+TEST_CASE("Text protocol integer fields", "[Field]")
+{
+    TextRows rows({ DatabaseFieldTypes::UInt32, DatabaseFieldTypes::Int32, DatabaseFieldTypes::UInt64, DatabaseFieldTypes::Int64, DatabaseFieldTypes::UInt8 });
+    rows.AddRow({ "4294967295", "-2147483648", "18446744073709551615", "-9223372036854775808", "255" });
+    rows.AddRow({ "0", "-1", "12345678901", "42", nullptr });
+    std::unique_ptr<ResultSet> result = rows.Open();
+
+    Field* fields = result->Fetch();
+    REQUIRE(fields[0].GetUInt32() == 4294967295u);
+    REQUIRE(fields[1].GetInt32() == -2147483647 - 1);
+    REQUIRE(fields[2].GetUInt64() == UI64LIT(18446744073709551615));
+    REQUIRE(fields[3].GetInt64() == std::numeric_limits<int64>::min());
+    REQUIRE(fields[4].GetUInt8() == 255);
+
+    REQUIRE(result->NextRow());
+    fields = result->Fetch();
+    REQUIRE(fields[0].GetUInt32() == 0);
+    REQUIRE(fields[1].GetInt32() == -1);
+    REQUIRE(fields[2].GetUInt64() == UI64LIT(12345678901));
+    REQUIRE(fields[3].GetInt64() == 42);
+    REQUIRE(fields[4].IsNull());
+    REQUIRE(fields[4].GetUInt8() == 0);
+
+    REQUIRE(!result->NextRow());
+}
+
+TEST_CASE("Text protocol fields read with another width or signedness", "[Field]")
+{
+    TextRows rows({ DatabaseFieldTypes::Int32, DatabaseFieldTypes::UInt32, DatabaseFieldTypes::UInt32, DatabaseFieldTypes::Int64 });
+    rows.AddRow({ "-1", "4294967295", "300", "9223372036854775807" });
+    std::unique_ptr<ResultSet> result = rows.Open();
+
+    Field* fields = result->Fetch();
+    REQUIRE(fields[0].GetUInt32() == static_cast<uint32>(strtoul("-1", nullptr, 10)));
+    REQUIRE(fields[0].GetUInt64() == static_cast<uint64>(strtoull("-1", nullptr, 10)));
+    REQUIRE(fields[1].GetInt32() == static_cast<int32>(strtol("4294967295", nullptr, 10)));
+    REQUIRE(fields[2].GetUInt8() == static_cast<uint8>(strtoul("300", nullptr, 10)));
+    REQUIRE(fields[3].GetUInt32() == static_cast<uint32>(strtoul("9223372036854775807", nullptr, 10)));
+}
+
+TEST_CASE("Text protocol values not fully converted fall back to strto*", "[Field]")
+{
+    TextRows rows({ DatabaseFieldTypes::UInt64, DatabaseFieldTypes::Int64, DatabaseFieldTypes::UInt32, DatabaseFieldTypes::Int32, DatabaseFieldTypes::UInt32 });
+    rows.AddRow({ "18446744073709551616", "-9223372036854775809", "12abc", " 7", "" });
+    std::unique_ptr<ResultSet> result = rows.Open();
+
+    Field* fields = result->Fetch();
+    REQUIRE(fields[0].GetUInt64() == static_cast<uint64>(strtoull("18446744073709551616", nullptr, 10)));
+    REQUIRE(fields[1].GetInt64() == static_cast<int64>(strtoll("-9223372036854775809", nullptr, 10)));
+    REQUIRE(fields[2].GetUInt32() == 12);
+    REQUIRE(fields[3].GetInt32() == 7);
+    REQUIRE(fields[4].GetUInt32() == 0);
+}
+
+TEST_CASE("Text protocol floating point fields", "[Field]")
+{
+    TextRows rows({ DatabaseFieldTypes::Float, DatabaseFieldTypes::Double, DatabaseFieldTypes::Decimal, DatabaseFieldTypes::Float });
+    rows.AddRow({ "1.5", "-12345.0625", "0.1", "3e2" });
+    std::unique_ptr<ResultSet> result = rows.Open();
+
+    Field* fields = result->Fetch();
+    REQUIRE(fields[0].GetFloat() == 1.5f);
+    REQUIRE(fields[1].GetDouble() == -12345.0625);
+    REQUIRE(fields[2].GetDouble() == atof("0.1"));
+    REQUIRE(fields[3].GetFloat() == 300.0f);
+}
+
+TEST_CASE("Reading creature rows", "[.][benchmark][Field]")
+{
+    // column types of the ObjectMgr::LoadCreatures query, strings left out
+    std::vector<DatabaseFieldTypes> types =
+    {
+        DatabaseFieldTypes::UInt64, DatabaseFieldTypes::UInt32, DatabaseFieldTypes::UInt16, DatabaseFieldTypes::UInt16, DatabaseFieldTypes::UInt8,
+        DatabaseFieldTypes::UInt32, DatabaseFieldTypes::Int8, DatabaseFieldTypes::Float, DatabaseFieldTypes::Float, DatabaseFieldTypes::Float,
+        DatabaseFieldTypes::Float, DatabaseFieldTypes::UInt32, DatabaseFieldTypes::Float, DatabaseFieldTypes::UInt32, DatabaseFieldTypes::UInt32,
+        DatabaseFieldTypes::UInt32, DatabaseFieldTypes::UInt8, DatabaseFieldTypes::UInt32, DatabaseFieldTypes::UInt32, DatabaseFieldTypes::UInt32,
+        DatabaseFieldTypes::UInt32, DatabaseFieldTypes::UInt8, DatabaseFieldTypes::UInt32, DatabaseFieldTypes::UInt32, DatabaseFieldTypes::UInt8
+    };
+
+    TextRows rows(types);
+    for (uint32 i = 0; i < 10000; ++i)
+        rows.AddRow({ "213456", "3100", "1", "1637", "1", "0", "-1", "-8913.23", "554.633", "93.7944", "3.82227", "300", "0", "1", "4120", "0",
+            "0", "0", "0", "0", "0", "0", "1", "0", "0" });
+
+    BENCHMARK("fetch and read every column once")
+    {
+        std::unique_ptr<ResultSet> result = rows.Open();
+        uint64 sum = 0;
+        do
+        {
+            Field* fields = result->Fetch();
+            sum += fields[0].GetUInt64() + fields[1].GetUInt32() + fields[2].GetUInt16() + fields[3].GetUInt16() + fields[4].GetUInt8();
+            sum += fields[5].GetUInt32() + fields[6].GetInt8() + uint64(fields[7].GetFloat() + fields[8].GetFloat() + fields[9].GetFloat() + fields[10].GetFloat());
+            sum += fields[11].GetUInt32() + uint64(fields[12].GetFloat()) + fields[13].GetUInt32() + fields[14].GetUInt32() + fields[15].GetUInt32();
+            sum += fields[16].GetUInt8() + fields[17].GetUInt32() + fields[18].GetUInt32() + fields[19].GetUInt32() + fields[20].GetUInt32();
+            sum += fields[21].GetUInt8() + fields[22].GetUInt32() + fields[23].GetUInt32() + fields[24].GetUInt8();
+        } while (result->NextRow());
+        return sum;
+    };
+}
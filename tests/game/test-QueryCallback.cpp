@@ -0,0 +1,193 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "catch2/catch.hpp"
+#include "AsyncCallbackProcessor.h"
+#include "QueryCallback.h"
+#include "QueryResult.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace
+{
+    std::atomic<std::size_t> Allocations{ 0 };
+}
+
+// count every heap allocation made by this test binary
+void* operator new(std::size_t size)
+{
+    ++Allocations;
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t /*size*/) noexcept
+{
+    std::free(p);
+}
+
+namespace
+{
+    // One session worth of queries issued while logging a character in, each continuation
+    // captures the session plus an index or guid, the way the handlers in CharacterHandler.cpp do
+    constexpr std::size_t LoginQueryCount = 50;
+
+    struct LoginQueries
+    {
+        LoginQueries()
+        {
+            Promises.resize(LoginQueryCount);
+            Names.reserve(LoginQueryCount);
+            for (std::size_t i = 0; i < LoginQueryCount; ++i)
+                Names.push_back("Character" + std::to_string(i));
+        }
+
+        void Issue(QueryCallbackProcessor& processor)
+        {
+            for (std::size_t i = 0; i < LoginQueryCount; ++i)
+            {
+                QueryCallback callback(Promises[i].get_future());
+                processor.AddCallback(std::move(callback).WithPreparedCallback([this, i](PreparedQueryResult result)
+                {
+                    Completed += !result && !Names[i].empty();
+                }));
+            }
+        }
+
+        void Complete()
+        {
+            for (PreparedQueryResultPromise& promise : Promises)
+                promise.set_value(nullptr);
+        }
+
+        void Reset()
+        {
+            for (PreparedQueryResultPromise& promise : Promises)
+                promise = PreparedQueryResultPromise();
+        }
+
+        std::vector<PreparedQueryResultPromise> Promises;
+        std::vector<std::string> Names;
+        std::size_t Completed = 0;
+    };
+}
+
+TEST_CASE("Single query continuations are stored inline", "[QueryCallback]")
+{
+    QueryCallbackProcessor processor;
+    LoginQueries login;
+
+    // first round grows the processor buffers
+    login.Issue(processor);
+    login.Complete();
+    processor.ProcessReadyCallbacks();
+    REQUIRE(login.Completed == LoginQueryCount);
+    REQUIRE(processor.Empty());
+
+    // promises and their shared states are created by the database workers, not counted here
+    login.Reset();
+
+    std::size_t before = Allocations;
+    login.Issue(processor);
+    login.Complete();
+    processor.ProcessReadyCallbacks();
+    std::size_t allocations = Allocations - before;
+
+    REQUIRE(login.Completed == 2 * LoginQueryCount);
+    REQUIRE(processor.Empty());
+    // the captures fit the inline buffer, so issuing and running the continuations never allocates
+    REQUIRE(allocations == 0);
+}
+
+TEST_CASE("Chained query continuations", "[QueryCallback]")
+{
+    PreparedQueryResultPromise first;
+    PreparedQueryResultPromise second;
+    std::vector<int> order;
+
+    QueryCallback callback = QueryCallback(first.get_future())
+        .WithChainingPreparedCallback([&](QueryCallback& queryCallback, PreparedQueryResult result)
+        {
+            REQUIRE(!result);
+            order.push_back(1);
+            queryCallback.SetNextQuery(QueryCallback(second.get_future()));
+        })
+        .WithPreparedCallback([&](PreparedQueryResult result)
+        {
+            REQUIRE(!result);
+            order.push_back(2);
+        });
+
+    REQUIRE(!callback.InvokeIfReady());
+
+    first.set_value(nullptr);
+    REQUIRE(!callback.InvokeIfReady());
+    REQUIRE(order == std::vector<int>{ 1 });
+
+    // moving a callback mid chain keeps the pending continuation
+    QueryCallback moved(std::move(callback));
+    REQUIRE(!moved.InvokeIfReady());
+
+    second.set_value(nullptr);
+    REQUIRE(moved.InvokeIfReady());
+    REQUIRE(order == (std::vector<int>{ 1, 2 }));
+}
+
+TEST_CASE("Continuations larger than the inline buffer", "[QueryCallback]")
+{
+    QueryResultPromise promise;
+    std::string captured[4] = { "a", "b", "c", "d" };
+    std::string joined;
+
+    QueryCallback callback = QueryCallback(promise.get_future())
+        .WithCallback([&joined, captured](QueryResult /*result*/)
+        {
+            for (std::string const& part : captured)
+                joined += part;
+        });
+
+    QueryCallback moved(std::move(callback));
+    promise.set_value(nullptr);
+    REQUIRE(moved.InvokeIfReady());
+    REQUIRE(joined == "abcd");
+}
+
+TEST_CASE("Login query callbacks", "[.][benchmark][QueryCallback]")
+{
+    QueryCallbackProcessor processor;
+    LoginQueries login;
+
+    BENCHMARK("issue and complete a character login worth of queries")
+    {
+        login.Reset();
+        login.Issue(processor);
+        login.Complete();
+        processor.ProcessReadyCallbacks();
+        return login.Completed;
+    };
+}
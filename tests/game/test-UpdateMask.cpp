@@ -0,0 +1,163 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "catch2/catch.hpp"
+#include "UpdateMask.h"
+#include <vector>
+
+namespace
+{
+    // Field selection of Object::BuildValuesUpdate before UpdateMask was stored as bit blocks
+    void BuildValuesUpdatePerField(uint8 const* changesMask, uint32 const* values, uint32 valuesCount, uint32 visibleFlag, uint32 notifyFlags, ByteBuffer& data)
+    {
+        std::vector<uint32> mask((valuesCount + 31) / 32);
+        uint32 lastSetBit = 0;
+        ByteBuffer fieldBuffer;
+        for (uint32 index = 0; index < valuesCount; ++index)
+        {
+            if (notifyFlags & UnitUpdateFieldFlags[index] ||
+                ((changesMask ? changesMask[index] : values[index]) && (UnitUpdateFieldFlags[index] & visibleFlag)))
+            {
+                mask[index / 32] |= 1u << (index % 32);
+                lastSetBit = index;
+                fieldBuffer << values[index];
+            }
+        }
+
+        uint8 blockCount = (lastSetBit + 32) / 32;
+        data << uint8(blockCount);
+        for (uint8 i = 0; i < blockCount; ++i)
+            data << mask[i];
+        data.append(fieldBuffer);
+    }
+
+    void BuildValuesUpdateByBlocks(UpdateMask const* changesMask, uint32 const* values, uint32 valuesCount, uint32 visibleFlag, uint32 notifyFlags, ByteBuffer& data)
+    {
+        UpdateMaskPacketBuilder updateMask(valuesCount);
+        ByteBuffer fieldBuffer;
+        updateMask.SelectFields(changesMask, values, UnitUpdateFieldFlagMask, visibleFlag, notifyFlags);
+        for (uint32 index = updateMask.GetNextSetBit(0); index < valuesCount; index = updateMask.GetNextSetBit(index + 1))
+            fieldBuffer << values[index];
+
+        updateMask.AppendToPacket(&data);
+        data.append(fieldBuffer);
+    }
+
+    // Player with every field set, as seen by itself and by other players
+    struct PopulatedPlayer
+    {
+        PopulatedPlayer(uint32 changedEvery) : Values(PLAYER_END), Changes(PLAYER_END)
+        {
+            Mask.SetCount(PLAYER_END);
+            for (uint32 index = 0; index < PLAYER_END; ++index)
+            {
+                Values[index] = index + 1;
+                if (index % changedEvery == 0)
+                {
+                    Changes[index] = 1;
+                    Mask.SetBit(index);
+                }
+            }
+        }
+
+        std::vector<uint32> Values;
+        std::vector<uint8> Changes;
+        UpdateMask Mask;
+    };
+
+    uint32 const SelfFlags = UF_FLAG_PUBLIC | UF_FLAG_PRIVATE;
+    uint32 const PartyFlags = UF_FLAG_PUBLIC | UF_FLAG_PARTY_MEMBER;
+}
+
+TEST_CASE("Changed fields are selected like the per field loop", "[UpdateMask]")
+{
+    uint32 changedEvery = GENERATE(1u, 3u, 64u, 1000u);
+    PopulatedPlayer player(changedEvery);
+
+    uint32 visibleFlag = GENERATE(SelfFlags, PartyFlags, uint32(UF_FLAG_PUBLIC));
+    uint32 valuesCount = visibleFlag == SelfFlags ? PLAYER_END : PLAYER_END_NOT_SELF;
+
+    ByteBuffer expected, actual;
+    BuildValuesUpdatePerField(player.Changes.data(), player.Values.data(), valuesCount, visibleFlag, UF_FLAG_DYNAMIC, expected);
+    BuildValuesUpdateByBlocks(&player.Mask, player.Values.data(), valuesCount, visibleFlag, UF_FLAG_DYNAMIC, actual);
+
+    REQUIRE(expected.size() == actual.size());
+    REQUIRE(std::equal(expected.contents(), expected.contents() + expected.size(), actual.contents()));
+}
+
+TEST_CASE("Non-zero fields are selected for creation", "[UpdateMask]")
+{
+    PopulatedPlayer player(1);
+    player.Values[OBJECT_FIELD_ENTRY] = 0;
+    player.Values[PLAYER_END - 1] = 0;
+
+    ByteBuffer expected, actual;
+    BuildValuesUpdatePerField(nullptr, player.Values.data(), PLAYER_END, SelfFlags, UF_FLAG_DYNAMIC, expected);
+    BuildValuesUpdateByBlocks(nullptr, player.Values.data(), PLAYER_END, SelfFlags, UF_FLAG_DYNAMIC, actual);
+
+    REQUIRE(expected.size() == actual.size());
+    REQUIRE(std::equal(expected.contents(), expected.contents() + expected.size(), actual.contents()));
+}
+
+TEST_CASE("Nothing changed still sends one mask block", "[UpdateMask]")
+{
+    UpdateMask mask;
+    mask.SetCount(PLAYER_END);
+    std::vector<uint32> values(PLAYER_END, 1);
+
+    ByteBuffer data;
+    BuildValuesUpdateByBlocks(&mask, values.data(), PLAYER_END, SelfFlags, UF_FLAG_NONE, data);
+
+    REQUIRE(data.size() == 1 + sizeof(uint32));
+    REQUIRE(data.read<uint8>() == 1);
+    REQUIRE(data.read<uint32>() == 0);
+}
+
+TEST_CASE("BuildValuesUpdate of a fully populated player", "[.][benchmark][UpdateMask]")
+{
+    PopulatedPlayer player(1);
+
+    BENCHMARK("per field, self")
+    {
+        ByteBuffer data;
+        BuildValuesUpdatePerField(player.Changes.data(), player.Values.data(), PLAYER_END, SelfFlags, UF_FLAG_DYNAMIC, data);
+        return data.size();
+    };
+
+    BENCHMARK("bit blocks, self")
+    {
+        ByteBuffer data;
+        BuildValuesUpdateByBlocks(&player.Mask, player.Values.data(), PLAYER_END, SelfFlags, UF_FLAG_DYNAMIC, data);
+        return data.size();
+    };
+
+    PopulatedPlayer sparse(97);
+
+    BENCHMARK("per field, few changes, other player")
+    {
+        ByteBuffer data;
+        BuildValuesUpdatePerField(sparse.Changes.data(), sparse.Values.data(), PLAYER_END_NOT_SELF, PartyFlags, UF_FLAG_DYNAMIC, data);
+        return data.size();
+    };
+
+    BENCHMARK("bit blocks, few changes, other player")
+    {
+        ByteBuffer data;
+        BuildValuesUpdateByBlocks(&sparse.Mask, sparse.Values.data(), PLAYER_END_NOT_SELF, PartyFlags, UF_FLAG_DYNAMIC, data);
+        return data.size();
+    };
+}
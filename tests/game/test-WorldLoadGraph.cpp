@@ -0,0 +1,111 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "catch2/catch.hpp"
+#include "WorldLoadGraph.h"
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // records the order the steps of a graph finished in
+    class LoadOrder
+    {
+    public:
+        std::function<void()> Step(WorldLoadGraph::StepId id, std::chrono::milliseconds duration = std::chrono::milliseconds(0))
+        {
+            return [this, id, duration]()
+            {
+                std::this_thread::sleep_for(duration);
+                std::lock_guard<std::mutex> lock(_lock);
+                _finished.push_back(id);
+            };
+        }
+
+        bool Finished(WorldLoadGraph::StepId id) const
+        {
+            return std::find(_finished.begin(), _finished.end(), id) != _finished.end();
+        }
+
+        bool FinishedBefore(WorldLoadGraph::StepId first, WorldLoadGraph::StepId second) const
+        {
+            auto firstItr = std::find(_finished.begin(), _finished.end(), first);
+            auto secondItr = std::find(_finished.begin(), _finished.end(), second);
+            return firstItr != _finished.end() && secondItr != _finished.end() && firstItr < secondItr;
+        }
+
+        std::size_t Count() const { return _finished.size(); }
+
+    private:
+        std::mutex _lock;
+        std::vector<WorldLoadGraph::StepId> _finished;
+    };
+}
+
+TEST_CASE("Steps run after their dependencies", "[WorldLoadGraph]")
+{
+    for (uint32 threadCount : { 0, 1, 4 })
+    {
+        LoadOrder order;
+        WorldLoadGraph graph;
+
+        // the slow independent steps would finish last if dependencies were ignored
+        WorldLoadGraph::StepId templates = graph.AddStep("templates", order.Step(0, std::chrono::milliseconds(20)));
+        WorldLoadGraph::StepId loot = graph.AddStep("loot", order.Step(1, std::chrono::milliseconds(20)));
+        WorldLoadGraph::StepId spawns = graph.AddStep("spawns", order.Step(2), { templates, loot });
+        WorldLoadGraph::StepId pools = graph.AddStep("pools", order.Step(3), { spawns });
+        WorldLoadGraph::StepId unrelated = graph.AddStep("unrelated", order.Step(4));
+        WorldLoadGraph::StepId scripts = graph.AddBarrierStep("scripts", order.Step(5));
+
+        graph.Run(threadCount);
+
+        REQUIRE(order.Count() == 6);
+        REQUIRE(order.FinishedBefore(templates, spawns));
+        REQUIRE(order.FinishedBefore(loot, spawns));
+        REQUIRE(order.FinishedBefore(spawns, pools));
+        for (WorldLoadGraph::StepId id : { templates, loot, spawns, pools, unrelated })
+            REQUIRE(order.FinishedBefore(id, scripts));
+    }
+}
+
+TEST_CASE("A failing step does not start its dependents", "[WorldLoadGraph]")
+{
+    for (uint32 threadCount : { 0, 1, 4 })
+    {
+        LoadOrder order;
+        WorldLoadGraph graph;
+
+        WorldLoadGraph::StepId independent = graph.AddStep("independent", order.Step(0, std::chrono::milliseconds(20)));
+        WorldLoadGraph::StepId failing = graph.AddStep("failing", []() { throw std::runtime_error("load failed"); });
+        WorldLoadGraph::StepId dependent = graph.AddStep("dependent", order.Step(2), { failing });
+        WorldLoadGraph::StepId indirect = graph.AddStep("indirect", order.Step(3), { dependent });
+
+        REQUIRE_THROWS_AS(graph.Run(threadCount), std::runtime_error);
+
+        REQUIRE_FALSE(order.Finished(dependent));
+        REQUIRE_FALSE(order.Finished(indirect));
+
+        // steps already running or not depending on the failed one complete before Run returns
+        if (threadCount)
+            REQUIRE(order.Finished(independent));
+    }
+}